@@ -3,17 +3,49 @@
 
 #include "QuestManagerComponent.h"
 #include "GameFramework/PlayerState.h" // If attaching to PlayerState, helps with logging owner name
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/GameModeBase.h"
+#include "QuestSystem/QuestProgressSubsystem.h"
+#include "QuestSystem/QuestDefinitionSubsystem.h"
+#include "QuestSystem/QuestJournalSubsystem.h"
+#include "QuestSystem/QuestEventRecorderSubsystem.h"
+#include "QuestSystem/QuestPlayerRegistrySubsystem.h"
+#include "QuestSystem/QuestLocationSubsystem.h"
+#include "QuestSystem/TimedObjective.h"
+#include "QuestSystem/QuestEventTags.h"
+#include "QuestSystem/QuestStats.h"
+#include "QuestSystem/QuestMemoryReport.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Engine/World.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Kismet/GameplayStatics.h"
+#include "Async/Async.h"
 
 
 // Sets default values for this component's properties
 UQuestManagerComponent::UQuestManagerComponent()
 {
-	// No need to tick, as this component is event-driven
-	PrimaryComponentTick.bCanEverTick = false;
+	// The component is event-driven; it only ticks while queued events or pending quest activations are waiting.
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 
 	// Set this component to be replicated by default. Crucial if attached to APlayerState
 	// and you want quest data to sync to clients.
 	SetIsReplicatedByDefault(true);
+
+	ActiveQuests.Owner = this;
+}
+
+void UQuestManagerComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    // Quest state is private to its player, and is only compared for changes when marked dirty.
+    FDoRepLifetimeParams Params;
+    Params.Condition = COND_OwnerOnly;
+    Params.bIsPushBased = true;
+    DOREPLIFETIME_WITH_PARAMS_FAST(UQuestManagerComponent, ActiveQuests, Params);
 }
 
 // Called when the game starts
@@ -21,6 +53,8 @@ void UQuestManagerComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
+    SetComponentTickInterval(EventFlushInterval);
+
     // If this component is attached to a PlayerState, log who owns it.
     APlayerState* OwningPlayerState = GetOwner<APlayerState>();
     if (IsValid(OwningPlayerState))
@@ -32,7 +66,26 @@ void UQuestManagerComponent::BeginPlay()
         UE_LOG(LogTemp, Warning, TEXT("QuestManagerComponent is not owned by a PlayerState. Consider attaching it to one for proper quest management."));
     }
 
-    // You might load saved quests here, or grant starting quests to the player.
+    EventRecorder = GetWorld()->GetSubsystem<UQuestEventRecorderSubsystem>();
+
+    // Make this player findable by controller/PlayerState/net ID before any quest gets restored.
+    if (UQuestPlayerRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UQuestPlayerRegistrySubsystem>())
+    {
+        Registry->RegisterQuestManager(this);
+    }
+
+    // On the server, get back any progress recovered from the journal and start journaling. A joining player's
+    // PlayerState is spawned before login gives it a unique net ID, so that case is finished at PostLogin.
+    if (GetOwner()->HasAuthority())
+    {
+        StartJournaling();
+        if (!JournalSubsystem && IsValid(OwningPlayerState))
+        {
+            PostLoginHandle = FGameModeEvents::GameModePostLoginEvent.AddUObject(this, &UQuestManagerComponent::OnPlayerPostLogin);
+        }
+    }
+
+    // You might load saved quests here (see LoadQuestStateAsync), or grant starting quests to the player.
     // Example: (Requires a way to get a reference to a quest Blueprint class)
     // if (GetOwner()->HasAuthority()) // Only run on server for multiplayer
     // {
@@ -44,53 +97,405 @@ void UQuestManagerComponent::BeginPlay()
 	
 }
 
+void UQuestManagerComponent::StartJournaling()
+{
+    const APlayerState* OwningPlayerState = GetOwner<APlayerState>();
+    if (PersistenceId.IsEmpty() && IsValid(OwningPlayerState) && OwningPlayerState->GetUniqueId().IsValid())
+    {
+        PersistenceId = OwningPlayerState->GetUniqueId().ToString();
+    }
+    if (PersistenceId.IsEmpty() || JournalSubsystem)
+    {
+        return;
+    }
+
+    if (UQuestJournalSubsystem* Journal = GetWorld()->GetSubsystem<UQuestJournalSubsystem>())
+    {
+        Journal->RegisterPlayer(this);
+    }
+}
+
+void UQuestManagerComponent::OnPlayerPostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer)
+{
+    if (!NewPlayer || NewPlayer->PlayerState != GetOwner())
+    {
+        return;
+    }
+
+    FGameModeEvents::GameModePostLoginEvent.Remove(PostLoginHandle);
+    PostLoginHandle.Reset();
+    StartJournaling();
+}
+
+void UQuestManagerComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    FGameModeEvents::GameModePostLoginEvent.Remove(PostLoginHandle);
+    PostLoginHandle.Reset();
+
+    // Don't silently drop progress that was still waiting in the queue.
+    FlushQueuedEvents();
+
+    // Hand the final state to the journal before it is torn down below.
+    if (JournalSubsystem)
+    {
+        JournalSubsystem->UnregisterPlayer(this);
+    }
+
+    if (UQuestPlayerRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UQuestPlayerRegistrySubsystem>())
+    {
+        Registry->UnregisterQuestManager(this);
+    }
+
+    // Objectives may hold per-player resources (markers, location triggers).
+    if (ProgressSubsystem)
+    {
+        for (const FQuestRuntimeState& State : ActiveQuests.Items)
+        {
+            UninitializeOpenObjectives(State);
+        }
+    }
+
+    // Give this player's rows in the progress table back to the world.
+    if (ProgressSubsystem && ProgressPlayerIndex != INDEX_NONE)
+    {
+        ProgressSubsystem->UnregisterPlayer(ProgressPlayerIndex);
+    }
+    ProgressSubsystem = nullptr;
+    ProgressPlayerIndex = INDEX_NONE;
+    ActiveQuests.Items.Reset();
+    MarkActiveQuestsDirty();
+    ActiveQuestIndices.Reset();
+    PendingActivations.Reset();
+    EventSubscribers.Reset();
+    SubscribedTagMask.Reset();
+    WildcardSubscribers.Reset();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void UQuestManagerComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    QuestStats::FScopedGameThreadCycles CycleScope;
+    ProcessPendingActivations(MaxQuestActivationTimeMs / 1000.0);
+    ProcessQueuedEvents(MaxEventProcessingTimeMs / 1000.0);
+}
+
 bool UQuestManagerComponent::AddQuest(UQuestNode* QuestToAdd)
 {
+    SCOPE_CYCLE_COUNTER(STAT_Quest_AddQuest);
+
     if (!IsValid(QuestToAdd))
     {
         UE_LOG(LogTemp, Warning, TEXT("QuestManagerComponent: Attempted to add an invalid quest."));
         return false;
     }
 
-    if (ActiveQuests.Contains(QuestToAdd))
+    // Recorded as a call, before any checks, so a replay goes through the same checks.
+    if (EventRecorder && EventRecorder->IsRecording())
+    {
+        EventRecorder->RecordQuestAdded(this, QuestToAdd);
+    }
+
+    if (IsQuestActive(QuestToAdd))
     {
         UE_LOG(LogTemp, Warning, TEXT("QuestManagerComponent: Quest '%s' is already active for this player."), *QuestToAdd->QuestName.ToString());
         return false;
     }
 
-    ActiveQuests.Add(QuestToAdd);
+    if (IsQuestPendingActivation(QuestToAdd))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("QuestManagerComponent: Quest '%s' is already waiting to be activated for this player."), *QuestToAdd->QuestName.ToString());
+        return false;
+    }
+
+    // Make sure the quest is part of the compiled quest graph, so availability is a counter lookup.
+    if (QuestToAdd->QuestId == INDEX_NONE)
+    {
+        if (UQuestDefinitionSubsystem* Definitions = UQuestDefinitionSubsystem::Get())
+        {
+            Definitions->RegisterQuest(QuestToAdd);
+        }
+    }
+    SyncPrerequisiteCounters();
 
-    // Initialize objectives of the newly added quest, passing the owner of this component (e.g., PlayerState).
-    QuestToAdd->InitializeQuestObjectives(GetOwner());
+    if (!QuestToAdd->IsQuestAvailable(this))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("QuestManagerComponent: Quest '%s' is not available for player '%s' (prerequisites not completed)."), *QuestToAdd->QuestName.ToString(), *GetNameSafe(GetOwner()));
+        return false;
+    }
 
-    // Bind to this quest's completion delegate so the manager knows when a quest finishes.
-    QuestToAdd->OnQuestCompletedDelegate.AddDynamic(this, &UQuestManagerComponent::OnQuestCompleted);
+    if (!ActivateQuest(QuestToAdd, TConstArrayView<int32>()))
+    {
+        return false;
+    }
+    JournalMutation(EQuestJournalOp::QuestAdded, QuestToAdd);
+    JournalObjectiveDeadlines(QuestToAdd);
 
     UE_LOG(LogTemp, Log, TEXT("QuestManagerComponent: Added quest '%s' for player '%s'."), *QuestToAdd->QuestName.ToString(), *GetNameSafe(GetOwner()));
+    CompleteIfWithoutObjectives(QuestToAdd);
+    return true;
+}
+
+void UQuestManagerComponent::CompleteIfWithoutObjectives(UQuestNode* Quest)
+{
+    // No event will ever report progress on a quest without objectives, so it is complete as soon as it's active.
+    if (Quest->Objectives.IsEmpty() && IsQuestActive(Quest))
+    {
+        OnQuestCompleted(Quest);
+    }
+}
+
+void UQuestManagerComponent::AddQuests(const TArray<UQuestNode*>& QuestsToAdd)
+{
+    TArray<UQuestNode*> ValidQuests;
+    ValidQuests.Reserve(QuestsToAdd.Num());
+    for (UQuestNode* Quest : QuestsToAdd)
+    {
+        if (IsValid(Quest))
+        {
+            ValidQuests.Add(Quest);
+        }
+    }
+
+    // Compile the whole batch now, so each activation is only per-player work. The quest graph also keeps the
+    // pending quests alive.
+    if (UQuestDefinitionSubsystem* Definitions = UQuestDefinitionSubsystem::Get())
+    {
+        Definitions->RegisterQuests(ValidQuests);
+    }
+
+    for (UQuestNode* Quest : ValidQuests)
+    {
+        if (!IsQuestPendingActivation(Quest))
+        {
+            PendingActivations.AddDefaulted_GetRef().Quest = Quest;
+        }
+    }
+    UpdateTickEnabled();
+}
+
+bool UQuestManagerComponent::IsQuestPendingActivation(const UQuestNode* Quest) const
+{
+    return PendingActivations.ContainsByPredicate([Quest](const FQuestPendingActivation& Pending) { return Pending.Quest == Quest; });
+}
+
+void UQuestManagerComponent::FlushPendingQuestActivations()
+{
+    ProcessPendingActivations(0.0);
+}
+
+void UQuestManagerComponent::ProcessPendingActivations(double TimeBudgetSeconds)
+{
+    if (PendingActivations.IsEmpty())
+    {
+        return;
+    }
+
+    // One quest at a time, taken off the front before it's activated: a quest is either pending or fully active,
+    // and quests removed or added while activating (e.g., by completion listeners) are handled like any other time.
+    const double StartTime = FPlatformTime::Seconds();
+    while (PendingActivations.Num() > 0)
+    {
+        FQuestPendingActivation Pending = MoveTemp(PendingActivations[0]);
+        PendingActivations.RemoveAt(0, EAllowShrinking::No);
+        if (!Pending.bRestored)
+        {
+            AddQuest(Pending.Quest);
+        }
+        else if (!IsQuestActive(Pending.Quest) && ActivateQuest(Pending.Quest, Pending.ObjectiveProgress, Pending.ObjectiveDeadlines))
+        {
+            JournalObjectiveDeadlines(Pending.Quest);
+            CompleteIfWithoutObjectives(Pending.Quest);
+        }
+
+        // Always make progress by at least one quest, then respect the budget.
+        if (TimeBudgetSeconds > 0.0 && FPlatformTime::Seconds() - StartTime >= TimeBudgetSeconds)
+        {
+            break;
+        }
+    }
+
+    if (PendingActivations.IsEmpty())
+    {
+        UE_LOG(LogTemp, Log, TEXT("QuestManagerComponent for '%s': Pending quest activations done, %d quests active."), *GetNameSafe(GetOwner()), ActiveQuests.Items.Num());
+        OnPendingQuestActivationsFinished.Broadcast();
+    }
+    UpdateTickEnabled();
+}
+
+void UQuestManagerComponent::UpdateTickEnabled()
+{
+    const bool bNeedsTick = !QueuedEvents.IsEmpty() || !PendingActivations.IsEmpty();
+    if (IsComponentTickEnabled() != bNeedsTick)
+    {
+        SetComponentTickEnabled(bNeedsTick);
+    }
+}
+
+bool UQuestManagerComponent::ActivateQuest(UQuestNode* Quest, TConstArrayView<int32> InitialProgress, TConstArrayView<int64> InitialDeadlines)
+{
+    LLM_SCOPE_BYTAG(Quests_Runtime);
+
+    UQuestProgressSubsystem* Progress = GetOrRegisterProgressPlayer();
+    if (!Progress)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("QuestManagerComponent: Cannot add quest '%s', no UQuestProgressSubsystem in this world."), *Quest->QuestName.ToString());
+        return false;
+    }
+
+    // Create this player's state for the quest. The quest definition itself is shared and never modified,
+    // and the objective progress counters live in the world's progress table.
+    FQuestRuntimeState NewState;
+    NewState.Quest = Quest;
+    NewState.Status = EQuestStatus::Active;
+    NewState.FirstProgressRow = Progress->AllocateQuestRows(ProgressPlayerIndex, Quest);
+    Progress->AcquireCounters(Quest->Objectives.Num(), NewState.ObjectiveProgress.Values);
+
+    // Restored quests start from their saved counters. Objectives that were already complete stay complete
+    // without firing their completion logic again.
+    for (int32 Index = 0; Index < InitialProgress.Num() && Index < Quest->Objectives.Num(); ++Index)
+    {
+        const UObjective* Objective = Quest->Objectives[Index];
+        if (!IsValid(Objective))
+        {
+            continue;
+        }
+
+        const int32 Row = NewState.FirstProgressRow + Index;
+        const int32 RestoredProgress = FMath::Clamp(InitialProgress[Index], 0, Objective->RequiredProgress);
+        NewState.ObjectiveProgress.Values[Index] = RestoredProgress;
+        Progress->SetRowProgress(Row, RestoredProgress);
+        Progress->SetRowCompleted(Row, Objective->IsObjectiveCurrentlyComplete(RestoredProgress));
+    }
+
+    // Time limits run against absolute deadlines, so a restored quest only gets the time it had left.
+    // They are set before the objectives are initialized, which is when UQuestTimerSubsystem schedules them.
+    const FDateTime Now = FDateTime::UtcNow();
+    for (int32 Index = 0; Index < Quest->Objectives.Num(); ++Index)
+    {
+        const UTimedObjective* TimedObjective = Cast<UTimedObjective>(Quest->Objectives[Index]);
+        if (!IsValid(TimedObjective) || TimedObjective->TimeLimit <= 0.0f)
+        {
+            continue;
+        }
+
+        if (NewState.ObjectiveDeadlines.IsEmpty())
+        {
+            NewState.ObjectiveDeadlines.SetNumZeroed(Quest->Objectives.Num());
+        }
+        const int64 RestoredDeadline = InitialDeadlines.IsValidIndex(Index) ? InitialDeadlines[Index] : 0;
+        NewState.ObjectiveDeadlines[Index] = RestoredDeadline > 0 ? RestoredDeadline : (Now + FTimespan::FromSeconds(TimedObjective->TimeLimit)).GetTicks();
+    }
+
+    const int32 NewIndex = ActiveQuests.Items.Add(MoveTemp(NewState));
+    ActiveQuestIndices.Add(Quest, NewIndex);
+    MarkQuestStateDirty(ActiveQuests.Items[NewIndex]);
+
+    // Initialize the uncompleted objectives of the newly added quest, passing the owner of this component (e.g., PlayerState).
+    // Index them by the event tags they handle so NotifyEvent can route directly to them.
+    if (const FQuestRuntimeState* State = FindActiveQuestState(Quest))
+    {
+        InitializeOpenObjectives(*State);
+        RegisterQuestObjectives(*State);
+    }
     return true;
 }
 
+void UQuestManagerComponent::JournalObjectiveDeadlines(const UQuestNode* Quest)
+{
+    const FQuestRuntimeState* State = JournalSubsystem ? FindActiveQuestState(Quest) : nullptr;
+    if (!State)
+    {
+        return;
+    }
+
+    for (int32 Index = 0; Index < State->ObjectiveDeadlines.Num(); ++Index)
+    {
+        if (State->ObjectiveDeadlines[Index] > 0)
+        {
+            JournalMutation(EQuestJournalOp::ObjectiveDeadline, Quest, Index, State->ObjectiveDeadlines[Index]);
+        }
+    }
+}
+
+void UQuestManagerComponent::InitializeOpenObjectives(const FQuestRuntimeState& State)
+{
+    SCOPE_CYCLE_COUNTER(STAT_Quest_InitializeObjectives);
+
+    UE_LOG(LogTemp, Verbose, TEXT("QuestManagerComponent for '%s': Initializing objectives of quest '%s'."), *GetNameSafe(GetOwner()), *State.Quest->QuestName.ToString());
+
+    for (int32 Index = 0; Index < State.Quest->Objectives.Num(); ++Index)
+    {
+        const UObjective* Objective = State.Quest->Objectives[Index];
+        if (IsValid(Objective) && !ProgressSubsystem->IsRowCompleted(State.FirstProgressRow + Index))
+        {
+            Objective->InitializeObjective(GetOwner());
+        }
+    }
+}
+
+void UQuestManagerComponent::UninitializeOpenObjectives(const FQuestRuntimeState& State)
+{
+    // Completed objectives were uninitialized when they completed.
+    for (int32 Index = 0; Index < State.Quest->Objectives.Num(); ++Index)
+    {
+        const UObjective* Objective = State.Quest->Objectives[Index];
+        if (IsValid(Objective) && !ProgressSubsystem->IsRowCompleted(State.FirstProgressRow + Index))
+        {
+            Objective->UninitializeObjective(GetOwner());
+        }
+    }
+}
+
 bool UQuestManagerComponent::RemoveQuest(UQuestNode* QuestToRemove)
 {
+    SCOPE_CYCLE_COUNTER(STAT_Quest_RemoveQuest);
+
     if (!IsValid(QuestToRemove))
     {
         UE_LOG(LogTemp, Warning, TEXT("QuestManagerComponent: Attempted to remove an invalid quest."));
         return false;
     }
 
-    if (!ActiveQuests.Contains(QuestToRemove))
+    if (!IsQuestActive(QuestToRemove))
     {
+        // A quest that hasn't been activated yet just leaves the queue. A restored one is in the journal already
+        // (through the player's recovered state or snapshot record), so its removal has to be journaled too.
+        const int32 PendingIndex = PendingActivations.IndexOfByPredicate([QuestToRemove](const FQuestPendingActivation& Pending) { return Pending.Quest == QuestToRemove; });
+        if (PendingIndex != INDEX_NONE)
+        {
+            const bool bRestored = PendingActivations[PendingIndex].bRestored;
+            PendingActivations.RemoveAt(PendingIndex);
+            if (bRestored)
+            {
+                JournalMutation(EQuestJournalOp::QuestRemoved, QuestToRemove);
+            }
+            UpdateTickEnabled();
+            return true;
+        }
         UE_LOG(LogTemp, Warning, TEXT("QuestManagerComponent: Quest '%s' is not active for this player, cannot remove."), *QuestToRemove->QuestName.ToString());
         return false;
     }
 
-    // Unbind from the quest's completion delegate.
-    QuestToRemove->OnQuestCompletedDelegate.RemoveDynamic(this, &UQuestManagerComponent::OnQuestCompleted);
+    // Stop routing events to this quest's objectives.
+    UnregisterQuestObjectives(QuestToRemove);
 
-    // Uninitialize the quest's objectives to ensure they stop listening to global events.
-    QuestToRemove->UninitializeQuestObjectives();
+    // Uninitialize the quest's objectives for this player.
+    UninitializeOpenObjectives(*FindActiveQuestState(QuestToRemove));
 
-    ActiveQuests.Remove(QuestToRemove);
+    // Swap-remove the state and fix up the index of the state that moved into its slot.
+    const int32 RemovedIndex = ActiveQuestIndices.FindAndRemoveChecked(QuestToRemove);
+    ProgressSubsystem->FreeQuestRows(ActiveQuests.Items[RemovedIndex].FirstProgressRow);
+    ProgressSubsystem->ReleaseCounters(ActiveQuests.Items[RemovedIndex].ObjectiveProgress.Values);
+    ActiveQuests.Items.RemoveAtSwap(RemovedIndex);
+    if (ActiveQuests.Items.IsValidIndex(RemovedIndex))
+    {
+        ActiveQuestIndices.Add(ActiveQuests.Items[RemovedIndex].Quest, RemovedIndex);
+    }
+    MarkActiveQuestsDirty();
+    JournalMutation(EQuestJournalOp::QuestRemoved, QuestToRemove);
 
     UE_LOG(LogTemp, Log, TEXT("QuestManagerComponent: Removed quest '%s' for player '%s'."), *QuestToRemove->QuestName.ToString(), *GetNameSafe(GetOwner()));
     return true;
@@ -99,42 +504,922 @@ bool UQuestManagerComponent::RemoveQuest(UQuestNode* QuestToRemove)
 bool UQuestManagerComponent::IsQuestActive(UQuestNode* QuestToCheck) const
 {
     if (!IsValid(QuestToCheck)) return false;
-    return ActiveQuests.Contains(QuestToCheck);
+    return ActiveQuestIndices.Contains(QuestToCheck);
 }
 
-// --- EVENT ROUTING IMPLEMENTATIONS ---
+bool UQuestManagerComponent::HasQuestBeenCompleted(const UQuestNode* QuestToCheck) const
+{
+    if (!IsValid(QuestToCheck)) return false;
+    return CompletedQuestBits.IsValidIndex(QuestToCheck->QuestId) && CompletedQuestBits[QuestToCheck->QuestId];
+}
+
+TArray<UQuestNode*> UQuestManagerComponent::GetCompletedQuests() const
+{
+    TArray<UQuestNode*> Result;
+    const UQuestDefinitionSubsystem* Definitions = UQuestDefinitionSubsystem::Get();
+    if (!Definitions)
+    {
+        return Result;
+    }
+
+    Result.Reserve(GetNumCompletedQuests());
+    for (TConstSetBitIterator<> It(CompletedQuestBits); It; ++It)
+    {
+        Result.Add(Definitions->GetQuestGraph().GetQuest(It.GetIndex()));
+    }
+    return Result;
+}
+
+int32 UQuestManagerComponent::GetNumCompletedQuests() const
+{
+    return CompletedQuestBits.CountSetBits();
+}
+
+FDateTime UQuestManagerComponent::GetQuestCompletionTime(const UQuestNode* Quest) const
+{
+    if (!HasQuestBeenCompleted(Quest))
+    {
+        return FDateTime();
+    }
+    return FDateTime::FromUnixTimestamp(CompletionHistory.FindCompletionTime(Quest->QuestId));
+}
+
+void UQuestManagerComponent::MarkQuestCompleted(const UQuestNode* Quest)
+{
+    LLM_SCOPE_BYTAG(Quests_Runtime);
+
+    // Quests are compiled by AddQuest, so an active quest always has an ID.
+    if (Quest->QuestId == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("QuestManagerComponent: Quest '%s' was completed but isn't part of the quest graph; the completion is not recorded."), *Quest->QuestName.ToString());
+        return;
+    }
+
+    const int64 Timestamp = FDateTime::UtcNow().ToUnixTimestamp();
+    SetQuestCompletedBit(Quest->QuestId);
+    CompletionHistory.Add(Quest->QuestId, Timestamp);
+    JournalMutation(EQuestJournalOp::QuestCompleted, Quest, 0, Timestamp);
+}
 
-void UQuestManagerComponent::NotifyEvent(FObjectiveEventData& E)
+void UQuestManagerComponent::SetQuestCompletedBit(int32 QuestId)
 {
-    UE_LOG(LogTemp, Log, TEXT("QuestManagerComponent for '%s': Received notification for an Event."), *GetNameSafe(GetOwner()));
+    if (CompletedQuestBits.Num() <= QuestId)
+    {
+        CompletedQuestBits.SetNum(QuestId + 1, false);
+    }
+    CompletedQuestBits[QuestId] = true;
+}
+
+int32 UQuestManagerComponent::GetNumRemainingPrerequisites(const UQuestNode* Quest) const
+{
+    if (!IsValid(Quest)) return 0;
+
+    if (RemainingPrerequisites.IsValidIndex(Quest->QuestId))
+    {
+        return RemainingPrerequisites[Quest->QuestId];
+    }
 
-    // Iterate through THIS player's active quests and route the notification to relevant objectives.
-    for (UQuestNode* Quest : ActiveQuests)
+    // Not compiled yet (or compiled since the counters were last synced): count the slow way.
+    int32 NumRemaining = 0;
+    for (const UQuestNode* Prerequisite : Quest->PrerequisiteQuests)
     {
-        // Only process valid and uncompleted quests
-        if (IsValid(Quest) && !Quest->bIsCompleted)
+        if (IsValid(Prerequisite) && !HasQuestBeenCompleted(Prerequisite))
         {
-            for (UObjective* Objective : Quest->Objectives)
-            {
-                if (IsValid(Objective) && !Objective->bIsCompleted) // Only process valid and uncompleted objectives
-                {
-                    Objective->ProcessGameEvent(E);
-                }
-            }
+            ++NumRemaining;
         }
     }
+    return NumRemaining;
 }
-// --- DELEGATE CALLBACK IMPLEMENTATIONS ---
 
-void UQuestManagerComponent::OnQuestCompleted(UQuestNode* CompletedQuest)
+bool UQuestManagerComponent::GetQuestState(const UQuestNode* Quest, FQuestRuntimeState& OutState) const
 {
-    UE_LOG(LogTemp, Log, TEXT("QuestManagerComponent for '%s': Quest '%s' reports all objectives completed!"), *GetNameSafe(GetOwner()), *CompletedQuest->QuestName.ToString());
+    if (const FQuestRuntimeState* State = FindActiveQuestState(Quest))
+    {
+        OutState = *State;
+        return true;
+    }
+    return false;
+}
 
-    // You can now trigger events relevant to the entire quest completion for this player.
-    // e.g., Update UI, grant rewards, trigger cinematics.
+int32 UQuestManagerComponent::GetObjectiveProgress(const UQuestNode* Quest, int32 ObjectiveIndex) const
+{
+    // Read the replicated copy so this works on the owning client as well as on the server.
+    const FQuestRuntimeState* State = FindActiveQuestState(Quest);
+    return State && State->ObjectiveProgress.Values.IsValidIndex(ObjectiveIndex) ? State->ObjectiveProgress.Values[ObjectiveIndex] : 0;
+}
+
+void UQuestManagerComponent::SetObjectiveProgress(UQuestNode* Quest, int32 ObjectiveIndex, int32 NewProgress)
+{
+    if (!IsQuestActive(Quest) || !Quest->Objectives.IsValidIndex(ObjectiveIndex))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("QuestManagerComponent: Cannot set progress of objective %d of quest '%s', it is not active for this player."), ObjectiveIndex, *GetNameSafe(Quest));
+        return;
+    }
+
+    ApplyObjectiveProgress(Quest, ObjectiveIndex, NewProgress);
+}
+
+void UQuestManagerComponent::CompleteObjective(UQuestNode* Quest, int32 ObjectiveIndex)
+{
+    if (IsValid(Quest) && Quest->Objectives.IsValidIndex(ObjectiveIndex) && IsValid(Quest->Objectives[ObjectiveIndex]))
+    {
+        SetObjectiveProgress(Quest, ObjectiveIndex, Quest->Objectives[ObjectiveIndex]->RequiredProgress);
+    }
+}
+
+bool UQuestManagerComponent::FailQuest(UQuestNode* Quest)
+{
+    if (!RemoveQuest(Quest))
+    {
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("QuestManagerComponent for '%s': Quest '%s' failed."), *GetNameSafe(GetOwner()), *Quest->QuestName.ToString());
+
+    OnPlayerQuestFailedNative.Broadcast(Quest);
+    if (OnPlayerQuestFailedDelegate.IsBound())
+    {
+        OnPlayerQuestFailedDelegate.Broadcast(Quest);
+    }
+    return true;
+}
+
+FQuestRuntimeState* UQuestManagerComponent::FindActiveQuestState(const UQuestNode* Quest)
+{
+    const int32* QuestIndex = ActiveQuestIndices.Find(Quest);
+    return QuestIndex ? &ActiveQuests.Items[*QuestIndex] : nullptr;
+}
 
-    OnPlayerQuestCompletedDelegate.Broadcast(CompletedQuest); // Broadcast to UI/other systems
+const FQuestRuntimeState* UQuestManagerComponent::FindActiveQuestState(const UQuestNode* Quest) const
+{
+    const int32* QuestIndex = ActiveQuestIndices.Find(Quest);
+    return QuestIndex ? &ActiveQuests.Items[*QuestIndex] : nullptr;
+}
 
-    // Remove the quest from the active list (or move to a 'CompletedQuests' array).
-    RemoveQuest(CompletedQuest); // This also unbinds and uninitializes the quest.
-}
\ No newline at end of file
+void UQuestManagerComponent::MarkQuestStateDirty(FQuestRuntimeState& State)
+{
+    ActiveQuests.MarkItemDirty(State);
+    MARK_PROPERTY_DIRTY_FROM_NAME(UQuestManagerComponent, ActiveQuests, this);
+}
+
+void UQuestManagerComponent::MarkActiveQuestsDirty()
+{
+    ActiveQuests.MarkArrayDirty();
+    MARK_PROPERTY_DIRTY_FROM_NAME(UQuestManagerComponent, ActiveQuests, this);
+}
+
+void UQuestManagerComponent::OnQuestLogReplicated()
+{
+    // Item order on clients doesn't match the server's, so rebuild the lookup from scratch.
+    ActiveQuestIndices.Reset();
+    for (int32 Index = 0; Index < ActiveQuests.Items.Num(); ++Index)
+    {
+        ActiveQuestIndices.Add(ActiveQuests.Items[Index].Quest, Index);
+    }
+
+    OnQuestLogUpdatedDelegate.Broadcast();
+}
+
+void UQuestManagerComponent::ApplyObjectiveProgress(UQuestNode* Quest, int32 ObjectiveIndex, int32 NewProgress)
+{
+    FQuestRuntimeState* State = FindActiveQuestState(Quest);
+    const UObjective* Objective = State ? Quest->Objectives[ObjectiveIndex] : nullptr;
+    if (!IsValid(Objective))
+    {
+        return;
+    }
+
+    const int32 Row = State->FirstProgressRow + ObjectiveIndex;
+    if (ProgressSubsystem->IsRowCompleted(Row))
+    {
+        return;
+    }
+
+    const int32 ClampedProgress = FMath::Clamp(NewProgress, 0, Objective->RequiredProgress);
+    ProgressSubsystem->SetRowProgress(Row, ClampedProgress);
+
+    // Keep the replicated copy in sync; only this quest's entry goes on the wire.
+    if (State->ObjectiveProgress.Values[ObjectiveIndex] != ClampedProgress)
+    {
+        State->ObjectiveProgress.Values[ObjectiveIndex] = ClampedProgress;
+        MarkQuestStateDirty(*State);
+        JournalMutation(EQuestJournalOp::ObjectiveProgress, Quest, ObjectiveIndex, ClampedProgress);
+    }
+    if (!Objective->IsObjectiveCurrentlyComplete(ClampedProgress))
+    {
+        return;
+    }
+    ProgressSubsystem->SetRowCompleted(Row, true);
+
+    UE_LOG(LogTemp, Log, TEXT("QuestManagerComponent for '%s': Objective Completed: %s"), *GetNameSafe(GetOwner()), *Objective->ObjectiveDescription.ToString());
+
+    // Completed objectives no longer need events.
+    UnregisterObjective({ Quest, ObjectiveIndex });
+    Objective->UninitializeObjective(GetOwner());
+
+    OnPlayerObjectiveCompletedNative.Broadcast(Quest, ObjectiveIndex);
+    if (OnPlayerObjectiveCompletedDelegate.IsBound())
+    {
+        OnPlayerObjectiveCompletedDelegate.Broadcast(Quest, ObjectiveIndex);
+    }
+
+    if (Quest->IsQuestCompleted(this))
+    {
+        OnQuestCompleted(Quest);
+    }
+}
+
+UQuestProgressSubsystem* UQuestManagerComponent::GetOrRegisterProgressPlayer()
+{
+    if (!ProgressSubsystem)
+    {
+        UWorld* World = GetWorld();
+        ProgressSubsystem = World ? World->GetSubsystem<UQuestProgressSubsystem>() : nullptr;
+        if (ProgressSubsystem)
+        {
+            ProgressPlayerIndex = ProgressSubsystem->RegisterPlayer(this);
+        }
+    }
+    return ProgressSubsystem;
+}
+
+void UQuestManagerComponent::OnQuestRowsMoved(const UQuestNode* Quest, int32 NewFirstRow)
+{
+    // Only the server-side row index changes; nothing to replicate.
+    if (FQuestRuntimeState* State = FindActiveQuestState(Quest))
+    {
+        State->FirstProgressRow = NewFirstRow;
+    }
+}
+
+// --- EVENT ROUTING IMPLEMENTATIONS ---
+
+void UQuestManagerComponent::NotifyLocationReached(FVector Location)
+{
+    if (UQuestLocationSubsystem* Locations = GetWorld()->GetSubsystem<UQuestLocationSubsystem>())
+    {
+        Locations->TestPlayerLocation(GetOwner(), Location);
+    }
+}
+
+bool UQuestManagerComponent::HasSubscribersForEvent(FName EventTag) const
+{
+    if (WildcardSubscribers.Num() > 0)
+    {
+        return true;
+    }
+    FQuestEventTags& Tags = FQuestEventTags::Get();
+    return FQuestEventTags::MasksIntersect(SubscribedTagMask, Tags.GetAncestorMask(Tags.RegisterTag(EventTag)));
+}
+
+void UQuestManagerComponent::GetMemoryUsage(FQuestPlayerMemory& OutMemory) const
+{
+    OutMemory = FQuestPlayerMemory();
+
+    OutMemory.ActiveQuestBytes = ActiveQuests.Items.GetAllocatedSize() + ActiveQuestIndices.GetAllocatedSize();
+    for (const FQuestRuntimeState& State : ActiveQuests.Items)
+    {
+        OutMemory.ActiveQuestBytes += State.ObjectiveProgress.Values.GetAllocatedSize();
+        if (State.Quest)
+        {
+            OutMemory.ProgressRowBytes += State.Quest->Objectives.Num() * UQuestProgressSubsystem::GetBytesPerRow();
+        }
+    }
+
+    OutMemory.CompletionBytes = CompletedQuestBits.GetAllocatedSize() + CompletionHistory.GetAllocatedSize() + RemainingPrerequisites.GetAllocatedSize();
+
+    OutMemory.EventIndexBytes = EventSubscribers.GetAllocatedSize() + SubscribedTagMask.GetAllocatedSize() + WildcardSubscribers.GetAllocatedSize();
+    for (const TPair<int32, TArray<FObjectiveSubscriber>>& Entry : EventSubscribers)
+    {
+        OutMemory.EventIndexBytes += Entry.Value.GetAllocatedSize();
+    }
+
+    OutMemory.EventQueueBytes = QueuedEvents.GetAllocatedSize() + QueuedEventIndices.GetAllocatedSize();
+
+    OutMemory.DelegateBytes = OnPlayerQuestCompletedDelegate.GetAllocatedSize() + OnPlayerObjectiveCompletedDelegate.GetAllocatedSize()
+        + OnPlayerQuestFailedDelegate.GetAllocatedSize() + OnPlayerQuestCompletedNative.GetAllocatedSize()
+        + OnPlayerObjectiveCompletedNative.GetAllocatedSize() + OnPlayerQuestFailedNative.GetAllocatedSize()
+        + OnQuestLogUpdatedDelegate.GetAllocatedSize();
+}
+
+void UQuestManagerComponent::NotifyEvent(const FObjectiveEventData& E)
+{
+    SCOPE_CYCLE_COUNTER(STAT_Quest_NotifyEvent);
+
+    if (EventRecorder && EventRecorder->IsRecording())
+    {
+        EventRecorder->RecordEvent(this, E, bQueueEvents);
+    }
+
+    if (bQueueEvents)
+    {
+        EnqueueEvent(E);
+        return;
+    }
+
+    DispatchEvent(E);
+}
+
+void UQuestManagerComponent::QueueEvent(const FObjectiveEventData& E)
+{
+    if (EventRecorder && EventRecorder->IsRecording())
+    {
+        EventRecorder->RecordEvent(this, E, true);
+    }
+
+    EnqueueEvent(E);
+}
+
+void UQuestManagerComponent::FlushQueuedEvents()
+{
+    ProcessQueuedEvents(0.0);
+}
+
+void UQuestManagerComponent::DispatchEvent(const FObjectiveEventData& E)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(QuestManager_DispatchEvent, QuestChannel);
+    INC_DWORD_STAT(STAT_Quest_EventsDispatched);
+    CSV_CUSTOM_STAT(Quests, EventsDispatched, 1, ECsvCustomStatOp::Accumulate);
+    const uint64 StartCycle = FPlatformTime::Cycles64();
+
+    UE_LOG(LogTemp, Verbose, TEXT("QuestManagerComponent for '%s': Dispatching event '%s' (x%d)."), *GetNameSafe(GetOwner()), *E.EventTag.ToString(), E.Count);
+
+    // Gather the objectives subscribed to this tag or one of its ancestors (plus wildcard subscribers) up front.
+    // Processing an event can complete objectives and quests, which modifies the index while we dispatch.
+    TArray<FObjectiveSubscriber, TInlineAllocator<16>> Targets;
+    FQuestEventTags& Tags = FQuestEventTags::Get();
+    const int32 TagIndex = Tags.RegisterTag(E.EventTag);
+    if (FQuestEventTags::MasksIntersect(SubscribedTagMask, Tags.GetAncestorMask(TagIndex)))
+    {
+        for (const int32 AncestorIndex : Tags.GetSelfAndAncestors(TagIndex))
+        {
+            if (const TArray<FObjectiveSubscriber>* Subscribers = EventSubscribers.Find(AncestorIndex))
+            {
+                Targets.Append(*Subscribers);
+            }
+        }
+    }
+    Targets.Append(WildcardSubscribers);
+
+    for (const FObjectiveSubscriber& Target : Targets)
+    {
+        // The quest may have been completed or removed while handling an earlier target.
+        const FQuestRuntimeState* State = FindActiveQuestState(Target.Quest);
+        const UObjective* Objective = State ? Target.Quest->Objectives[Target.ObjectiveIndex] : nullptr;
+        if (!IsValid(Objective))
+        {
+            continue;
+        }
+
+        const int32 Row = State->FirstProgressRow + Target.ObjectiveIndex;
+        if (ProgressSubsystem->IsRowCompleted(Row)) // Only process uncompleted objectives
+        {
+            continue;
+        }
+
+        // ProcessGameEvent may run Blueprint code that adds or removes quests, so State is not used after it.
+        const int32 CurrentProgress = ProgressSubsystem->GetRowProgress(Row);
+        int32 NewProgress = CurrentProgress;
+        {
+            SCOPE_CYCLE_COUNTER(STAT_Quest_ProcessGameEvent);
+            NewProgress = Objective->ProcessGameEvent(E, CurrentProgress);
+        }
+        if (NewProgress != CurrentProgress)
+        {
+            ApplyObjectiveProgress(Target.Quest, Target.ObjectiveIndex, NewProgress);
+        }
+    }
+
+    QuestStats::TraceEventDispatch(E.EventTag, E.Count, Targets.Num(), StartCycle, FPlatformTime::Cycles64());
+}
+
+// --- EVENT QUEUE ---
+
+void UQuestManagerComponent::EnqueueEvent(const FObjectiveEventData& E)
+{
+    LLM_SCOPE_BYTAG(Quests_EventQueues);
+
+    // Events only told apart by their actor are merged when no objective looks at it. The merged event carries the
+    // latest actor. An objective that reads it and subscribes before the flush sees that actor for the whole Count.
+    const bool bKeyByActor = IsTriggeringActorRead(E.EventTag);
+
+    FQueuedEvent Queued;
+    Queued.Event = E;
+    Queued.Event.ResponsiblePlayerController = nullptr;
+    Queued.Event.TriggeringActor = nullptr;
+    Queued.PlayerController = E.ResponsiblePlayerController;
+    Queued.TriggeringActor = E.TriggeringActor;
+    Queued.Key.EventTag = E.EventTag;
+    Queued.Key.PlayerController = FObjectKey(E.ResponsiblePlayerController);
+    Queued.Key.TriggeringActor = bKeyByActor ? FObjectKey(E.TriggeringActor) : FObjectKey();
+    Queued.Key.Payload = E.Payload;
+    EnqueueEvent(MoveTemp(Queued));
+}
+
+void UQuestManagerComponent::EnqueueEvent(FQueuedEvent&& Queued)
+{
+    if (const int32* ExistingIndex = QueuedEventIndices.Find(Queued.Key))
+    {
+        FQueuedEvent& Existing = QueuedEvents[*ExistingIndex];
+        Existing.Event.Count += Queued.Event.Count;
+        Existing.TriggeringActor = Queued.TriggeringActor;
+        return;
+    }
+
+    const int32 Index = QueuedEvents.Add(MoveTemp(Queued));
+    QueuedEventIndices.Add(QueuedEvents[Index].Key, Index);
+
+    // Wake up the tick to flush the queue.
+    UpdateTickEnabled();
+}
+
+bool UQuestManagerComponent::FQueuedEvent::Resolve(FObjectiveEventData& OutEvent) const
+{
+    OutEvent = Event;
+    OutEvent.ResponsiblePlayerController = PlayerController.Get();
+    OutEvent.TriggeringActor = TriggeringActor.Get();
+
+    // An actor the event isn't keyed by is only carried along; no objective reads it, so it may be gone.
+    const bool bControllerGone = Key.PlayerController != FObjectKey() && !OutEvent.ResponsiblePlayerController;
+    const bool bActorGone = Key.TriggeringActor != FObjectKey() && !OutEvent.TriggeringActor;
+    return !bControllerGone && !bActorGone;
+}
+
+bool UQuestManagerComponent::IsTriggeringActorRead(FName EventTag) const
+{
+    auto AnyReads = [this](const TArray<FObjectiveSubscriber>& Subscribers)
+    {
+        return Subscribers.ContainsByPredicate([this](const FObjectiveSubscriber& Subscriber)
+        {
+            const UObjective* Objective = Subscriber.Quest->Objectives.IsValidIndex(Subscriber.ObjectiveIndex) ? Subscriber.Quest->Objectives[Subscriber.ObjectiveIndex] : nullptr;
+            return IsValid(Objective) && Objective->ReadsTriggeringActor();
+        });
+    };
+
+    // Same subscribers as DispatchEvent gathers.
+    if (AnyReads(WildcardSubscribers))
+    {
+        return true;
+    }
+    FQuestEventTags& Tags = FQuestEventTags::Get();
+    const int32 TagIndex = Tags.RegisterTag(EventTag);
+    if (!FQuestEventTags::MasksIntersect(SubscribedTagMask, Tags.GetAncestorMask(TagIndex)))
+    {
+        return false;
+    }
+    for (const int32 AncestorIndex : Tags.GetSelfAndAncestors(TagIndex))
+    {
+        const TArray<FObjectiveSubscriber>* Subscribers = EventSubscribers.Find(AncestorIndex);
+        if (Subscribers && AnyReads(*Subscribers))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void UQuestManagerComponent::ProcessQueuedEvents(double TimeBudgetSeconds)
+{
+    if (QueuedEvents.IsEmpty())
+    {
+        UpdateTickEnabled();
+        return;
+    }
+
+    // Take ownership of the current batch. Objectives may queue new events while we dispatch,
+    // and those must not be merged into events we have already processed.
+    TArray<FQueuedEvent> Batch = MoveTemp(QueuedEvents);
+    QueuedEvents.Reset();
+    QueuedEventIndices.Reset();
+
+    const double StartTime = FPlatformTime::Seconds();
+    int32 NumProcessed = 0;
+    FObjectiveEventData E;
+    while (NumProcessed < Batch.Num())
+    {
+        if (Batch[NumProcessed++].Resolve(E))
+        {
+            DispatchEvent(E);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Verbose, TEXT("QuestManagerComponent for '%s': Dropping queued event '%s', its actor was destroyed."), *GetNameSafe(GetOwner()), *E.EventTag.ToString());
+        }
+
+        // Always make progress by at least one event, then respect the budget.
+        if (TimeBudgetSeconds > 0.0 && FPlatformTime::Seconds() - StartTime >= TimeBudgetSeconds)
+        {
+            break;
+        }
+    }
+
+    if (NumProcessed < Batch.Num())
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("QuestManagerComponent for '%s': Event budget exhausted, carrying %d events over to the next flush."), *GetNameSafe(GetOwner()), Batch.Num() - NumProcessed);
+
+        // Put the leftovers back ahead of anything queued during dispatch so ordering is preserved.
+        TArray<FQueuedEvent> QueuedDuringDispatch = MoveTemp(QueuedEvents);
+        QueuedEvents.Reset();
+        QueuedEventIndices.Reset();
+        for (int32 Index = NumProcessed; Index < Batch.Num(); ++Index)
+        {
+            EnqueueEvent(MoveTemp(Batch[Index]));
+        }
+        for (FQueuedEvent& Queued : QueuedDuringDispatch)
+        {
+            EnqueueEvent(MoveTemp(Queued));
+        }
+    }
+
+    UpdateTickEnabled();
+}
+
+// --- SAVE / LOAD ---
+
+void UQuestManagerComponent::CaptureSaveSnapshot(FQuestSaveSnapshot& OutSnapshot) const
+{
+    const UQuestDefinitionSubsystem* Definitions = UQuestDefinitionSubsystem::Get();
+    if (!Definitions)
+    {
+        return;
+    }
+    const FQuestGraph& Graph = Definitions->GetQuestGraph();
+
+    // Only copies happen here; encoding and disk IO are left to the caller's thread.
+    // Quest paths are cached by the quest graph, so this doesn't build any strings.
+    OutSnapshot.ActiveQuests.Reserve(ActiveQuests.Items.Num());
+    for (const FQuestRuntimeState& State : ActiveQuests.Items)
+    {
+        FQuestSaveRecord& Record = OutSnapshot.ActiveQuests.AddDefaulted_GetRef();
+        Record.Quest = Graph.GetQuestPath(State.Quest->QuestId);
+        Record.Status = State.Status;
+        Record.ObjectiveProgress = State.ObjectiveProgress.Values;
+        Record.ObjectiveDeadlines = State.ObjectiveDeadlines;
+    }
+
+    // Restored quests still waiting to be activated are part of the player's state all the same.
+    for (const FQuestPendingActivation& Pending : PendingActivations)
+    {
+        if (Pending.bRestored)
+        {
+            FQuestSaveRecord& Record = OutSnapshot.ActiveQuests.AddDefaulted_GetRef();
+            Record.Quest = Graph.GetQuestPath(Pending.Quest->QuestId);
+            Record.Status = EQuestStatus::Active;
+            Record.ObjectiveProgress = Pending.ObjectiveProgress;
+            Record.ObjectiveDeadlines = Pending.ObjectiveDeadlines;
+        }
+    }
+
+    OutSnapshot.CompletedQuests.Reserve(GetNumCompletedQuests());
+    for (TConstSetBitIterator<> It(CompletedQuestBits); It; ++It)
+    {
+        OutSnapshot.CompletedQuests.Add(Graph.GetQuestPath(It.GetIndex()));
+    }
+
+    OutSnapshot.CompletionHistory.Reserve(CompletionHistory.Num());
+    CompletionHistory.ForEachEntry([&OutSnapshot, &Graph](int32 QuestId, int64 UnixTimestamp)
+    {
+        OutSnapshot.CompletionHistory.Add({ Graph.GetQuestPath(QuestId), UnixTimestamp });
+    });
+}
+
+bool UQuestManagerComponent::RestoreSaveSnapshot(const FQuestSaveSnapshot& Snapshot, bool bTimeSliced)
+{
+    LLM_SCOPE_BYTAG(Quests_Runtime);
+
+    UQuestDefinitionSubsystem* Definitions = UQuestDefinitionSubsystem::Get();
+    if (!Definitions)
+    {
+        return false;
+    }
+
+    // The journal is brought up to date with one snapshot record of this player afterwards, rather than by
+    // recording every step.
+    UQuestJournalSubsystem* Journal = JournalSubsystem;
+    JournalSubsystem = nullptr;
+
+    // Start from a clean slate: the save replaces whatever this player had.
+    while (ActiveQuests.Items.Num() > 0)
+    {
+        RemoveQuest(ActiveQuests.Items.Last().Quest);
+    }
+    PendingActivations.Reset();
+    CompletedQuestBits.Reset();
+    CompletionHistory.Reset();
+    RemainingPrerequisites.Reset();
+
+    // Quests that were removed from the game since the save was written are skipped.
+    auto ResolveQuest = [Definitions](const FSoftObjectPath& Path) -> UQuestNode*
+    {
+        UQuestNode* Quest = Cast<UQuestNode>(Path.TryLoad());
+        if (!Quest)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("QuestManagerComponent: Saved quest '%s' no longer exists, skipping it."), *Path.ToString());
+            return nullptr;
+        }
+        Definitions->RegisterQuest(Quest);
+        return Quest;
+    };
+
+    for (const FSoftObjectPath& Path : Snapshot.CompletedQuests)
+    {
+        if (const UQuestNode* Quest = ResolveQuest(Path))
+        {
+            SetQuestCompletedBit(Quest->QuestId);
+        }
+    }
+
+    for (const FQuestSaveCompletion& Completion : Snapshot.CompletionHistory)
+    {
+        if (const UQuestNode* Quest = ResolveQuest(Completion.Quest))
+        {
+            CompletionHistory.Add(Quest->QuestId, Completion.UnixTimestamp);
+        }
+    }
+
+    // Counters depend on the completed set, so rebuild them before reactivating quests.
+    SyncPrerequisiteCounters();
+
+    for (const FQuestSaveRecord& Record : Snapshot.ActiveQuests)
+    {
+        UQuestNode* Quest = ResolveQuest(Record.Quest);
+        if (!Quest || Record.Status != EQuestStatus::Active || IsQuestActive(Quest) || IsQuestPendingActivation(Quest))
+        {
+            continue;
+        }
+
+        if (bTimeSliced)
+        {
+            FQuestPendingActivation& Pending = PendingActivations.AddDefaulted_GetRef();
+            Pending.Quest = Quest;
+            Pending.bRestored = true;
+            Pending.ObjectiveProgress = Record.ObjectiveProgress;
+            Pending.ObjectiveDeadlines = Record.ObjectiveDeadlines;
+        }
+        else if (ActivateQuest(Quest, Record.ObjectiveProgress, Record.ObjectiveDeadlines))
+        {
+            CompleteIfWithoutObjectives(Quest);
+        }
+    }
+    UpdateTickEnabled();
+
+    JournalSubsystem = Journal;
+    if (JournalSubsystem)
+    {
+        JournalSubsystem->AppendPlayerSnapshot(this);
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("QuestManagerComponent: Restored %d active (%d pending activation) and %d completed quests for player '%s'."), ActiveQuests.Items.Num() + PendingActivations.Num(), PendingActivations.Num(), GetNumCompletedQuests(), *GetNameSafe(GetOwner()));
+    return true;
+}
+
+void UQuestManagerComponent::JournalMutation(EQuestJournalOp Op, const UQuestNode* Quest, int32 ObjectiveIndex, int64 Value)
+{
+    const UQuestDefinitionSubsystem* Definitions = JournalSubsystem ? UQuestDefinitionSubsystem::Get() : nullptr;
+    if (!Definitions || Quest->QuestId == INDEX_NONE)
+    {
+        return;
+    }
+
+    FQuestJournalRecord Record;
+    Record.Op = Op;
+    Record.PlayerId = PersistenceId;
+    Record.Quest = Definitions->GetQuestGraph().GetQuestPath(Quest->QuestId);
+    Record.ObjectiveIndex = ObjectiveIndex;
+    Record.Value = Value;
+    JournalSubsystem->Append(Record);
+}
+
+void UQuestManagerComponent::SaveQuestStateAsync(const FString& SlotName, int32 UserIndex)
+{
+    // Capture on the game thread, then encode and write on a worker thread.
+    TSharedRef<FQuestSaveSnapshot> Snapshot = MakeShared<FQuestSaveSnapshot>();
+    CaptureSaveSnapshot(*Snapshot);
+
+    TWeakObjectPtr<UQuestManagerComponent> WeakThis(this);
+    Async(EAsyncExecution::ThreadPool, [Snapshot, SlotName, UserIndex, WeakThis]()
+    {
+        TArray<uint8> SaveData;
+        Snapshot->WriteTo(SaveData);
+        const bool bSuccess = UGameplayStatics::SaveDataToSlot(SaveData, SlotName, UserIndex);
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, SlotName, bSuccess]()
+        {
+            UQuestManagerComponent* QuestManager = WeakThis.Get();
+            if (QuestManager && QuestManager->OnQuestStateSavedDelegate.IsBound())
+            {
+                QuestManager->OnQuestStateSavedDelegate.Broadcast(SlotName, bSuccess);
+            }
+        });
+    });
+}
+
+void UQuestManagerComponent::LoadQuestStateAsync(const FString& SlotName, int32 UserIndex)
+{
+    // Read and parse on a worker thread; only resolving quests and rebuilding state happens on the game thread.
+    TWeakObjectPtr<UQuestManagerComponent> WeakThis(this);
+    Async(EAsyncExecution::ThreadPool, [SlotName, UserIndex, WeakThis]()
+    {
+        TSharedRef<FQuestSaveSnapshot> Snapshot = MakeShared<FQuestSaveSnapshot>();
+        TArray<uint8> SaveData;
+        const bool bParsed = UGameplayStatics::LoadDataFromSlot(SaveData, SlotName, UserIndex) && Snapshot->ReadFrom(SaveData);
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, SlotName, Snapshot, bParsed]()
+        {
+            UQuestManagerComponent* QuestManager = WeakThis.Get();
+            if (!QuestManager)
+            {
+                return;
+            }
+
+            const bool bSuccess = bParsed && QuestManager->RestoreSaveSnapshot(*Snapshot, true);
+            if (QuestManager->OnQuestStateLoadedDelegate.IsBound())
+            {
+                QuestManager->OnQuestStateLoadedDelegate.Broadcast(SlotName, bSuccess);
+            }
+        });
+    });
+}
+
+// --- QUEST AVAILABILITY ---
+
+void UQuestManagerComponent::SyncPrerequisiteCounters()
+{
+    LLM_SCOPE_BYTAG(Quests_Runtime);
+
+    const UQuestDefinitionSubsystem* Definitions = UQuestDefinitionSubsystem::Get();
+    if (!Definitions)
+    {
+        return;
+    }
+
+    // Quest IDs are append-only, so only quests compiled since the last sync need a counter.
+    // Their prerequisites may already have been completed by this player.
+    const FQuestGraph& Graph = Definitions->GetQuestGraph();
+    for (int32 QuestId = RemainingPrerequisites.Num(); QuestId < Graph.Num(); ++QuestId)
+    {
+        int32 NumRemaining = 0;
+        for (const int32 PrerequisiteId : Graph.GetPrerequisites(QuestId))
+        {
+            if (!HasQuestBeenCompleted(Graph.GetQuest(PrerequisiteId)))
+            {
+                ++NumRemaining;
+            }
+        }
+        check(NumRemaining <= MAX_uint16);
+        RemainingPrerequisites.Add(static_cast<uint16>(NumRemaining));
+    }
+}
+
+void UQuestManagerComponent::UnlockFollowUps(const UQuestNode* CompletedQuest)
+{
+    const UQuestDefinitionSubsystem* Definitions = UQuestDefinitionSubsystem::Get();
+    if (!Definitions || CompletedQuest->QuestId == INDEX_NONE)
+    {
+        return;
+    }
+
+    const FQuestGraph& Graph = Definitions->GetQuestGraph();
+    for (const int32 FollowUpId : Graph.GetFollowUps(CompletedQuest->QuestId))
+    {
+        if (RemainingPrerequisites[FollowUpId] > 0 && --RemainingPrerequisites[FollowUpId] == 0)
+        {
+            UQuestNode* FollowUp = Graph.GetQuest(FollowUpId);
+            FollowUp->OnQuestUnlocked(this); // Call its unlock event (BlueprintImplementableEvent)
+            UE_LOG(LogTemp, Log, TEXT("QuestManagerComponent for '%s': Quest '%s' unlocked follow-up quest '%s'."), *GetNameSafe(GetOwner()), *CompletedQuest->QuestName.ToString(), *FollowUp->QuestName.ToString());
+        }
+    }
+}
+
+// --- EVENT SUBSCRIBER INDEX ---
+
+void UQuestManagerComponent::RegisterQuestObjectives(const FQuestRuntimeState& State)
+{
+    for (int32 Index = 0; Index < State.Quest->Objectives.Num(); ++Index)
+    {
+        const UObjective* Objective = State.Quest->Objectives[Index];
+        if (IsValid(Objective) && !ProgressSubsystem->IsRowCompleted(State.FirstProgressRow + Index))
+        {
+            RegisterObjective({ State.Quest, Index });
+        }
+    }
+}
+
+void UQuestManagerComponent::UnregisterQuestObjectives(UQuestNode* Quest)
+{
+    for (int32 Index = 0; Index < Quest->Objectives.Num(); ++Index)
+    {
+        if (IsValid(Quest->Objectives[Index]))
+        {
+            UnregisterObjective({ Quest, Index });
+        }
+    }
+}
+
+void UQuestManagerComponent::RegisterObjective(const FObjectiveSubscriber& Subscriber)
+{
+    LLM_SCOPE_BYTAG(Quests_Runtime);
+
+    const UObjective* Objective = Subscriber.Quest->Objectives[Subscriber.ObjectiveIndex];
+    if (Objective->HandledEventTags.IsEmpty())
+    {
+        WildcardSubscribers.AddUnique(Subscriber);
+        return;
+    }
+
+    TArray<int32, TInlineAllocator<4>> TagIndices;
+    FQuestEventTags::Get().GetEffectiveSubscriptions(Objective->HandledEventTags, TagIndices);
+    for (const int32 TagIndex : TagIndices)
+    {
+        EventSubscribers.FindOrAdd(TagIndex).AddUnique(Subscriber);
+        FQuestEventTags::AddToMask(SubscribedTagMask, TagIndex);
+    }
+}
+
+void UQuestManagerComponent::UnregisterObjective(const FObjectiveSubscriber& Subscriber)
+{
+    const UObjective* Objective = Subscriber.Quest->Objectives[Subscriber.ObjectiveIndex];
+    if (Objective->HandledEventTags.IsEmpty())
+    {
+        WildcardSubscribers.RemoveSingleSwap(Subscriber);
+        return;
+    }
+
+    TArray<int32, TInlineAllocator<4>> TagIndices;
+    FQuestEventTags::Get().GetEffectiveSubscriptions(Objective->HandledEventTags, TagIndices);
+    for (const int32 TagIndex : TagIndices)
+    {
+        if (TArray<FObjectiveSubscriber>* Subscribers = EventSubscribers.Find(TagIndex))
+        {
+            Subscribers->RemoveSingleSwap(Subscriber);
+            if (Subscribers->IsEmpty())
+            {
+                EventSubscribers.Remove(TagIndex);
+                SubscribedTagMask[TagIndex] = false;
+            }
+        }
+    }
+}
+
+// --- QUEST COMPLETION ---
+
+void UQuestManagerComponent::OnQuestCompleted(UQuestNode* CompletedQuest)
+{
+    UE_LOG(LogTemp, Log, TEXT("QuestManagerComponent for '%s': Quest '%s' reports all objectives completed!"), *GetNameSafe(GetOwner()), *CompletedQuest->QuestName.ToString());
+
+    // Move the quest from the active list to the completed set first, so follow-up availability checks see it.
+    RemoveQuest(CompletedQuest); // This also unregisters and uninitializes the quest's objectives.
+    SyncPrerequisiteCounters(); // Before recording the completion, so UnlockFollowUps doesn't count it twice.
+    const bool bFirstCompletion = !HasQuestBeenCompleted(CompletedQuest);
+    MarkQuestCompleted(CompletedQuest);
+
+    // Let the quest run its completion logic for this player.
+    CompletedQuest->OnQuestCompleted(this);
+
+    // Each prerequisite only counts once, so only the first completion unlocks follow-ups.
+    if (bFirstCompletion)
+    {
+        UnlockFollowUps(CompletedQuest);
+    }
+
+    // You can now trigger events relevant to the entire quest completion for this player.
+    // e.g., Update UI, grant rewards, trigger cinematics.
+
+    // Broadcast to UI/other systems. The dynamic delegate is only touched if Blueprint actually listens.
+    OnPlayerQuestCompletedNative.Broadcast(CompletedQuest);
+    if (OnPlayerQuestCompletedDelegate.IsBound())
+    {
+        OnPlayerQuestCompletedDelegate.Broadcast(CompletedQuest);
+    }
+}
+
+FDateTime UQuestManagerComponent::GetObjectiveDeadline(const UTimedObjective* Objective) const
+{
+    // Objectives are instanced subobjects of the quest that owns them.
+    const UQuestNode* Quest = Objective ? Cast<UQuestNode>(Objective->GetOuter()) : nullptr;
+    const FQuestRuntimeState* State = Quest ? FindActiveQuestState(Quest) : nullptr;
+    const int32 ObjectiveIndex = State ? Quest->Objectives.IndexOfByKey(Objective) : INDEX_NONE;
+    return State && State->ObjectiveDeadlines.IsValidIndex(ObjectiveIndex) ? FDateTime(State->ObjectiveDeadlines[ObjectiveIndex]) : FDateTime(0);
+}
+
+void UQuestManagerComponent::OnObjectiveTimeLimitExpired(const UTimedObjective* Objective)
+{
+    // Objectives are instanced subobjects of the quest that owns them.
+    UQuestNode* Quest = Objective ? Cast<UQuestNode>(Objective->GetOuter()) : nullptr;
+    const int32 ObjectiveIndex = Quest ? Quest->Objectives.IndexOfByKey(Objective) : INDEX_NONE;
+    if (ObjectiveIndex == INDEX_NONE || !IsQuestActive(Quest))
+    {
+        return;
+    }
+
+    UE_LOG(LogTemp, Verbose, TEXT("QuestManagerComponent for '%s': Time limit of objective %d of quest '%s' expired."), *GetNameSafe(GetOwner()), ObjectiveIndex, *Quest->QuestName.ToString());
+
+    if (Objective->ExpiryBehavior == ETimedObjectiveExpiry::Complete)
+    {
+        CompleteObjective(Quest, ObjectiveIndex);
+    }
+    else
+    {
+        FailQuest(Quest);
+    }
+}
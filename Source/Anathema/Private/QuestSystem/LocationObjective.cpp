@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/LocationObjective.h"
+#include "QuestSystem/QuestLocationSubsystem.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+
+void ULocationObjective::PostInitProperties()
+{
+    Super::PostInitProperties();
+    SyncHandledEventTags();
+}
+
+void ULocationObjective::PostLoad()
+{
+    Super::PostLoad();
+    SyncHandledEventTags();
+}
+
+#if WITH_EDITOR
+void ULocationObjective::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+    SyncHandledEventTags();
+}
+#endif
+
+bool ULocationObjective::CanProcessEventsInParallel() const
+{
+    return GetClass() == ULocationObjective::StaticClass();
+}
+
+bool ULocationObjective::ReadsTriggeringActor() const
+{
+    return GetClass() != ULocationObjective::StaticClass();
+}
+
+void ULocationObjective::SyncHandledEventTags()
+{
+    if (!RegionTag.IsNone())
+    {
+        HandledEventTags.AddUnique(RegionTag);
+    }
+}
+
+void ULocationObjective::InitializeObjective_Implementation(AActor* OwningActor) const
+{
+    Super::InitializeObjective_Implementation(OwningActor);
+
+    UWorld* World = OwningActor ? OwningActor->GetWorld() : nullptr;
+    if (UQuestLocationSubsystem* Locations = World ? World->GetSubsystem<UQuestLocationSubsystem>() : nullptr)
+    {
+        Locations->AddRegionInterest(this, OwningActor);
+    }
+}
+
+void ULocationObjective::UninitializeObjective_Implementation(AActor* OwningActor) const
+{
+    UWorld* World = OwningActor ? OwningActor->GetWorld() : nullptr;
+    if (UQuestLocationSubsystem* Locations = World ? World->GetSubsystem<UQuestLocationSubsystem>() : nullptr)
+    {
+        Locations->RemoveRegionInterest(this, OwningActor);
+    }
+
+    Super::UninitializeObjective_Implementation(OwningActor);
+}
@@ -2,10 +2,11 @@
 
 
 #include "QuestSystem/Objective.h"
+#include "QuestSystem/QuestEventTags.h"
 
 UObjective::UObjective()
     : ObjectiveDescription(FText::FromString(TEXT("Default Objective")))
-    , bIsCompleted(false)
+    , RequiredProgress(1)
 {
     // Default constructor. Member initializers are preferred for default values.
 }
@@ -14,53 +15,108 @@ UObjective::UObjective()
 // Derived C++ classes can override these using 'override' keyword.
 // Blueprint subclasses can override these in their event graphs.
 
-void UObjective::InitializeObjective_Implementation(AActor* OwningActor)
+void UObjective::InitializeObjective_Implementation(AActor* OwningActor) const
 {
-    // Reset state when objective is initialized (e.g., when a quest becomes active)
-    bIsCompleted = false;
-    UE_LOG(LogTemp, Log, TEXT("Base Objective Initialized: %s"), *ObjectiveDescription.ToString());
-    // Derived classes will add specific initialization logic (e.g., binding to game events).
+    UE_LOG(LogTemp, Verbose, TEXT("Base Objective Initialized for '%s': %s"), *GetNameSafe(OwningActor), *ObjectiveDescription.ToString());
+    // Derived classes will add specific initialization logic (e.g., spawning a quest marker for this player).
 }
-void UObjective::UninitializeObjective_Implementation() // <--- NEW IMPLEMENTATION
+
+void UObjective::UninitializeObjective_Implementation(AActor* OwningActor) const
 {
-    UE_LOG(LogTemp, Log, TEXT("Base UObjective '%s' Uninitialized."), *ObjectiveDescription.ToString());
-    // Derived classes will override this to perform specific cleanup (e.g., unbind from events).
+    UE_LOG(LogTemp, Verbose, TEXT("Base UObjective '%s' Uninitialized for '%s'."), *ObjectiveDescription.ToString(), *GetNameSafe(OwningActor));
+    // Derived classes will override this to perform specific cleanup.
 }
 
-bool UObjective::IsObjectiveCurrentlyComplete_Implementation() const
+bool UObjective::IsObjectiveCurrentlyComplete_Implementation(int32 Progress) const
 {
-    // Default base implementation: An objective is complete if bIsCompleted is true.
-    // Derived classes will add their specific logic (e.g., CurrentKills >= RequiredKills).
-    return bIsCompleted;
+    // Default base implementation: An objective is complete once the player's progress reaches RequiredProgress.
+    return Progress >= RequiredProgress;
 }
 
-FText UObjective::GetProgressText_Implementation() const
+FText UObjective::GetProgressText_Implementation(int32 Progress) const
 {
-    // Default base implementation: Return "Completed!" if done, otherwise the description.
-    if (bIsCompleted)
+    // Default base implementation: Return "Completed!" if done, otherwise the description with a counter.
+    if (IsObjectiveCurrentlyComplete(Progress))
     {
         return FText::Format(FText::FromString(TEXT("{0} (Completed)")), ObjectiveDescription);
     }
+    if (RequiredProgress > 1)
+    {
+        return FText::Format(FText::FromString(TEXT("{0} ({1}/{2})")), ObjectiveDescription, FText::AsNumber(Progress), FText::AsNumber(RequiredProgress));
+    }
     return ObjectiveDescription; // Fallback to just the description if not overridden
 }
 
-void UObjective::CompleteObjective()
+int32 UObjective::ProcessGameEvent_Implementation(const FObjectiveEventData& EventData, int32 CurrentProgress) const
+{
+    // Objectives without tags receive every event, so the base class can't assume the event is relevant.
+    if (HandledEventTags.IsEmpty())
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("Base UObjective '%s' received event"), *ObjectiveDescription.ToString());
+        return CurrentProgress;
+    }
+
+    // The event matched one of HandledEventTags: count every occurrence it represents.
+    return CurrentProgress + EventData.Count;
+}
+
+bool UObjective::HandlesEventTag(FName EventTag) const
+{
+    if (HandledEventTags.IsEmpty())
+    {
+        return true;
+    }
+
+    // Already registered by the dispatch code for any event being processed, so this doesn't parse the name.
+    FQuestEventTags& Tags = FQuestEventTags::Get();
+    const int32 EventTagIndex = Tags.RegisterTag(EventTag);
+    if (!HandledTagMask.IsEmpty())
+    {
+        return FQuestEventTags::MasksIntersect(HandledTagMask, Tags.GetAncestorMask(EventTagIndex));
+    }
+
+    // Not compiled into the quest graph yet (or edited since): match the tags one by one.
+    for (const FName& Tag : HandledEventTags)
+    {
+        const int32 HandledTagIndex = Tags.FindTag(Tag);
+        if (HandledTagIndex != INDEX_NONE && Tags.Matches(EventTagIndex, HandledTagIndex))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void UObjective::UpdateHandledTagMask()
 {
-    if (!bIsCompleted)
+    FQuestEventTags& Tags = FQuestEventTags::Get();
+    HandledTagMask.Empty();
+    for (const FName& Tag : HandledEventTags)
     {
-        bIsCompleted = true;
-        UE_LOG(LogTemp, Log, TEXT("Objective Completed: %s"), *ObjectiveDescription.ToString());
-        // Broadcast the delegate to notify any listeners (like the UQuestNode)
-        OnObjectiveCompletedDelegate.Broadcast(this);
-        // After an objective is completed, it's a good idea to uninitialize it to stop listening.
-        // This is often handled by the UQuestNode or UQuestManagerComponent after it gets the completion broadcast,
-        // but can also be done here if the objective is truly self-contained.
-        // Execute_UninitializeObjective(this); // Uncomment if objective should uninitialize itself
+        if (!Tag.IsNone())
+        {
+            FQuestEventTags::AddToMask(HandledTagMask, Tags.RegisterTag(Tag));
+        }
     }
 }
 
-void UObjective::ProcessGameEvent_Implementation(const FObjectiveEventData& EventData)
+#if WITH_EDITOR
+void UObjective::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    // The tags may have changed, and the quest isn't compiled again.
+    HandledTagMask.Empty();
+}
+#endif
+
+bool UObjective::CanProcessEventsInParallel() const
 {
-    // The base class simply logs, derived classes will implement their specific checks.
-    UE_LOG(LogTemp, Verbose, TEXT("Base UObjective '%s' received event"), *ObjectiveDescription.ToString());
-}
\ No newline at end of file
+    // Only this class's own ProcessGameEvent is known to just count; a subclass may override it in any way.
+    return GetClass() == UObjective::StaticClass();
+}
+
+bool UObjective::ReadsTriggeringActor() const
+{
+    return GetClass() != UObjective::StaticClass();
+}
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestCompletionHistory.h"
+
+void FQuestCompletionHistory::Add(int32 QuestId, int64 UnixTimestamp)
+{
+    // Zigzag-encode the ID delta so quests completed "out of order" still take few bytes.
+    const int64 IdDelta = static_cast<int64>(QuestId) - LastQuestId;
+    WriteVarInt(EncodedEntries, static_cast<uint64>((IdDelta << 1) ^ (IdDelta >> 63)));
+
+    // Completions are appended in time order; a clock going backwards is recorded as "same second".
+    WriteVarInt(EncodedEntries, static_cast<uint64>(FMath::Max<int64>(UnixTimestamp - LastTimestamp, 0)));
+
+    LastQuestId = QuestId;
+    LastTimestamp = FMath::Max(UnixTimestamp, LastTimestamp);
+    ++NumEntries;
+}
+
+void FQuestCompletionHistory::ForEachEntry(TFunctionRef<void(int32 QuestId, int64 UnixTimestamp)> Visitor) const
+{
+    int32 Offset = 0;
+    int64 QuestId = 0;
+    int64 Timestamp = 0;
+    for (int32 Entry = 0; Entry < NumEntries; ++Entry)
+    {
+        const uint64 ZigzagDelta = ReadVarInt(EncodedEntries, Offset);
+        QuestId += static_cast<int64>(ZigzagDelta >> 1) ^ -static_cast<int64>(ZigzagDelta & 1);
+        Timestamp += static_cast<int64>(ReadVarInt(EncodedEntries, Offset));
+        Visitor(static_cast<int32>(QuestId), Timestamp);
+    }
+}
+
+int64 FQuestCompletionHistory::FindCompletionTime(int32 QuestId) const
+{
+    int64 CompletionTime = 0;
+    ForEachEntry([QuestId, &CompletionTime](int32 EntryQuestId, int64 UnixTimestamp)
+    {
+        if (EntryQuestId == QuestId)
+        {
+            CompletionTime = UnixTimestamp;
+        }
+    });
+    return CompletionTime;
+}
+
+void FQuestCompletionHistory::Reset()
+{
+    EncodedEntries.Reset();
+    NumEntries = 0;
+    LastQuestId = 0;
+    LastTimestamp = 0;
+}
+
+void FQuestCompletionHistory::WriteVarInt(TArray<uint8>& Out, uint64 Value)
+{
+    // 7 bits per byte, high bit set on every byte but the last.
+    while (Value >= 0x80)
+    {
+        Out.Add(static_cast<uint8>(Value | 0x80));
+        Value >>= 7;
+    }
+    Out.Add(static_cast<uint8>(Value));
+}
+
+uint64 FQuestCompletionHistory::ReadVarInt(const TArray<uint8>& In, int32& Offset)
+{
+    uint64 Value = 0;
+    for (int32 Shift = 0; Offset < In.Num() && Shift < 64; Shift += 7)
+    {
+        const uint8 Byte = In[Offset++];
+        Value |= static_cast<uint64>(Byte & 0x7F) << Shift;
+        if ((Byte & 0x80) == 0)
+        {
+            break;
+        }
+    }
+    return Value;
+}
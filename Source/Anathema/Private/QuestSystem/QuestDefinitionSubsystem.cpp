@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestDefinitionSubsystem.h"
+#include "QuestSystem/QuestStats.h"
+#include "QuestSystem/QuestNode.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectArray.h"
+
+static TAutoConsoleVariable<bool> CVarQuestClusterDefinitions(
+    TEXT("quest.ClusterDefinitions"),
+    true,
+    TEXT("Put quest definitions in GC clusters when they are compiled into the quest graph (requires gc.CreateGCClusters; never in the editor)."));
+
+UQuestDefinitionSubsystem* UQuestDefinitionSubsystem::Get()
+{
+    return GEngine ? GEngine->GetEngineSubsystem<UQuestDefinitionSubsystem>() : nullptr;
+}
+
+void UQuestDefinitionSubsystem::RegisterQuests(const TArray<UQuestNode*>& Quests)
+{
+    LLM_SCOPE_BYTAG(Quests_Definitions);
+
+    const int32 FirstQuestId = QuestGraph.Num();
+    QuestGraph.AddQuests(Quests);
+    ClusterNewQuests(FirstQuestId);
+}
+
+void UQuestDefinitionSubsystem::RegisterQuest(UQuestNode* Quest)
+{
+    LLM_SCOPE_BYTAG(Quests_Definitions);
+
+    if (IsValid(Quest) && Quest->QuestId == INDEX_NONE)
+    {
+        const int32 FirstQuestId = QuestGraph.Num();
+        QuestGraph.AddQuests(MakeArrayView(&Quest, 1));
+        ClusterNewQuests(FirstQuestId);
+    }
+}
+
+void UQuestDefinitionSubsystem::UnregisterQuestsFrom(int32 FirstQuestId)
+{
+    QuestGraph.RemoveQuestsFrom(FirstQuestId);
+}
+
+void UQuestDefinitionSubsystem::ClusterNewQuests(int32 FirstQuestId)
+{
+    static const IConsoleVariable* CVarCreateGCClusters = IConsoleManager::Get().FindConsoleVariable(TEXT("gc.CreateGCClusters"));
+    if (GIsEditor || !CVarQuestClusterDefinitions.GetValueOnGameThread() || (CVarCreateGCClusters && !CVarCreateGCClusters->GetBool()))
+    {
+        return;
+    }
+
+    TArray<UQuestNode*> NewQuests;
+    for (int32 QuestId = FirstQuestId; QuestId < QuestGraph.Num(); ++QuestId)
+    {
+        NewQuests.Add(QuestGraph.GetQuest(QuestId));
+    }
+    ClusterQuests(NewQuests);
+}
+
+int32 UQuestDefinitionSubsystem::ClusterQuests(TConstArrayView<UQuestNode*> Quests)
+{
+    // Quests come in topological order, so the first quest of a line is clustered first.
+    int32 NumClustered = 0;
+    for (UQuestNode* Quest : Quests)
+    {
+        if (!IsValid(Quest))
+        {
+            continue;
+        }
+        if (!IsClustered(Quest) && Quest->CanBeClusterRoot())
+        {
+            Quest->CreateCluster();
+        }
+        NumClustered += IsClustered(Quest) ? 1 : 0;
+    }
+    return NumClustered;
+}
+
+bool UQuestDefinitionSubsystem::IsClustered(const UQuestNode* Quest)
+{
+    return Quest->HasAnyInternalFlags(EInternalObjectFlags::ClusterRoot) || GUObjectArray.ObjectToObjectItem(Quest)->GetOwnerIndex() > 0;
+}
+
+void UQuestDefinitionSubsystem::Deinitialize()
+{
+    // Hand the IDs back so the quests can be compiled again if the subsystem is recreated.
+    QuestGraph.RemoveQuestsFrom(0);
+    QuestGraph = FQuestGraph();
+
+    Super::Deinitialize();
+}
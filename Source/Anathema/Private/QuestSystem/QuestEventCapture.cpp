@@ -0,0 +1,362 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestEventCapture.h"
+#include "QuestSystem/QuestStats.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+namespace
+{
+    void SerializeCount(FArchive& Ar, int32& Count)
+    {
+        uint32 PackedCount = static_cast<uint32>(Count);
+        Ar.SerializeIntPacked(PackedCount);
+        Count = static_cast<int32>(PackedCount);
+    }
+
+    // Indices that may be INDEX_NONE are stored as Index + 1.
+    void SerializeOptionalIndex(FArchive& Ar, int32& Index)
+    {
+        uint32 PackedIndex = static_cast<uint32>(Index + 1);
+        Ar.SerializeIntPacked(PackedIndex);
+        Index = static_cast<int32>(PackedIndex) - 1;
+    }
+
+    // Writes the entries added to a table since the last chunk.
+    template <typename TableType, typename FunctorType>
+    void WriteNewEntries(FArchive& Ar, TableType& Table, FunctorType&& WriteEntry)
+    {
+        int32 NumNew = Table.Values.Num() - Table.NumWritten;
+        SerializeCount(Ar, NumNew);
+        for (int32 Index = Table.NumWritten; Index < Table.Values.Num(); ++Index)
+        {
+            WriteEntry(Table.Values[Index]);
+        }
+        Table.NumWritten = Table.Values.Num();
+    }
+}
+
+// --- READING ---
+
+bool FQuestEventCapture::LoadFromFile(const FString& Path)
+{
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *Path))
+    {
+        return false;
+    }
+
+    FMemoryReader Ar(Data);
+    uint32 FileMagic = 0;
+    uint16 Reserved = 0;
+    Ar << FileMagic << Version << Reserved;
+    if (Ar.IsError() || FileMagic != Magic || Version > CurrentVersion)
+    {
+        return false;
+    }
+
+    // Tables are cumulative over chunks, like in the writer.
+    TArray<FName> Tags;
+    TArray<const UScriptStruct*> PayloadTypes;
+    TArray<FSoftObjectPath> Quests;
+    uint64 Frame = 0;
+    uint64 TimeMicros = 0;
+
+    while (Ar.TotalSize() - Ar.Tell() >= static_cast<int64>(sizeof(uint32)))
+    {
+        uint32 ChunkSize = 0;
+        Ar << ChunkSize;
+        const int64 ChunkEnd = Ar.Tell() + ChunkSize;
+        if (ChunkEnd > Ar.TotalSize())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("FQuestEventCapture: '%s' ends with a truncated chunk, which was skipped."), *Path);
+            break;
+        }
+
+        int32 NumNew = 0;
+        SerializeCount(Ar, NumNew);
+        for (int32 Index = 0; Index < NumNew && !Ar.IsError(); ++Index)
+        {
+            FString Tag;
+            Ar << Tag;
+            Tags.Add(FName(*Tag));
+        }
+
+        SerializeCount(Ar, NumNew);
+        for (int32 Index = 0; Index < NumNew && !Ar.IsError(); ++Index)
+        {
+            FQuestCapturedPlayer& Player = Players.AddDefaulted_GetRef();
+            Ar << Player.Name << Player.InitialState;
+        }
+
+        SerializeCount(Ar, NumNew);
+        for (int32 Index = 0; Index < NumNew && !Ar.IsError(); ++Index)
+        {
+            FQuestCapturedActor& Actor = Actors.AddDefaulted_GetRef();
+            FString ClassPath;
+            Ar << Actor.Name << ClassPath;
+            Actor.Class = FSoftClassPath(ClassPath);
+        }
+
+        SerializeCount(Ar, NumNew);
+        for (int32 Index = 0; Index < NumNew && !Ar.IsError(); ++Index)
+        {
+            FString TypePath;
+            Ar << TypePath;
+            PayloadTypes.Add(LoadObject<UScriptStruct>(nullptr, *TypePath));
+        }
+
+        SerializeCount(Ar, NumNew);
+        for (int32 Index = 0; Index < NumNew && !Ar.IsError(); ++Index)
+        {
+            FString QuestPath;
+            Ar << QuestPath;
+            Quests.Add(FSoftObjectPath(QuestPath));
+        }
+
+        int32 NumEvents = 0;
+        SerializeCount(Ar, NumEvents);
+        for (int32 EventIndex = 0; EventIndex < NumEvents && !Ar.IsError(); ++EventIndex)
+        {
+            FQuestCapturedEvent& Event = Events.AddDefaulted_GetRef();
+            uint8 Kind = 0;
+            uint64 FrameDelta = 0;
+            uint64 TimeDelta = 0;
+            Ar << Kind;
+            Ar.SerializeIntPacked64(FrameDelta);
+            Ar.SerializeIntPacked64(TimeDelta);
+            Frame += FrameDelta;
+            TimeMicros += TimeDelta;
+            Event.Kind = static_cast<EQuestCapturedEventKind>(Kind);
+            Event.Frame = Frame;
+            Event.Time = TimeMicros / 1000000.0;
+            SerializeOptionalIndex(Ar, Event.Player);
+
+            if (Event.Kind == EQuestCapturedEventKind::QuestAdded)
+            {
+                int32 QuestIndex = 0;
+                SerializeCount(Ar, QuestIndex);
+                Event.Quest = Quests.IsValidIndex(QuestIndex) ? Quests[QuestIndex] : FSoftObjectPath();
+                continue;
+            }
+
+            if (Event.Kind == EQuestCapturedEventKind::GroupEvent)
+            {
+                int32 NumGroupPlayers = 0;
+                SerializeCount(Ar, NumGroupPlayers);
+                for (int32 Index = 0; Index < NumGroupPlayers && !Ar.IsError(); ++Index)
+                {
+                    SerializeCount(Ar, Event.GroupPlayers.AddDefaulted_GetRef());
+                }
+            }
+
+            int32 TagIndex = 0;
+            int32 PayloadTypeIndex = INDEX_NONE;
+            SerializeCount(Ar, TagIndex);
+            SerializeOptionalIndex(Ar, Event.TriggeringActor);
+            if (Version >= 2)
+            {
+                SerializeOptionalIndex(Ar, Event.ResponsiblePlayerController);
+            }
+            SerializeCount(Ar, Event.Count);
+            SerializeOptionalIndex(Ar, PayloadTypeIndex);
+            Event.EventTag = Tags.IsValidIndex(TagIndex) ? Tags[TagIndex] : NAME_None;
+
+            if (PayloadTypeIndex != INDEX_NONE)
+            {
+                TArray<uint8> PayloadBytes;
+                Ar << PayloadBytes;
+
+                // Payload types that no longer exist are dropped; the event itself is still replayed.
+                UScriptStruct* PayloadType = PayloadTypes.IsValidIndex(PayloadTypeIndex) ? const_cast<UScriptStruct*>(PayloadTypes[PayloadTypeIndex]) : nullptr;
+                if (PayloadType)
+                {
+                    void* Value = FMemory::Malloc(PayloadType->GetStructureSize(), PayloadType->GetMinAlignment());
+                    PayloadType->InitializeStruct(Value);
+                    FMemoryReader PayloadAr(PayloadBytes);
+                    PayloadType->SerializeItem(PayloadAr, Value, nullptr);
+                    Event.Payload.SetStruct(PayloadType, Value);
+                    PayloadType->DestroyStruct(Value);
+                    FMemory::Free(Value);
+                }
+            }
+        }
+
+        if (Ar.IsError() || Ar.Tell() != ChunkEnd)
+        {
+            UE_LOG(LogTemp, Error, TEXT("FQuestEventCapture: '%s' is corrupt."), *Path);
+            return false;
+        }
+    }
+    return true;
+}
+
+// --- WRITING ---
+
+FQuestEventCaptureWriter::~FQuestEventCaptureWriter()
+{
+    Close();
+}
+
+bool FQuestEventCaptureWriter::Open(const FString& Path)
+{
+    Close();
+    FileWriter.Reset(IFileManager::Get().CreateFileWriter(*Path));
+    if (!FileWriter)
+    {
+        return false;
+    }
+
+    uint32 FileMagic = FQuestEventCapture::Magic;
+    uint16 Version = FQuestEventCapture::CurrentVersion;
+    uint16 Reserved = 0;
+    *FileWriter << FileMagic << Version << Reserved;
+    NumBytesWritten = FileWriter->Tell();
+    return true;
+}
+
+void FQuestEventCaptureWriter::Close()
+{
+    if (FileWriter)
+    {
+        Flush();
+        FileWriter->Close();
+        FileWriter.Reset();
+    }
+}
+
+int32 FQuestEventCaptureWriter::FindOrAddPlayer(FObjectKey Key, const FString& Name, TFunctionRef<void(TArray<uint8>&)> GetInitialState)
+{
+    return Players.FindOrAdd(Key, [&]()
+    {
+        FQuestCapturedPlayer Player;
+        Player.Name = Name;
+        GetInitialState(Player.InitialState);
+        return Player;
+    });
+}
+
+int32 FQuestEventCaptureWriter::FindOrAddActor(const AActor* Actor)
+{
+    if (!Actor)
+    {
+        return INDEX_NONE;
+    }
+    return Actors.FindOrAdd(FObjectKey(Actor), [Actor]()
+    {
+        FQuestCapturedActor CapturedActor;
+        CapturedActor.Name = Actor->GetName();
+        CapturedActor.Class = FSoftClassPath(Actor->GetClass());
+        return CapturedActor;
+    });
+}
+
+void FQuestEventCaptureWriter::AddEvent(const FQuestCapturedEvent& Event)
+{
+    if (!FileWriter)
+    {
+        return;
+    }
+    LLM_SCOPE_BYTAG(Quests_EventQueues);
+
+    FMemoryWriter Ar(PendingEvents);
+    Ar.Seek(PendingEvents.Num());
+
+    uint8 Kind = static_cast<uint8>(Event.Kind);
+    const uint64 TimeMicros = static_cast<uint64>(FMath::Max(Event.Time, 0.0) * 1000000.0);
+    uint64 FrameDelta = Event.Frame >= PreviousFrame ? Event.Frame - PreviousFrame : 0;
+    uint64 TimeDelta = TimeMicros >= PreviousTimeMicros ? TimeMicros - PreviousTimeMicros : 0;
+    PreviousFrame += FrameDelta;
+    PreviousTimeMicros += TimeDelta;
+    int32 Player = Event.Player;
+    Ar << Kind;
+    Ar.SerializeIntPacked64(FrameDelta);
+    Ar.SerializeIntPacked64(TimeDelta);
+    SerializeOptionalIndex(Ar, Player);
+
+    if (Event.Kind == EQuestCapturedEventKind::QuestAdded)
+    {
+        int32 QuestIndex = Quests.FindOrAdd(Event.Quest, [&Event]() { return Event.Quest.ToString(); });
+        SerializeCount(Ar, QuestIndex);
+    }
+    else
+    {
+        if (Event.Kind == EQuestCapturedEventKind::GroupEvent)
+        {
+            int32 NumGroupPlayers = Event.GroupPlayers.Num();
+            SerializeCount(Ar, NumGroupPlayers);
+            for (int32 GroupPlayer : Event.GroupPlayers)
+            {
+                SerializeCount(Ar, GroupPlayer);
+            }
+        }
+
+        int32 TagIndex = Tags.FindOrAdd(Event.EventTag, [&Event]() { return Event.EventTag.ToString(); });
+        int32 TriggeringActor = Event.TriggeringActor;
+        int32 ResponsiblePlayerController = Event.ResponsiblePlayerController;
+        int32 Count = FMath::Max(Event.Count, 0);
+        const UScriptStruct* PayloadType = Event.Payload.GetType();
+        int32 PayloadTypeIndex = PayloadType ? PayloadTypes.FindOrAdd(PayloadType, [PayloadType]() { return PayloadType->GetPathName(); }) : INDEX_NONE;
+        SerializeCount(Ar, TagIndex);
+        SerializeOptionalIndex(Ar, TriggeringActor);
+        SerializeOptionalIndex(Ar, ResponsiblePlayerController);
+        SerializeCount(Ar, Count);
+        SerializeOptionalIndex(Ar, PayloadTypeIndex);
+
+        if (PayloadType)
+        {
+            // Tagged property serialization, so captures survive payload structs gaining or losing fields.
+            TArray<uint8> PayloadBytes;
+            FMemoryWriter PayloadAr(PayloadBytes);
+            const_cast<UScriptStruct*>(PayloadType)->SerializeItem(PayloadAr, const_cast<void*>(Event.Payload.GetData()), nullptr);
+            Ar << PayloadBytes;
+        }
+    }
+
+    ++NumEvents;
+    if (++NumPendingEvents >= EventsPerChunk)
+    {
+        Flush();
+    }
+}
+
+void FQuestEventCaptureWriter::Flush()
+{
+    if (!FileWriter || NumPendingEvents == 0)
+    {
+        return;
+    }
+
+    TArray<uint8> Chunk;
+    FMemoryWriter Ar(Chunk);
+    WriteNewEntries(Ar, Tags, [&Ar](FString& Tag) { Ar << Tag; });
+    WriteNewEntries(Ar, Players, [&Ar](FQuestCapturedPlayer& Player) { Ar << Player.Name << Player.InitialState; });
+    WriteNewEntries(Ar, Actors, [&Ar](FQuestCapturedActor& Actor)
+    {
+        FString ClassPath = Actor.Class.ToString();
+        Ar << Actor.Name << ClassPath;
+    });
+    WriteNewEntries(Ar, PayloadTypes, [&Ar](FString& TypePath) { Ar << TypePath; });
+    WriteNewEntries(Ar, Quests, [&Ar](FString& QuestPath) { Ar << QuestPath; });
+    SerializeCount(Ar, NumPendingEvents);
+    Ar.Serialize(PendingEvents.GetData(), PendingEvents.Num());
+
+    // The player states are only needed once; don't keep them for the rest of the capture.
+    for (FQuestCapturedPlayer& Player : Players.Values)
+    {
+        Player.InitialState.Empty();
+    }
+
+    uint32 ChunkSize = Chunk.Num();
+    *FileWriter << ChunkSize;
+    FileWriter->Serialize(Chunk.GetData(), Chunk.Num());
+    FileWriter->Flush();
+    NumBytesWritten = FileWriter->Tell();
+
+    PendingEvents.Reset();
+    NumPendingEvents = 0;
+}
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestEventIngress.h"
+
+FQuestEventIngressQueue::FQuestEventIngressQueue(int32 InCapacity)
+{
+    const uint64 Capacity = FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max(InCapacity, 2)));
+    Mask = Capacity - 1;
+    Cells = MakeUnique<FCell[]>(Capacity);
+
+    // A cell is free for the producer at position P when its sequence is P.
+    for (uint64 Index = 0; Index < Capacity; ++Index)
+    {
+        Cells[Index].Sequence.store(Index, std::memory_order_relaxed);
+    }
+}
+
+bool FQuestEventIngressQueue::Enqueue(const FQuestIngressEvent& Event)
+{
+    uint64 Pos = EnqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        FCell& Cell = Cells[Pos & Mask];
+        const uint64 Sequence = Cell.Sequence.load(std::memory_order_acquire);
+        const int64 Difference = static_cast<int64>(Sequence) - static_cast<int64>(Pos);
+
+        if (Difference == 0)
+        {
+            // The cell is free: claim the position. On failure Pos is reloaded and we try again.
+            if (EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed))
+            {
+                Cell.Event = Event;
+                // Publish: the consumer expects Pos + 1 once the cell is filled.
+                Cell.Sequence.store(Pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (Difference < 0)
+        {
+            // The consumer hasn't freed this cell from the previous lap yet: the queue is full.
+            NumDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            // Another producer took the position first.
+            Pos = EnqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool FQuestEventIngressQueue::Dequeue(FQuestIngressEvent& OutEvent)
+{
+    FCell& Cell = Cells[DequeuePos & Mask];
+    if (Cell.Sequence.load(std::memory_order_acquire) != DequeuePos + 1)
+    {
+        // Empty, or the producer that claimed this cell hasn't finished writing it.
+        return false;
+    }
+
+    OutEvent = MoveTemp(Cell.Event);
+    Cell.Event = FQuestIngressEvent();
+
+    // Hand the cell to the producer one lap ahead.
+    Cell.Sequence.store(DequeuePos + Mask + 1, std::memory_order_release);
+    ++DequeuePos;
+    return true;
+}
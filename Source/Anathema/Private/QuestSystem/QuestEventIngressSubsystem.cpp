@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestEventIngressSubsystem.h"
+#include "QuestSystem/QuestProgressSubsystem.h"
+#include "QuestSystem/QuestEventRecorderSubsystem.h"
+#include "QuestSystem/QuestStats.h"
+#include "QuestManagerComponent.h"
+#include "Engine/World.h"
+
+bool UQuestEventIngressSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    const UWorld* World = Cast<UWorld>(Outer);
+    return Super::ShouldCreateSubsystem(Outer) && World && World->IsGameWorld() && !IsRunningClientOnly();
+}
+
+void UQuestEventIngressSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    LLM_SCOPE_BYTAG(Quests_EventQueues);
+
+    Super::Initialize(Collection);
+
+    Queue = MakeShared<FQuestEventIngressQueue, ESPMode::ThreadSafe>(QueueCapacity);
+    PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UQuestEventIngressSubsystem::OnWorldPreActorTick);
+}
+
+void UQuestEventIngressSubsystem::Deinitialize()
+{
+    FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+
+    // Producers may still hold the queue; whatever they post from now on is never drained.
+    Super::Deinitialize();
+}
+
+void UQuestEventIngressSubsystem::OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+    if (InWorld == GetWorld())
+    {
+        QuestStats::FScopedGameThreadCycles CycleScope;
+        DrainEvents();
+    }
+}
+
+void UQuestEventIngressSubsystem::DrainEvents()
+{
+    check(IsInGameThread());
+    SCOPE_CYCLE_COUNTER(STAT_Quest_DrainIngress);
+
+    UQuestProgressSubsystem* Progress = GetWorld()->GetSubsystem<UQuestProgressSubsystem>();
+
+    // A replayed capture brings its own ingress events; anything posted meanwhile is drained and dropped.
+    const bool bReplayingCapture = UQuestEventRecorderSubsystem::IsReplayingCapture(GetWorld());
+
+    // Bounded by the capacity, so producers that keep posting can't hold the game thread here forever;
+    // anything beyond that is picked up next frame.
+    FQuestIngressEvent Event;
+    for (int32 NumDrained = 0; NumDrained < Queue->GetCapacity() && Queue->Dequeue(Event); ++NumDrained)
+    {
+        if (bReplayingCapture)
+        {
+            continue;
+        }
+
+        FObjectiveEventData E;
+        E.EventTag = Event.EventTag;
+        E.ResponsiblePlayerController = Event.ResponsiblePlayerController.Get();
+        E.TriggeringActor = Event.TriggeringActor.Get();
+        E.Count = Event.Count;
+        E.Payload = MoveTemp(Event.Payload);
+
+        if (!Event.QuestManager.IsExplicitlyNull())
+        {
+            // Targeted at a player that may have left in the meantime.
+            if (UQuestManagerComponent* QuestManager = Event.QuestManager.Get())
+            {
+                QuestManager->NotifyEvent(E);
+            }
+        }
+        else if (Progress)
+        {
+            Progress->ProcessEventForAllPlayers(E);
+        }
+    }
+
+    if (const int32 NumDropped = Queue->ConsumeNumDropped())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("QuestEventIngressSubsystem: Dropped %d quest events because the ingress queue was full (QueueCapacity = %d)."), NumDropped, Queue->GetCapacity());
+    }
+}
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestEventPayload.h"
+#include "UObject/Class.h"
+
+void FQuestEventPayload::SetStruct(const UScriptStruct* InType, const void* Data)
+{
+    Reset();
+    if (!InType || !Data)
+    {
+        return;
+    }
+
+    Type = InType;
+    const bool bIsPlainOldData = (InType->StructFlags & STRUCT_IsPlainOldData) != 0;
+    if (bIsPlainOldData && InType->GetStructureSize() <= InlineSize && InType->GetMinAlignment() <= InlineAlignment)
+    {
+        FMemory::Memcpy(InlineData, Data, InType->GetStructureSize());
+        return;
+    }
+
+    void* Value = FMemory::Malloc(InType->GetStructureSize(), InType->GetMinAlignment());
+    InType->InitializeStruct(Value);
+    InType->CopyScriptStruct(Value, Data);
+    HeapData = TSharedPtr<const void, ESPMode::ThreadSafe>(Value, [InType](void* ValueToFree)
+    {
+        InType->DestroyStruct(ValueToFree);
+        FMemory::Free(ValueToFree);
+    });
+}
@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestEventRecorderSubsystem.h"
+#include "QuestSystem/QuestNode.h"
+#include "QuestSystem/QuestSaveData.h"
+#include "QuestManagerComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+
+bool UQuestEventRecorderSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    const UWorld* World = Cast<UWorld>(Outer);
+    return Super::ShouldCreateSubsystem(Outer) && World && World->IsGameWorld() && !IsRunningClientOnly();
+}
+
+void UQuestEventRecorderSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    FString CaptureName;
+    if (FParse::Value(FCommandLine::Get(), TEXT("QuestCapture="), CaptureName))
+    {
+        StartRecording(CaptureName);
+    }
+}
+
+void UQuestEventRecorderSubsystem::Deinitialize()
+{
+    StopRecording();
+
+    Super::Deinitialize();
+}
+
+bool UQuestEventRecorderSubsystem::StartRecording(const FString& CaptureName)
+{
+    StopRecording();
+
+    CapturePath = FPaths::ProjectSavedDir() / TEXT("QuestCaptures") / (CaptureName.IsEmpty() ? FDateTime::Now().ToString() : CaptureName) + TEXT(".qcap");
+    Writer = MakeUnique<FQuestEventCaptureWriter>();
+    if (!Writer->Open(CapturePath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("QuestEventRecorder: could not create '%s'."), *CapturePath);
+        Writer.Reset();
+        return false;
+    }
+
+    StartTime = FPlatformTime::Seconds();
+    StartUtc = FDateTime::UtcNow();
+    StartFrame = GFrameCounter;
+    UE_LOG(LogTemp, Display, TEXT("QuestEventRecorder: recording quest events to '%s'."), *CapturePath);
+    return true;
+}
+
+void UQuestEventRecorderSubsystem::StopRecording()
+{
+    if (!Writer)
+    {
+        return;
+    }
+
+    Writer->Close();
+    UE_LOG(LogTemp, Display, TEXT("QuestEventRecorder: recorded %lld events (%.1f KB) to '%s'."), Writer->GetNumEvents(), Writer->GetNumBytesWritten() / 1024.0, *CapturePath);
+    Writer.Reset();
+}
+
+FQuestCapturedEvent UQuestEventRecorderSubsystem::MakeRecord(EQuestCapturedEventKind Kind, const FObjectiveEventData* E)
+{
+    FQuestCapturedEvent Record;
+    Record.Kind = Kind;
+    Record.Time = FPlatformTime::Seconds() - StartTime;
+    Record.Frame = GFrameCounter - StartFrame;
+    if (E)
+    {
+        Record.EventTag = E->EventTag;
+        Record.TriggeringActor = Writer->FindOrAddActor(E->TriggeringActor);
+        Record.ResponsiblePlayerController = Writer->FindOrAddActor(E->ResponsiblePlayerController);
+        Record.Count = E->Count;
+        Record.Payload = E->Payload;
+    }
+    return Record;
+}
+
+int32 UQuestEventRecorderSubsystem::GetPlayerIndex(const UQuestManagerComponent* QuestManager)
+{
+    const FString Name = QuestManager->PersistenceId.IsEmpty() ? GetNameSafe(QuestManager->GetOwner()) : QuestManager->PersistenceId;
+    return Writer->FindOrAddPlayer(FObjectKey(QuestManager), Name, [this, QuestManager](TArray<uint8>& OutState)
+    {
+        FQuestSaveSnapshot Snapshot;
+        QuestManager->CaptureSaveSnapshot(Snapshot);
+
+        // Deadlines become relative to the capture start (at least one tick, 0 means none), so a replay can rebase
+        // them onto its own clock instead of finding them all long expired.
+        for (FQuestSaveRecord& Record : Snapshot.ActiveQuests)
+        {
+            for (int64& Deadline : Record.ObjectiveDeadlines)
+            {
+                if (Deadline > 0)
+                {
+                    Deadline = FMath::Max<int64>(Deadline - StartUtc.GetTicks(), 1);
+                }
+            }
+        }
+        Snapshot.WriteTo(OutState);
+    });
+}
+
+void UQuestEventRecorderSubsystem::RecordEvent(const UQuestManagerComponent* QuestManager, const FObjectiveEventData& E, bool bQueued)
+{
+    FQuestCapturedEvent Record = MakeRecord(bQueued ? EQuestCapturedEventKind::QueuedEvent : EQuestCapturedEventKind::Event, &E);
+    Record.Player = GetPlayerIndex(QuestManager);
+    Writer->AddEvent(Record);
+}
+
+void UQuestEventRecorderSubsystem::RecordGroupEvent(TConstArrayView<UQuestManagerComponent*> QuestManagers, const FObjectiveEventData& E)
+{
+    FQuestCapturedEvent Record = MakeRecord(EQuestCapturedEventKind::GroupEvent, &E);
+    for (const UQuestManagerComponent* QuestManager : QuestManagers)
+    {
+        if (IsValid(QuestManager))
+        {
+            Record.GroupPlayers.Add(GetPlayerIndex(QuestManager));
+        }
+    }
+    Writer->AddEvent(Record);
+}
+
+void UQuestEventRecorderSubsystem::RecordWorldEvent(const FObjectiveEventData& E)
+{
+    Writer->AddEvent(MakeRecord(EQuestCapturedEventKind::WorldEvent, &E));
+}
+
+void UQuestEventRecorderSubsystem::RecordQuestAdded(const UQuestManagerComponent* QuestManager, const UQuestNode* Quest)
+{
+    FQuestCapturedEvent Record = MakeRecord(EQuestCapturedEventKind::QuestAdded, nullptr);
+    Record.Player = GetPlayerIndex(QuestManager);
+    Record.Quest = FSoftObjectPath(Quest);
+    Writer->AddEvent(Record);
+}
+
+bool UQuestEventRecorderSubsystem::IsReplayingCapture(const UWorld* World)
+{
+    const UQuestEventRecorderSubsystem* Recorder = World ? World->GetSubsystem<UQuestEventRecorderSubsystem>() : nullptr;
+    return Recorder && Recorder->bReplayingCapture;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs QuestCaptureStartCommand(
+    TEXT("Quest.Capture.Start"),
+    TEXT("Starts recording quest events to Saved/QuestCaptures/<Name>.qcap. Usage: Quest.Capture.Start [Name]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        if (UQuestEventRecorderSubsystem* Recorder = World ? World->GetSubsystem<UQuestEventRecorderSubsystem>() : nullptr)
+        {
+            Recorder->StartRecording(Args.Num() > 0 ? Args[0] : FString());
+        }
+    }));
+
+static FAutoConsoleCommandWithWorldAndArgs QuestCaptureStopCommand(
+    TEXT("Quest.Capture.Stop"),
+    TEXT("Stops recording quest events."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        if (UQuestEventRecorderSubsystem* Recorder = World ? World->GetSubsystem<UQuestEventRecorderSubsystem>() : nullptr)
+        {
+            Recorder->StopRecording();
+        }
+    }));
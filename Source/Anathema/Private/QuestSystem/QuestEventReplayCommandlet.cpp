@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestEventReplayCommandlet.h"
+#include "QuestSystem/QuestEventCapture.h"
+#include "QuestSystem/QuestEventReplayer.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/PlatformProcess.h"
+
+UQuestEventReplayCommandlet::UQuestEventReplayCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = true;
+    LogToConsole = true;
+}
+
+int32 UQuestEventReplayCommandlet::Main(const FString& Params)
+{
+    FString CapturePath;
+    if (!FParse::Value(*Params, TEXT("Capture="), CapturePath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("QuestEventReplay: missing -Capture=<path>."));
+        return 1;
+    }
+    const bool bPaced = FParse::Param(*Params, TEXT("Paced"));
+    const bool bSpawnActorStandIns = FParse::Param(*Params, TEXT("StandIns"));
+    int32 NumWorstFrames = 10;
+    FParse::Value(*Params, TEXT("WorstFrames="), NumWorstFrames);
+
+    FQuestEventCapture Capture;
+    if (!Capture.LoadFromFile(CapturePath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("QuestEventReplay: could not read capture '%s'."), *CapturePath);
+        return 1;
+    }
+    UE_LOG(LogTemp, Display, TEXT("QuestEventReplay: '%s': %d records, %d players, %d actors."), *CapturePath, Capture.Events.Num(), Capture.Players.Num(), Capture.Actors.Num());
+
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("QuestEventReplayWorld"));
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+    World->InitializeActorsForPlay(FURL());
+    World->BeginPlay();
+
+    // The world is ticked between captured frames with the recorded time step, so queued events, timers and
+    // periodic checks run as they did in the original session.
+    FQuestEventReplayer Replayer(World, Capture, bSpawnActorStandIns);
+    const double StartTime = FPlatformTime::Seconds();
+    double PreviousFrameTime = 0.0;
+    while (Replayer.HasMoreFrames())
+    {
+        const double FrameTime = Replayer.GetNextFrameTime();
+        if (bPaced)
+        {
+            const double WaitSeconds = StartTime + FrameTime - FPlatformTime::Seconds();
+            if (WaitSeconds > 0.0)
+            {
+                FPlatformProcess::Sleep(static_cast<float>(WaitSeconds));
+            }
+        }
+
+        World->Tick(LEVELTICK_All, static_cast<float>(FMath::Max(FrameTime - PreviousFrameTime, 0.0)));
+        Replayer.ReplayNextFrame();
+        PreviousFrameTime = FrameTime;
+    }
+    const double WallSeconds = FPlatformTime::Seconds() - StartTime;
+
+    TArray<FQuestEventReplayer::FFrameResult> Frames = Replayer.GetFrameResults();
+    Frames.Sort([](const FQuestEventReplayer::FFrameResult& A, const FQuestEventReplayer::FFrameResult& B) { return A.Cycles > B.Cycles; });
+    uint64 TotalCycles = 0;
+    for (const FQuestEventReplayer::FFrameResult& Frame : Frames)
+    {
+        TotalCycles += Frame.Cycles;
+    }
+    auto FrameMs = [&Frames](double Fraction)
+    {
+        // Frames are sorted slowest first.
+        const int32 Index = FMath::Clamp(FMath::FloorToInt32((1.0 - Fraction) * Frames.Num()), 0, Frames.Num() - 1);
+        return Frames.Num() > 0 ? FPlatformTime::ToMilliseconds64(Frames[Index].Cycles) : 0.0;
+    };
+
+    UE_LOG(LogTemp, Display, TEXT("QuestEventReplay: %d frames in %.2f s (recorded: %.2f s), quest time %.2f ms total, %.0f records/s."),
+        Frames.Num(), WallSeconds, PreviousFrameTime, FPlatformTime::ToMilliseconds64(TotalCycles),
+        TotalCycles > 0 ? Capture.Events.Num() / FPlatformTime::ToSeconds64(TotalCycles) : 0.0);
+    UE_LOG(LogTemp, Display, TEXT("QuestEventReplay: per frame p50 %.3f ms, p99 %.3f ms, max %.3f ms."), FrameMs(0.5), FrameMs(0.99), FrameMs(1.0));
+    for (int32 Index = 0; Index < FMath::Min(NumWorstFrames, Frames.Num()); ++Index)
+    {
+        const FQuestEventReplayer::FFrameResult& Frame = Frames[Index];
+        UE_LOG(LogTemp, Display, TEXT("  frame %llu at %.3f s: %d records, %.3f ms"), Frame.Frame, Frame.Time, Frame.NumRecords, FPlatformTime::ToMilliseconds64(Frame.Cycles));
+    }
+
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+    return 0;
+}
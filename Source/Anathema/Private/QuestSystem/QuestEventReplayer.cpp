@@ -0,0 +1,193 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestEventReplayer.h"
+#include "QuestSystem/QuestNode.h"
+#include "QuestSystem/QuestSaveData.h"
+#include "QuestSystem/QuestProgressSubsystem.h"
+#include "QuestSystem/QuestEventRecorderSubsystem.h"
+#include "QuestManagerComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Engine/World.h"
+
+FQuestEventReplayer::FQuestEventReplayer(UWorld* InWorld, const FQuestEventCapture& InCapture, bool bInSpawnActorStandIns)
+    : World(InWorld)
+    , Capture(InCapture)
+    , bSpawnActorStandIns(bInSpawnActorStandIns)
+    , StartUtcTicks(FDateTime::UtcNow().GetTicks())
+{
+    QuestManagers.SetNum(Capture.Players.Num());
+    Actors.SetNum(Capture.Actors.Num());
+    ActorsResolved.Init(false, Capture.Actors.Num());
+
+    if (UQuestEventRecorderSubsystem* Recorder = World->GetSubsystem<UQuestEventRecorderSubsystem>())
+    {
+        Recorder->SetReplayingCapture(true);
+    }
+}
+
+FQuestEventReplayer::~FQuestEventReplayer()
+{
+    if (UQuestEventRecorderSubsystem* Recorder = World ? World->GetSubsystem<UQuestEventRecorderSubsystem>() : nullptr)
+    {
+        Recorder->SetReplayingCapture(false);
+    }
+}
+
+UQuestManagerComponent* FQuestEventReplayer::GetQuestManager(int32 PlayerIndex)
+{
+    if (!QuestManagers.IsValidIndex(PlayerIndex))
+    {
+        return nullptr;
+    }
+    if (UQuestManagerComponent* QuestManager = QuestManagers[PlayerIndex].Get())
+    {
+        return QuestManager;
+    }
+
+    const FQuestCapturedPlayer& Player = Capture.Players[PlayerIndex];
+    APlayerState* PlayerState = World->SpawnActor<APlayerState>();
+    PlayerState->SetPlayerName(Player.Name);
+    UQuestManagerComponent* QuestManager = NewObject<UQuestManagerComponent>(PlayerState, TEXT("QuestManager"));
+    QuestManager->RegisterComponent();
+
+    FQuestSaveSnapshot Snapshot;
+    if (Player.InitialState.Num() > 0 && Snapshot.ReadFrom(Player.InitialState))
+    {
+        // Version 1 captures hold the recording's UTC deadlines, which can only be restored as they are.
+        if (Capture.Version >= 2)
+        {
+            for (FQuestSaveRecord& Record : Snapshot.ActiveQuests)
+            {
+                for (int64& Deadline : Record.ObjectiveDeadlines)
+                {
+                    if (Deadline > 0)
+                    {
+                        Deadline += StartUtcTicks;
+                    }
+                }
+            }
+        }
+        QuestManager->RestoreSaveSnapshot(Snapshot);
+    }
+
+    QuestManagers[PlayerIndex] = QuestManager;
+    return QuestManager;
+}
+
+AActor* FQuestEventReplayer::GetActor(int32 ActorIndex)
+{
+    if (!bSpawnActorStandIns || !Actors.IsValidIndex(ActorIndex))
+    {
+        return nullptr;
+    }
+    if (!ActorsResolved[ActorIndex])
+    {
+        ActorsResolved[ActorIndex] = true;
+        UClass* ActorClass = Capture.Actors[ActorIndex].Class.TryLoadClass<AActor>();
+        if (ActorClass)
+        {
+            FActorSpawnParameters SpawnParameters;
+            SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+            Actors[ActorIndex] = World->SpawnActor<AActor>(ActorClass, FTransform::Identity, SpawnParameters);
+        }
+    }
+    return Actors[ActorIndex].Get();
+}
+
+FQuestEventReplayer::FFrameResult FQuestEventReplayer::ReplayNextFrame()
+{
+    FFrameResult Result;
+    if (!HasMoreFrames())
+    {
+        return Result;
+    }
+
+    Result.Frame = Capture.Events[NextRecord].Frame;
+    Result.Time = Capture.Events[NextRecord].Time;
+
+    // Players and stand-ins are created outside the timed section: they're replay setup, not quest work.
+    for (int32 Index = NextRecord; Index < Capture.Events.Num() && Capture.Events[Index].Frame == Result.Frame; ++Index)
+    {
+        const FQuestCapturedEvent& Record = Capture.Events[Index];
+        GetQuestManager(Record.Player);
+        for (const int32 GroupPlayer : Record.GroupPlayers)
+        {
+            GetQuestManager(GroupPlayer);
+        }
+        GetActor(Record.TriggeringActor);
+        GetActor(Record.ResponsiblePlayerController);
+    }
+
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+    for (; NextRecord < Capture.Events.Num() && Capture.Events[NextRecord].Frame == Result.Frame; ++NextRecord)
+    {
+        ReplayRecord(Capture.Events[NextRecord]);
+        ++Result.NumRecords;
+    }
+    Result.Cycles = FPlatformTime::Cycles64() - StartCycles;
+
+    FrameResults.Add(Result);
+    return Result;
+}
+
+void FQuestEventReplayer::ReplayRecord(const FQuestCapturedEvent& Record)
+{
+    if (Record.Kind == EQuestCapturedEventKind::QuestAdded)
+    {
+        UQuestManagerComponent* QuestManager = GetQuestManager(Record.Player);
+        UQuestNode* Quest = Cast<UQuestNode>(Record.Quest.TryLoad());
+        if (QuestManager && Quest)
+        {
+            QuestManager->AddQuest(Quest);
+        }
+        return;
+    }
+
+    FObjectiveEventData E(Record.EventTag, Cast<APlayerController>(GetActor(Record.ResponsiblePlayerController)), GetActor(Record.TriggeringActor));
+    E.Count = Record.Count;
+    E.Payload = Record.Payload;
+
+    switch (Record.Kind)
+    {
+    case EQuestCapturedEventKind::Event:
+        if (UQuestManagerComponent* QuestManager = GetQuestManager(Record.Player))
+        {
+            QuestManager->NotifyEvent(E);
+        }
+        break;
+
+    case EQuestCapturedEventKind::QueuedEvent:
+        if (UQuestManagerComponent* QuestManager = GetQuestManager(Record.Player))
+        {
+            QuestManager->QueueEvent(E);
+        }
+        break;
+
+    case EQuestCapturedEventKind::GroupEvent:
+        if (UQuestProgressSubsystem* ProgressSubsystem = World->GetSubsystem<UQuestProgressSubsystem>())
+        {
+            TArray<UQuestManagerComponent*> GroupManagers;
+            for (const int32 GroupPlayer : Record.GroupPlayers)
+            {
+                if (UQuestManagerComponent* QuestManager = GetQuestManager(GroupPlayer))
+                {
+                    GroupManagers.Add(QuestManager);
+                }
+            }
+            ProgressSubsystem->ProcessEventForPlayers(E, GroupManagers);
+        }
+        break;
+
+    case EQuestCapturedEventKind::WorldEvent:
+        if (UQuestProgressSubsystem* ProgressSubsystem = World->GetSubsystem<UQuestProgressSubsystem>())
+        {
+            ProgressSubsystem->ProcessEventForAllPlayers(E);
+        }
+        break;
+
+    default:
+        break;
+    }
+}
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestEventTags.h"
+#include "QuestSystem/QuestStats.h"
+
+FQuestEventTags& FQuestEventTags::Get()
+{
+    static FQuestEventTags Instance;
+    return Instance;
+}
+
+int32 FQuestEventTags::RegisterTag(FName Tag)
+{
+    if (const int32* ExistingIndex = TagIndices.Find(Tag))
+    {
+        return *ExistingIndex;
+    }
+    check(IsInGameThread());
+    LLM_SCOPE_BYTAG(Quests_Definitions);
+
+    // Register the parent first, so every ancestor has a lower index than its descendants.
+    const FString TagString = Tag.ToString();
+    int32 ParentIndex = INDEX_NONE;
+    int32 LastDot = INDEX_NONE;
+    if (TagString.FindLastChar(TEXT('.'), LastDot) && LastDot > 0)
+    {
+        ParentIndex = RegisterTag(FName(TagString.Left(LastDot)));
+    }
+
+    const int32 TagIndex = Tags.AddDefaulted();
+    FTag& NewTag = Tags[TagIndex];
+    NewTag.Name = Tag;
+    NewTag.SelfAndAncestors.Add(TagIndex);
+    NewTag.AncestorMask.Init(false, TagIndex + 1);
+    NewTag.AncestorMask[TagIndex] = true;
+    if (ParentIndex != INDEX_NONE)
+    {
+        const FTag& Parent = Tags[ParentIndex];
+        NewTag.SelfAndAncestors.Append(Parent.SelfAndAncestors);
+        for (const int32 AncestorIndex : Parent.SelfAndAncestors)
+        {
+            NewTag.AncestorMask[AncestorIndex] = true;
+        }
+    }
+
+    TagIndices.Add(Tag, TagIndex);
+    return TagIndex;
+}
+
+int32 FQuestEventTags::FindTag(FName Tag) const
+{
+    const int32* TagIndex = TagIndices.Find(Tag);
+    return TagIndex ? *TagIndex : INDEX_NONE;
+}
+
+bool FQuestEventTags::Matches(int32 EventTagIndex, int32 SubscribedTagIndex) const
+{
+    const TBitArray<>& Mask = Tags[EventTagIndex].AncestorMask;
+    return Mask.IsValidIndex(SubscribedTagIndex) && Mask[SubscribedTagIndex];
+}
+
+bool FQuestEventTags::MasksIntersect(const TBitArray<>& A, const TBitArray<>& B)
+{
+    const int32 NumBits = FMath::Min(A.Num(), B.Num());
+    const uint32* WordsA = A.GetData();
+    const uint32* WordsB = B.GetData();
+
+    const int32 NumFullWords = NumBits / NumBitsPerDWORD;
+    for (int32 Word = 0; Word < NumFullWords; ++Word)
+    {
+        if (WordsA[Word] & WordsB[Word])
+        {
+            return true;
+        }
+    }
+
+    // Only the bits both masks actually have count in the last, partial word.
+    const int32 NumRemainingBits = NumBits % NumBitsPerDWORD;
+    if (NumRemainingBits > 0)
+    {
+        const uint32 RemainingMask = (1u << NumRemainingBits) - 1;
+        return (WordsA[NumFullWords] & WordsB[NumFullWords] & RemainingMask) != 0;
+    }
+    return false;
+}
+
+void FQuestEventTags::AddToMask(TBitArray<>& Mask, int32 TagIndex)
+{
+    if (Mask.Num() <= TagIndex)
+    {
+        Mask.Add(false, TagIndex + 1 - Mask.Num());
+    }
+    Mask[TagIndex] = true;
+}
+
+void FQuestEventTags::GetEffectiveSubscriptions(TConstArrayView<FName> SubscribedTags, TArray<int32, TInlineAllocator<4>>& OutTagIndices)
+{
+    TBitArray<> SubscribedMask;
+    for (const FName& Tag : SubscribedTags)
+    {
+        AddToMask(SubscribedMask, RegisterTag(Tag));
+    }
+
+    for (const FName& Tag : SubscribedTags)
+    {
+        // Skip tags with a subscribed ancestor: events for them already arrive through the ancestor.
+        const TConstArrayView<int32> SelfAndAncestors = GetSelfAndAncestors(FindTag(Tag));
+        bool bCovered = false;
+        for (int32 Index = 1; Index < SelfAndAncestors.Num() && !bCovered; ++Index)
+        {
+            bCovered = SubscribedMask[SelfAndAncestors[Index]];
+        }
+        if (!bCovered)
+        {
+            OutTagIndices.AddUnique(SelfAndAncestors[0]);
+        }
+    }
+}
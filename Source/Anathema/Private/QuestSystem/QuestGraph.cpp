@@ -0,0 +1,207 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestGraph.h"
+#include "QuestSystem/QuestNode.h"
+#include "QuestSystem/Objective.h"
+
+void FQuestGraph::AddQuests(TConstArrayView<UQuestNode*> RootQuests)
+{
+    // Collect every quest reachable from the roots that hasn't been compiled yet.
+    TArray<UQuestNode*> NewQuests;
+    TSet<UQuestNode*> Visited;
+    TArray<UQuestNode*> Stack(RootQuests);
+    while (Stack.Num() > 0)
+    {
+        UQuestNode* Quest = Stack.Pop(EAllowShrinking::No);
+        if (!IsValid(Quest) || Quest->QuestId != INDEX_NONE)
+        {
+            continue;
+        }
+
+        bool bAlreadyVisited = false;
+        Visited.Add(Quest, &bAlreadyVisited);
+        if (bAlreadyVisited)
+        {
+            continue;
+        }
+
+        NewQuests.Add(Quest);
+        Stack.Append(Quest->PrerequisiteQuests);
+        Stack.Append(Quest->FollowUpQuests);
+    }
+
+    if (NewQuests.IsEmpty())
+    {
+        return;
+    }
+
+    // Kahn's algorithm over the new quests. Prerequisites that were compiled in an earlier batch
+    // already have smaller IDs, so only edges between new quests matter for the ordering.
+    TMap<UQuestNode*, int32> PendingPrerequisites;
+    TMap<UQuestNode*, TArray<UQuestNode*>> NewFollowUps;
+    for (UQuestNode* Quest : NewQuests)
+    {
+        int32& Pending = PendingPrerequisites.Add(Quest, 0);
+        for (UQuestNode* Prerequisite : Quest->PrerequisiteQuests)
+        {
+            if (Visited.Contains(Prerequisite))
+            {
+                ++Pending;
+                NewFollowUps.FindOrAdd(Prerequisite).Add(Quest);
+            }
+        }
+    }
+
+    TArray<UQuestNode*> Ready;
+    for (UQuestNode* Quest : NewQuests)
+    {
+        if (PendingPrerequisites[Quest] == 0)
+        {
+            Ready.Add(Quest);
+        }
+    }
+
+    const int32 FirstNewId = Quests.Num();
+    for (int32 ReadyIndex = 0; ReadyIndex < Ready.Num(); ++ReadyIndex)
+    {
+        UQuestNode* Quest = Ready[ReadyIndex];
+        Quest->QuestId = Quests.Add(Quest);
+        QuestPaths.Emplace(Quest);
+
+        if (const TArray<UQuestNode*>* FollowUpsOfQuest = NewFollowUps.Find(Quest))
+        {
+            for (UQuestNode* FollowUp : *FollowUpsOfQuest)
+            {
+                if (--PendingPrerequisites[FollowUp] == 0)
+                {
+                    Ready.Add(FollowUp);
+                }
+            }
+        }
+    }
+
+    // Anything left over is part of a prerequisite cycle. Those quests can never become available,
+    // but they still get IDs so lookups keep working.
+    if (Quests.Num() - FirstNewId < NewQuests.Num())
+    {
+        for (UQuestNode* Quest : NewQuests)
+        {
+            if (Quest->QuestId == INDEX_NONE)
+            {
+                UE_LOG(LogTemp, Error, TEXT("FQuestGraph: Quest '%s' is part of a prerequisite cycle and can never become available."), *Quest->QuestName.ToString());
+                Quest->QuestId = Quests.Add(Quest);
+                QuestPaths.Emplace(Quest);
+            }
+        }
+    }
+
+    AppendEdges(FirstNewId);
+
+    for (int32 QuestId = FirstNewId; QuestId < Quests.Num(); ++QuestId)
+    {
+        for (UObjective* Objective : Quests[QuestId]->Objectives)
+        {
+            if (Objective)
+            {
+                Objective->UpdateHandledTagMask();
+            }
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("FQuestGraph: Compiled %d new quests (%d total, %d prerequisite edges)."), Quests.Num() - FirstNewId, Quests.Num(), Prerequisites.Num());
+}
+
+void FQuestGraph::RemoveQuestsFrom(int32 FirstQuestId)
+{
+    const int32 NumQuests = Quests.Num();
+    if (FirstQuestId >= NumQuests)
+    {
+        return;
+    }
+
+    bool bFollowsEarlierQuests = false;
+    for (int32 QuestId = FirstQuestId; QuestId < NumQuests; ++QuestId)
+    {
+        for (const int32 PrerequisiteId : GetPrerequisites(QuestId))
+        {
+            bFollowsEarlierQuests |= PrerequisiteId < FirstQuestId;
+        }
+        if (UQuestNode* Quest = Quests[QuestId])
+        {
+            Quest->QuestId = INDEX_NONE;
+        }
+    }
+
+    Quests.SetNum(FirstQuestId);
+    QuestPaths.SetNum(FirstQuestId);
+    Prerequisites.SetNum(PrerequisiteOffsets[FirstQuestId]);
+    PrerequisiteOffsets.SetNum(FirstQuestId + 1);
+
+    // Removed quests that follow up a remaining one are in that quest's follow-up row.
+    BuildFollowUps(bFollowsEarlierQuests ? 0 : FirstQuestId);
+
+    UE_LOG(LogTemp, Log, TEXT("FQuestGraph: Removed %d quests (%d left)."), NumQuests - FirstQuestId, Quests.Num());
+}
+
+void FQuestGraph::AppendEdges(int32 FirstQuestId)
+{
+    const int32 NumQuests = Quests.Num();
+
+    // Prerequisites: the new rows go after the existing ones, in ID order.
+    if (PrerequisiteOffsets.IsEmpty())
+    {
+        PrerequisiteOffsets.Add(0);
+    }
+    bool bFollowsEarlierQuests = false;
+    for (int32 QuestId = FirstQuestId; QuestId < NumQuests; ++QuestId)
+    {
+        for (const UQuestNode* Prerequisite : Quests[QuestId]->PrerequisiteQuests)
+        {
+            if (IsValid(Prerequisite) && Prerequisite->QuestId != INDEX_NONE)
+            {
+                Prerequisites.Add(Prerequisite->QuestId);
+                bFollowsEarlierQuests |= Prerequisite->QuestId < FirstQuestId;
+            }
+        }
+        PrerequisiteOffsets.Add(Prerequisites.Num());
+    }
+
+    // A new quest that follows up an earlier one goes into that quest's follow-up row, which can't grow in place.
+    // Batches are whole connected quest lines, so that only happens if a quest gained a prerequisite after it was
+    // compiled; otherwise the new rows are appended as well, and adding a batch doesn't touch the rest of the graph.
+    BuildFollowUps(bFollowsEarlierQuests ? 0 : FirstQuestId);
+}
+
+void FQuestGraph::BuildFollowUps(int32 FirstQuestId)
+{
+    const int32 NumQuests = Quests.Num();
+
+    // Follow-ups are the reverse edges: count, prefix-sum the counts, then scatter.
+    TArray<int32> FollowUpCounts;
+    FollowUpCounts.SetNumZeroed(NumQuests - FirstQuestId);
+    for (int32 QuestId = FirstQuestId; QuestId < NumQuests; ++QuestId)
+    {
+        for (const int32 PrerequisiteId : GetPrerequisites(QuestId))
+        {
+            ++FollowUpCounts[PrerequisiteId - FirstQuestId];
+        }
+    }
+
+    FollowUpOffsets.SetNum(FirstQuestId + 1);
+    FollowUpOffsets[0] = 0;
+    for (int32 QuestId = FirstQuestId; QuestId < NumQuests; ++QuestId)
+    {
+        FollowUpOffsets.Add(FollowUpOffsets[QuestId] + FollowUpCounts[QuestId - FirstQuestId]);
+    }
+
+    FollowUps.SetNumUninitialized(FollowUpOffsets[NumQuests]);
+    TArray<int32> WritePositions(FollowUpOffsets.GetData() + FirstQuestId, NumQuests - FirstQuestId);
+    for (int32 QuestId = FirstQuestId; QuestId < NumQuests; ++QuestId)
+    {
+        for (const int32 PrerequisiteId : GetPrerequisites(QuestId))
+        {
+            FollowUps[WritePositions[PrerequisiteId - FirstQuestId]++] = QuestId;
+        }
+    }
+}
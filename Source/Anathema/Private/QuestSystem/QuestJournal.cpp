@@ -0,0 +1,490 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestJournal.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Crc.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+namespace
+{
+    constexpr uint32 SnapshotFileMagic = 0x4E534A51; // "QJSN"
+    constexpr uint32 PlayerFileMagic = 0x4C504A51; // "QJPL"
+
+    // Upper bound for a single record; anything larger is treated as corruption. A PlayerSnapshot record holds a
+    // whole player's state, hence the headroom.
+    constexpr uint32 MaxRecordSize = 1024 * 1024;
+
+    void SerializeRecordPayload(FArchive& Ar, FQuestJournalRecord& Record)
+    {
+        uint8 Op = static_cast<uint8>(Record.Op);
+        FString QuestPath = Record.Quest.ToString();
+        uint32 ObjectiveIndex = static_cast<uint32>(FMath::Max(Record.ObjectiveIndex, 0));
+        Ar << Op;
+        Ar << Record.PlayerId;
+        Ar << QuestPath;
+        Ar.SerializeIntPacked(ObjectiveIndex);
+        Ar << Record.Value;
+        if (static_cast<EQuestJournalOp>(Op) == EQuestJournalOp::PlayerSnapshot)
+        {
+            Ar << Record.Data;
+        }
+
+        if (Ar.IsLoading())
+        {
+            Record.Op = static_cast<EQuestJournalOp>(Op);
+            Record.Quest = FSoftObjectPath(QuestPath);
+            Record.ObjectiveIndex = static_cast<int32>(FMath::Min<uint32>(ObjectiveIndex, MAX_uint8));
+        }
+    }
+
+    // Writes a file through a temporary file, so a crash never leaves a partial one.
+    bool SaveFileAtomically(const TArray<uint8>& Data, const FString& Path)
+    {
+        const FString TempPath = Path + TEXT(".tmp");
+        return FFileHelper::SaveArrayToFile(Data, *TempPath) && IFileManager::Get().Move(*Path, *TempPath, true, true);
+    }
+
+    // Replays one journal file into the states FindPlayer returns; records it returns nullptr for are skipped.
+    // Stops at the first torn or corrupt record.
+    int32 ReplayJournalFile(const FString& Path, TFunctionRef<FQuestSaveSnapshot*(const FString&)> FindPlayer)
+    {
+        TArray<uint8> Data;
+        if (!FFileHelper::LoadFileToArray(Data, *Path, FILEREAD_Silent))
+        {
+            return 0;
+        }
+
+        int32 NumRecords = 0;
+        int64 Offset = 0;
+        while (Offset + 2 * sizeof(uint32) <= Data.Num())
+        {
+            uint32 PayloadSize = 0;
+            uint32 PayloadCrc = 0;
+            FMemory::Memcpy(&PayloadSize, Data.GetData() + Offset, sizeof(uint32));
+            FMemory::Memcpy(&PayloadCrc, Data.GetData() + Offset + sizeof(uint32), sizeof(uint32));
+            const int64 PayloadStart = Offset + 2 * sizeof(uint32);
+            if (PayloadSize > MaxRecordSize || PayloadStart + PayloadSize > Data.Num()
+                || FCrc::MemCrc32(Data.GetData() + PayloadStart, PayloadSize) != PayloadCrc)
+            {
+                UE_LOG(LogTemp, Warning, TEXT("FQuestJournal: '%s' ends with a torn record at offset %lld, ignoring the rest."), *Path, Offset);
+                break;
+            }
+
+            FMemoryReaderView Ar(FMemoryView(Data.GetData() + PayloadStart, PayloadSize));
+            FQuestJournalRecord Record;
+            SerializeRecordPayload(Ar, Record);
+            FQuestSaveSnapshot* Player = Ar.IsError() ? nullptr : FindPlayer(Record.PlayerId);
+            if (Player)
+            {
+                FQuestJournal::ApplyRecord(Record, *Player);
+                ++NumRecords;
+            }
+            Offset = PayloadStart + PayloadSize;
+        }
+        return NumRecords;
+    }
+}
+
+FQuestJournal::FQuestJournal(const FString& InDirectory, const FString& InShardName, int32 FirstGeneration, float CommitIntervalSeconds)
+    : Directory(InDirectory)
+    , ShardName(InShardName)
+    , CommitIntervalMs(static_cast<uint32>(FMath::Max(CommitIntervalSeconds, 0.001f) * 1000.0f))
+    , CurrentGeneration(FirstGeneration)
+{
+    IFileManager::Get().MakeDirectory(*(Directory / (ShardName + TEXT(".players"))), true);
+    WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    Thread = FRunnableThread::Create(this, TEXT("QuestJournalWriter"), 0, TPri_BelowNormal);
+}
+
+FQuestJournal::~FQuestJournal()
+{
+    if (Thread)
+    {
+        Thread->Kill(true); // Calls Stop() and waits for Run() to commit what's left.
+        delete Thread;
+        Thread = nullptr;
+    }
+    FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+    WakeEvent = nullptr;
+
+    delete JournalFile;
+    JournalFile = nullptr;
+}
+
+void FQuestJournal::Append(const FQuestJournalRecord& Record)
+{
+    // Encode outside the lock; the lock only covers appending the bytes to the batch.
+    // (Saving through SerializeRecordPayload doesn't modify the record.)
+    TArray<uint8> Payload;
+    FMemoryWriter Ar(Payload);
+    SerializeRecordPayload(Ar, const_cast<FQuestJournalRecord&>(Record));
+    const uint32 PayloadSize = Payload.Num();
+    const uint32 PayloadCrc = FCrc::MemCrc32(Payload.GetData(), PayloadSize);
+
+    {
+        FScopeLock Lock(&PendingLock);
+        if (PendingItems.IsEmpty() || PendingItems.Last().Snapshots.IsValid() || PendingItems.Last().Generation != CurrentGeneration)
+        {
+            PendingItems.AddDefaulted_GetRef().Generation = CurrentGeneration;
+        }
+        TArray<uint8>& Records = PendingItems.Last().Records;
+        Records.Append(reinterpret_cast<const uint8*>(&PayloadSize), sizeof(uint32));
+        Records.Append(reinterpret_cast<const uint8*>(&PayloadCrc), sizeof(uint32));
+        Records.Append(Payload);
+    }
+
+    BytesSinceCompaction.fetch_add(PayloadSize + 2 * sizeof(uint32), std::memory_order_relaxed);
+}
+
+int32 FQuestJournal::Compact(const TSharedRef<const TMap<FString, FQuestSaveSnapshot>>& Snapshots)
+{
+    int32 Generation = 0;
+    {
+        FScopeLock Lock(&PendingLock);
+        FPendingItem& Item = PendingItems.AddDefaulted_GetRef();
+        Item.Generation = Generation = ++CurrentGeneration;
+        Item.Snapshots = Snapshots;
+    }
+    BytesSinceCompaction.store(0, std::memory_order_relaxed);
+    WakeEvent->Trigger();
+    return Generation;
+}
+
+uint32 FQuestJournal::Run()
+{
+    while (!bStopRequested.load())
+    {
+        // Group commit: everything appended during the interval goes to disk with one write and one fsync.
+        WakeEvent->Wait(CommitIntervalMs);
+        CommitPending();
+    }
+
+    CommitPending();
+    return 0;
+}
+
+void FQuestJournal::Stop()
+{
+    bStopRequested.store(true);
+    WakeEvent->Trigger();
+}
+
+void FQuestJournal::CommitPending()
+{
+    TArray<FPendingItem> Items;
+    {
+        FScopeLock Lock(&PendingLock);
+        Items = MoveTemp(PendingItems);
+        PendingItems.Reset();
+    }
+
+    bool bNeedsSync = false;
+    for (FPendingItem& Item : Items)
+    {
+        if (Item.Snapshots.IsValid())
+        {
+            // Everything of the previous generation must be durable before its journal can be deleted.
+            if (JournalFile && bNeedsSync)
+            {
+                JournalFile->Flush(true);
+                bNeedsSync = false;
+            }
+            WriteSnapshot(Item.Generation, *Item.Snapshots);
+            continue;
+        }
+
+        if (OpenJournal(Item.Generation))
+        {
+            JournalFile->Write(Item.Records.GetData(), Item.Records.Num());
+            bNeedsSync = true;
+        }
+    }
+
+    if (JournalFile && bNeedsSync)
+    {
+        JournalFile->Flush(true);
+    }
+}
+
+bool FQuestJournal::OpenJournal(int32 Generation)
+{
+    if (JournalFile && JournalFileGeneration == Generation)
+    {
+        return true;
+    }
+
+    delete JournalFile;
+    JournalFile = FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*GetJournalPath(Generation), true, false);
+    JournalFileGeneration = JournalFile ? Generation : INDEX_NONE;
+    if (!JournalFile)
+    {
+        UE_LOG(LogTemp, Error, TEXT("FQuestJournal: Cannot open '%s' for writing; quest progress is not being journaled."), *GetJournalPath(Generation));
+    }
+    return JournalFile != nullptr;
+}
+
+void FQuestJournal::WriteSnapshot(int32 Generation, const TMap<FString, FQuestSaveSnapshot>& Snapshots)
+{
+    // 1. The players whose state changed. A crash part way leaves some files a generation ahead of <Shard>.snapshot;
+    // Recover skips the journal records such a file already includes.
+    int64 NumBytes = 0;
+    for (const TPair<FString, FQuestSaveSnapshot>& Player : Snapshots)
+    {
+        TArray<uint8> Data;
+        FMemoryWriter Ar(Data);
+        uint32 FileMagic = PlayerFileMagic;
+        int32 PlayerGeneration = Generation;
+        FString PlayerId = Player.Key;
+        TArray<uint8> PlayerData;
+        Player.Value.WriteTo(PlayerData);
+        Ar << FileMagic << PlayerGeneration << PlayerId << PlayerData;
+
+        const FString PlayerPath = GetPlayerPath(Directory, ShardName, PlayerId);
+        if (!SaveFileAtomically(Data, PlayerPath))
+        {
+            UE_LOG(LogTemp, Error, TEXT("FQuestJournal: Failed to write snapshot '%s'; keeping the existing journals."), *PlayerPath);
+            return;
+        }
+        NumBytes += Data.Num();
+    }
+
+    // 2. The generation the player files now cover. No players in it: they all have their own files.
+    TArray<uint8> Data;
+    FMemoryWriter Ar(Data);
+    uint32 FileMagic = SnapshotFileMagic;
+    int32 SnapshotGeneration = Generation;
+    int32 NumPlayers = 0;
+    Ar << FileMagic << SnapshotGeneration << NumPlayers;
+
+    const FString SnapshotPath = GetSnapshotPath();
+    if (!SaveFileAtomically(Data, SnapshotPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("FQuestJournal: Failed to write snapshot '%s'; keeping the existing journals."), *SnapshotPath);
+        return;
+    }
+    WrittenSnapshotGeneration.store(Generation, std::memory_order_release);
+
+    // The snapshot covers everything before Generation.
+    TArray<FString> JournalFiles;
+    IFileManager::Get().FindFiles(JournalFiles, *(Directory / (ShardName + TEXT(".*.journal"))), true, false);
+    for (const FString& JournalFileName : JournalFiles)
+    {
+        const FString GenerationString = FPaths::GetBaseFilename(JournalFileName).RightChop(ShardName.Len() + 1);
+        if (GenerationString.IsNumeric() && FCString::Atoi(*GenerationString) < Generation)
+        {
+            IFileManager::Get().Delete(*(Directory / JournalFileName));
+        }
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("FQuestJournal: Compacted shard '%s', rewriting %d players (%lld bytes), generation %d."), *ShardName, Snapshots.Num(), NumBytes, Generation);
+}
+
+FString FQuestJournal::GetJournalPath(int32 Generation) const
+{
+    return Directory / FString::Printf(TEXT("%s.%d.journal"), *ShardName, Generation);
+}
+
+FString FQuestJournal::GetSnapshotPath() const
+{
+    return Directory / (ShardName + TEXT(".snapshot"));
+}
+
+FString FQuestJournal::GetPlayerPath(const FString& Directory, const FString& ShardName, const FString& PlayerId)
+{
+    // Player IDs (e.g., "Steam:7656...") aren't file names, so the file is named after a hash. The ID is stored
+    // inside as well, and checked when reading.
+    FTCHARToUTF8 PlayerIdUtf8(*PlayerId);
+    FMD5 Md5;
+    Md5.Update(reinterpret_cast<const uint8*>(PlayerIdUtf8.Get()), PlayerIdUtf8.Length());
+    uint8 Digest[16];
+    Md5.Final(Digest);
+    return Directory / (ShardName + TEXT(".players")) / (BytesToHex(Digest, UE_ARRAY_COUNT(Digest)) + TEXT(".snapshot"));
+}
+
+bool FQuestJournal::LoadPlayer(const FString& Directory, const FString& ShardName, const FString& PlayerId, FQuestSaveSnapshot& OutSnapshot, int32& OutGeneration)
+{
+    const FString PlayerPath = GetPlayerPath(Directory, ShardName, PlayerId);
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *PlayerPath, FILEREAD_Silent))
+    {
+        return false;
+    }
+
+    FMemoryReader Ar(Data);
+    uint32 FileMagic = 0;
+    int32 Generation = 0;
+    FString StoredPlayerId;
+    TArray<uint8> PlayerData;
+    Ar << FileMagic << Generation << StoredPlayerId << PlayerData;
+    FQuestSaveSnapshot Snapshot;
+    if (Ar.IsError() || FileMagic != PlayerFileMagic || StoredPlayerId != PlayerId || !Snapshot.ReadFrom(PlayerData))
+    {
+        UE_LOG(LogTemp, Error, TEXT("FQuestJournal: Snapshot '%s' of player '%s' is corrupt."), *PlayerPath, *PlayerId);
+        return false;
+    }
+
+    OutSnapshot = MoveTemp(Snapshot);
+    OutGeneration = Generation;
+    return true;
+}
+
+int32 FQuestJournal::Recover(const FString& Directory, const FString& ShardName, TMap<FString, FQuestSaveSnapshot>& OutPlayers)
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    // Generation each recovered player's base state covers: journal records older than that are already in it.
+    TMap<FString, int32> BaseGenerations;
+
+    // 1. The last snapshot, if any. It only holds players in shards written before player files existed; a player
+    // file written by a compaction that was cut short can be newer still.
+    int32 SnapshotGeneration = 0;
+    TArray<uint8> SnapshotData;
+    if (FFileHelper::LoadFileToArray(SnapshotData, *(Directory / (ShardName + TEXT(".snapshot"))), FILEREAD_Silent))
+    {
+        FMemoryReader Ar(SnapshotData);
+        uint32 FileMagic = 0;
+        int32 NumPlayers = 0;
+        Ar << FileMagic << SnapshotGeneration << NumPlayers;
+        for (int32 Index = 0; Index < NumPlayers && FileMagic == SnapshotFileMagic && !Ar.IsError(); ++Index)
+        {
+            FString PlayerId;
+            TArray<uint8> PlayerData;
+            Ar << PlayerId << PlayerData;
+            if (!Ar.IsError())
+            {
+                FQuestSaveSnapshot& Player = OutPlayers.FindOrAdd(PlayerId);
+                Player.ReadFrom(PlayerData);
+                int32& BaseGeneration = BaseGenerations.Add(PlayerId, SnapshotGeneration);
+
+                FQuestSaveSnapshot FromFile;
+                int32 FileGeneration = 0;
+                if (LoadPlayer(Directory, ShardName, PlayerId, FromFile, FileGeneration) && FileGeneration > SnapshotGeneration)
+                {
+                    Player = MoveTemp(FromFile);
+                    BaseGeneration = FileGeneration;
+                }
+            }
+        }
+        if (FileMagic != SnapshotFileMagic || Ar.IsError())
+        {
+            UE_LOG(LogTemp, Error, TEXT("FQuestJournal: Snapshot of shard '%s' is corrupt."), *ShardName);
+        }
+    }
+
+    // 2. Every journal from the snapshot's generation onward, oldest first.
+    TArray<int32> Generations;
+    TArray<FString> JournalFiles;
+    IFileManager::Get().FindFiles(JournalFiles, *(Directory / (ShardName + TEXT(".*.journal"))), true, false);
+    for (const FString& JournalFileName : JournalFiles)
+    {
+        const FString GenerationString = FPaths::GetBaseFilename(JournalFileName).RightChop(ShardName.Len() + 1);
+        if (GenerationString.IsNumeric() && FCString::Atoi(*GenerationString) >= SnapshotGeneration)
+        {
+            Generations.Add(FCString::Atoi(*GenerationString));
+        }
+    }
+    Generations.Sort();
+
+    // Players are loaded at their first record, so only those with records since their last snapshot are read.
+    int32 NumRecords = 0;
+    for (const int32 Generation : Generations)
+    {
+        NumRecords += ReplayJournalFile(Directory / FString::Printf(TEXT("%s.%d.journal"), *ShardName, Generation), [&](const FString& PlayerId) -> FQuestSaveSnapshot*
+        {
+            const int32* BaseGeneration = BaseGenerations.Find(PlayerId);
+            if (!BaseGeneration)
+            {
+                FQuestSaveSnapshot& Player = OutPlayers.Add(PlayerId);
+                int32 FileGeneration = 0;
+                if (!LoadPlayer(Directory, ShardName, PlayerId, Player, FileGeneration))
+                {
+                    FileGeneration = 0; // A new player: the journals hold everything.
+                }
+                BaseGeneration = &BaseGenerations.Add(PlayerId, FileGeneration);
+            }
+            return Generation >= *BaseGeneration ? OutPlayers.Find(PlayerId) : nullptr;
+        });
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("FQuestJournal: Recovered %d players of shard '%s' (%d journal records) in %.2f ms."), OutPlayers.Num(), *ShardName, NumRecords, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+    // Never append to a journal that may end with a torn record; continue in a fresh generation.
+    return Generations.Num() > 0 ? FMath::Max(SnapshotGeneration, Generations.Last() + 1) : SnapshotGeneration;
+}
+
+void FQuestJournal::ApplyRecord(const FQuestJournalRecord& Record, FQuestSaveSnapshot& Snapshot)
+{
+    const int32 ActiveIndex = Snapshot.ActiveQuests.IndexOfByPredicate([&Record](const FQuestSaveRecord& Active) { return Active.Quest == Record.Quest; });
+
+    switch (Record.Op)
+    {
+    case EQuestJournalOp::QuestAdded:
+        if (ActiveIndex == INDEX_NONE)
+        {
+            FQuestSaveRecord& Active = Snapshot.ActiveQuests.AddDefaulted_GetRef();
+            Active.Quest = Record.Quest;
+            Active.Status = EQuestStatus::Active;
+        }
+        break;
+
+    case EQuestJournalOp::ObjectiveProgress:
+        if (ActiveIndex != INDEX_NONE)
+        {
+            TArray<int32>& Progress = Snapshot.ActiveQuests[ActiveIndex].ObjectiveProgress;
+            if (Progress.Num() <= Record.ObjectiveIndex)
+            {
+                Progress.SetNumZeroed(Record.ObjectiveIndex + 1);
+            }
+            Progress[Record.ObjectiveIndex] = static_cast<int32>(FMath::Clamp<int64>(Record.Value, 0, MAX_int32));
+        }
+        break;
+
+    case EQuestJournalOp::ObjectiveDeadline:
+        if (ActiveIndex != INDEX_NONE)
+        {
+            TArray<int64>& Deadlines = Snapshot.ActiveQuests[ActiveIndex].ObjectiveDeadlines;
+            if (Deadlines.Num() <= Record.ObjectiveIndex)
+            {
+                Deadlines.SetNumZeroed(Record.ObjectiveIndex + 1);
+            }
+            Deadlines[Record.ObjectiveIndex] = FMath::Max<int64>(Record.Value, 0);
+        }
+        break;
+
+    case EQuestJournalOp::QuestRemoved:
+        if (ActiveIndex != INDEX_NONE)
+        {
+            Snapshot.ActiveQuests.RemoveAt(ActiveIndex);
+        }
+        break;
+
+    case EQuestJournalOp::QuestCompleted:
+        if (ActiveIndex != INDEX_NONE)
+        {
+            Snapshot.ActiveQuests.RemoveAt(ActiveIndex);
+        }
+        Snapshot.CompletedQuests.AddUnique(Record.Quest);
+        Snapshot.CompletionHistory.Add({ Record.Quest, Record.Value });
+        break;
+
+    case EQuestJournalOp::PlayerSnapshot:
+        {
+            FQuestSaveSnapshot Replacement;
+            if (Replacement.ReadFrom(Record.Data))
+            {
+                Snapshot = MoveTemp(Replacement);
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
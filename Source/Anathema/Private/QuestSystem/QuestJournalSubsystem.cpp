@@ -0,0 +1,200 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestJournalSubsystem.h"
+#include "QuestSystem/QuestStats.h"
+#include "QuestManagerComponent.h"
+#include "Engine/World.h"
+#include "Misc/Paths.h"
+#include "Misc/CommandLine.h"
+
+bool UQuestJournalSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    // Recovery and compaction rewrite the shard's files, so nothing journals without being told which shard it is.
+    const UWorld* World = Cast<UWorld>(Outer);
+    FString Shard;
+    return Super::ShouldCreateSubsystem(Outer) && bEnableJournal && World && World->IsGameWorld() && !IsRunningClientOnly()
+        && FParse::Value(FCommandLine::Get(), TEXT("QuestShard="), Shard) && !Shard.IsEmpty();
+}
+
+void UQuestJournalSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    FParse::Value(FCommandLine::Get(), TEXT("QuestShard="), ShardName);
+}
+
+void UQuestJournalSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    // Only a server owns quest state, and only the world it serves players from journals it: standalone worlds
+    // (benchmarks, capture replays, tools) stay out. The net mode is known by now, unlike in Initialize.
+    const ENetMode NetMode = InWorld.GetNetMode();
+    if (NetMode != NM_DedicatedServer && NetMode != NM_ListenServer)
+    {
+        return;
+    }
+
+    // Rebuild every player's state from the last run, then fold it into a fresh snapshot right away
+    // so the journals of the last run can be dropped.
+    Directory = FPaths::ProjectSavedDir() / TEXT("QuestJournal");
+    const int32 FirstGeneration = FQuestJournal::Recover(Directory, ShardName, OfflinePlayers);
+    Journal = MakeUnique<FQuestJournal>(Directory, ShardName, FirstGeneration, CommitInterval);
+    Compact();
+}
+
+void UQuestJournalSubsystem::Deinitialize()
+{
+    // Quest managers have left by now (EndPlay), so OfflinePlayers holds everyone who changed since the last compaction.
+    // Compacting on a clean shutdown means the next start has no journal to replay.
+    if (Journal)
+    {
+        Compact();
+        Journal.Reset(); // Commits everything still pending.
+    }
+    OnlinePlayers.Empty();
+    OfflinePlayers.Empty();
+    UnwrittenSnapshots.Empty();
+
+    Super::Deinitialize();
+}
+
+void UQuestJournalSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    QuestStats::FScopedGameThreadCycles CycleScope;
+
+    if (!Journal)
+    {
+        return;
+    }
+
+    // Players whose files are written are read from there from now on.
+    const int32 WrittenGeneration = Journal->GetWrittenSnapshotGeneration();
+    UnwrittenSnapshots.RemoveAll([WrittenGeneration](const FUnwrittenSnapshots& Unwritten) { return Unwritten.Generation <= WrittenGeneration; });
+
+    if (Journal->GetBytesSinceCompaction() > static_cast<int64>(CompactionThresholdKB) * 1024)
+    {
+        Compact();
+    }
+}
+
+TStatId UQuestJournalSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UQuestJournalSubsystem, STATGROUP_Quests);
+}
+
+void UQuestJournalSubsystem::RegisterPlayer(UQuestManagerComponent* QuestManager)
+{
+    if (!Journal || !IsValid(QuestManager) || QuestManager->PersistenceId.IsEmpty())
+    {
+        return;
+    }
+
+    const FString& PlayerId = QuestManager->PersistenceId;
+    OnlinePlayers.Add(PlayerId, QuestManager);
+
+    // Restore before the manager starts journaling, so the restore itself isn't recorded. Active quests are
+    // activated over the next frames; they are in the manager's snapshots meanwhile, so compaction keeps them.
+    FQuestSaveSnapshot Recovered;
+    if (FindOfflinePlayer(PlayerId, Recovered))
+    {
+        QuestManager->RestoreSaveSnapshot(Recovered, true);
+    }
+    QuestManager->JournalSubsystem = this;
+}
+
+bool UQuestJournalSubsystem::FindOfflinePlayer(const FString& PlayerId, FQuestSaveSnapshot& OutSnapshot)
+{
+    // Newest first. The player is online from here on, so the next compaction captures them from their manager.
+    if (OfflinePlayers.RemoveAndCopyValue(PlayerId, OutSnapshot))
+    {
+        return true;
+    }
+    for (int32 Index = UnwrittenSnapshots.Num() - 1; Index >= 0; --Index)
+    {
+        if (const FQuestSaveSnapshot* Snapshot = UnwrittenSnapshots[Index].Players->Find(PlayerId))
+        {
+            OutSnapshot = *Snapshot;
+            return true;
+        }
+    }
+
+    // A small synchronous read, once per login. Nothing writes this file now: every compaction that includes the
+    // player is still in UnwrittenSnapshots until its files are written.
+    int32 Generation = 0;
+    return FQuestJournal::LoadPlayer(Directory, ShardName, PlayerId, OutSnapshot, Generation);
+}
+
+void UQuestJournalSubsystem::UnregisterPlayer(UQuestManagerComponent* QuestManager)
+{
+    if (!IsValid(QuestManager) || QuestManager->JournalSubsystem != this)
+    {
+        return;
+    }
+
+    QuestManager->JournalSubsystem = nullptr;
+    OnlinePlayers.Remove(QuestManager->PersistenceId);
+
+    // Keep the player's state for the next snapshot; their journal records stay valid until then.
+    FQuestSaveSnapshot& Snapshot = OfflinePlayers.Add(QuestManager->PersistenceId);
+    QuestManager->CaptureSaveSnapshot(Snapshot);
+}
+
+void UQuestJournalSubsystem::Append(const FQuestJournalRecord& Record)
+{
+    if (Journal)
+    {
+        Journal->Append(Record);
+    }
+}
+
+void UQuestJournalSubsystem::AppendPlayerSnapshot(const UQuestManagerComponent* QuestManager)
+{
+    if (!Journal || !IsValid(QuestManager) || QuestManager->PersistenceId.IsEmpty())
+    {
+        return;
+    }
+
+    FQuestSaveSnapshot Snapshot;
+    QuestManager->CaptureSaveSnapshot(Snapshot);
+
+    FQuestJournalRecord Record;
+    Record.Op = EQuestJournalOp::PlayerSnapshot;
+    Record.PlayerId = QuestManager->PersistenceId;
+    Snapshot.WriteTo(Record.Data);
+    Journal->Append(Record);
+}
+
+void UQuestJournalSubsystem::Compact()
+{
+    if (!Journal)
+    {
+        return;
+    }
+
+    // Only players whose state may have changed since their file was written: those online, those who left since the
+    // last compaction, and those of compactions not written yet (still in flight, or failed). Everyone else's file is
+    // current. States are copied on the game thread; encoding and writing happen on the journal's writer thread.
+    TSharedRef<TMap<FString, FQuestSaveSnapshot>> Snapshots = MakeShared<TMap<FString, FQuestSaveSnapshot>>();
+    for (const FUnwrittenSnapshots& Unwritten : UnwrittenSnapshots)
+    {
+        Snapshots->Append(*Unwritten.Players);
+    }
+    Snapshots->Append(MoveTemp(OfflinePlayers));
+    OfflinePlayers.Reset();
+    for (const TPair<FString, TWeakObjectPtr<UQuestManagerComponent>>& Player : OnlinePlayers)
+    {
+        if (const UQuestManagerComponent* QuestManager = Player.Value.Get())
+        {
+            QuestManager->CaptureSaveSnapshot(Snapshots->Add(Player.Key));
+        }
+    }
+
+    // Offline players leave memory once the writer thread has put them in their files (see Tick).
+    FUnwrittenSnapshots& Unwritten = UnwrittenSnapshots.AddDefaulted_GetRef();
+    Unwritten.Players = Snapshots;
+    Unwritten.Generation = Journal->Compact(Snapshots);
+}
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestLoadTestBotComponent.h"
+#include "QuestSystem/QuestLoadTestGameMode.h"
+#include "QuestSystem/QuestNode.h"
+#include "QuestSystem/QuestStats.h"
+#include "QuestManagerComponent.h"
+#include "Engine/World.h"
+
+UQuestLoadTestBotComponent::UQuestLoadTestBotComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+}
+
+void UQuestLoadTestBotComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    GameMode = GetWorld()->GetAuthGameMode<AQuestLoadTestGameMode>();
+    QuestManager = GetOwner()->FindComponentByClass<UQuestManagerComponent>();
+    if (!GameMode || !QuestManager)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("QuestLoadTestBotComponent on '%s' needs AQuestLoadTestGameMode and a UQuestManagerComponent on its owner."), *GetNameSafe(GetOwner()));
+        SetComponentTickEnabled(false);
+        return;
+    }
+
+    // Random phases, so bots spawned on the same frame don't emit their events on the same frames.
+    Random.Initialize(Seed);
+    for (int32 MixIndex = 0; MixIndex < GameMode->EventMix.Num(); ++MixIndex)
+    {
+        EventAccumulators.Add(Random.FRand());
+    }
+
+    QuestCompletedHandle = QuestManager->OnPlayerQuestCompletedNative.AddUObject(this, &UQuestLoadTestBotComponent::OnQuestCompleted);
+}
+
+void UQuestLoadTestBotComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (QuestManager)
+    {
+        QuestManager->OnPlayerQuestCompletedNative.Remove(QuestCompletedHandle);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void UQuestLoadTestBotComponent::OnQuestCompleted(UQuestNode* CompletedQuest)
+{
+    bNeedsQuests = true;
+}
+
+void UQuestLoadTestBotComponent::TopUpQuests()
+{
+    const TArray<UQuestNode*>& QuestPool = GameMode->GetQuestPool();
+    const int32 TargetQuests = FMath::Min(GameMode->QuestsPerPlayer, QuestPool.Num());
+    for (int32 Attempt = 0; QuestManager->ActiveQuests.Items.Num() < TargetQuests && Attempt < QuestPool.Num() * 2; ++Attempt)
+    {
+        UQuestNode* Quest = QuestPool[Random.RandHelper(QuestPool.Num())];
+        if (!QuestManager->IsQuestActive(Quest))
+        {
+            QuestManager->AddQuest(Quest);
+        }
+    }
+    bNeedsQuests = false;
+}
+
+void UQuestLoadTestBotComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    QuestStats::FScopedGameThreadCycles CycleScope;
+
+    if (bNeedsQuests)
+    {
+        TopUpQuests();
+    }
+
+    for (int32 MixIndex = 0; MixIndex < EventAccumulators.Num(); ++MixIndex)
+    {
+        const FQuestLoadTestEvent& Event = GameMode->EventMix[MixIndex];
+        for (EventAccumulators[MixIndex] += Event.EventsPerSecond * DeltaTime; EventAccumulators[MixIndex] >= 1.0; EventAccumulators[MixIndex] -= 1.0)
+        {
+            const FName EventTag = GameMode->GetEventTag(MixIndex, Random.RandHelper(FMath::Max(Event.NumVariants, 1)));
+            QuestManager->NotifyEvent(FObjectiveEventData(EventTag, nullptr, GetOwner()));
+        }
+    }
+}
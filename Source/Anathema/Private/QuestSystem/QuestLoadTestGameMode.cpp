@@ -0,0 +1,296 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestLoadTestGameMode.h"
+#include "QuestSystem/QuestLoadTestBotComponent.h"
+#include "QuestSystem/QuestNode.h"
+#include "QuestSystem/QuestDefinitionSubsystem.h"
+#include "QuestSystem/QuestProgressSubsystem.h"
+#include "QuestSystem/QuestMemoryReport.h"
+#include "QuestSystem/QuestStats.h"
+#include "QuestManagerComponent.h"
+#include "GameFramework/PlayerState.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Math/RandomStream.h"
+#include "UObject/Package.h"
+
+AQuestLoadTestGameMode::AQuestLoadTestGameMode()
+{
+    PrimaryActorTick.bCanEverTick = true;
+
+    PlayerCounts = { 10, 100, 500 };
+
+    auto AddEvent = [this](FName EventTag, int32 NumVariants, float EventsPerSecond)
+    {
+        FQuestLoadTestEvent& Event = EventMix.AddDefaulted_GetRef();
+        Event.EventTag = EventTag;
+        Event.NumVariants = NumVariants;
+        Event.EventsPerSecond = EventsPerSecond;
+    };
+    AddEvent(TEXT("LoadTest.Kill"), 8, 0.5f);
+    AddEvent(TEXT("LoadTest.Collect"), 16, 0.3f);
+    AddEvent(TEXT("LoadTest.Interact"), 4, 0.1f);
+}
+
+void AQuestLoadTestGameMode::BeginPlay()
+{
+    Super::BeginPlay();
+
+    FString PlayerCountsParam;
+    if (FParse::Value(FCommandLine::Get(), TEXT("QuestLoadTestPlayers="), PlayerCountsParam, false))
+    {
+        TArray<FString> Counts;
+        PlayerCountsParam.ParseIntoArray(Counts, TEXT(","));
+        PlayerCounts.Reset();
+        for (const FString& Count : Counts)
+        {
+            PlayerCounts.Add(FCString::Atoi(*Count));
+        }
+    }
+
+    for (const FQuestLoadTestEvent& Event : EventMix)
+    {
+        TArray<FName>& Variants = EventTags.AddDefaulted_GetRef();
+        for (int32 Variant = 0; Variant < FMath::Max(Event.NumVariants, 1); ++Variant)
+        {
+            Variants.Add(FName(*FString::Printf(TEXT("%s.%d"), *Event.EventTag.ToString(), Variant)));
+        }
+    }
+    BuildQuestPool();
+
+    WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &AQuestLoadTestGameMode::OnWorldTickStart);
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &AQuestLoadTestGameMode::OnWorldPostActorTick);
+
+    StartStage(0);
+}
+
+void AQuestLoadTestGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+    // Take the pool out of the quest graph again, so repeated runs in one process (PIE) don't pile up quests.
+    // The bots' quest managers still track pool quests, so they go first.
+    UQuestDefinitionSubsystem* Definitions = UQuestDefinitionSubsystem::Get();
+    if (Definitions && FirstPoolQuestId != INDEX_NONE)
+    {
+        for (APlayerState* Bot : Bots)
+        {
+            if (UQuestManagerComponent* QuestManager = IsValid(Bot) ? Bot->FindComponentByClass<UQuestManagerComponent>() : nullptr)
+            {
+                QuestManager->DestroyComponent();
+            }
+        }
+        Definitions->UnregisterQuestsFrom(FirstPoolQuestId);
+        FirstPoolQuestId = INDEX_NONE;
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void AQuestLoadTestGameMode::BuildQuestPool()
+{
+    FRandomStream Random(NumQuests);
+    for (int32 QuestIndex = 0; QuestIndex < NumQuests; ++QuestIndex)
+    {
+        // Outside the world, like real quest assets: the quest graph references its quests for the rest of the
+        // process, and a quest outered to this game mode would keep the whole world alive through it.
+        UQuestNode* Quest = NewObject<UQuestNode>(GetTransientPackage());
+        Quest->QuestName = FText::FromString(FString::Printf(TEXT("Load Test Quest %d"), QuestIndex));
+
+        for (int32 ObjectiveIndex = 0; ObjectiveIndex < ObjectivesPerQuest && EventMix.Num() > 0; ++ObjectiveIndex)
+        {
+            // Half of the objectives want a specific variant ("kill 3 archers"), the rest any variant ("kill 10 enemies").
+            const int32 MixIndex = Random.RandHelper(EventMix.Num());
+            UObjective* Objective = NewObject<UObjective>(Quest);
+            Objective->HandledEventTags.Add(Random.FRand() < 0.5f ? EventMix[MixIndex].EventTag : EventTags[MixIndex][Random.RandHelper(EventTags[MixIndex].Num())]);
+            Objective->RequiredProgress = Random.RandRange(1, 10);
+            Quest->Objectives.Add(Objective);
+        }
+
+        // Every tenth quest also waits for a world event.
+        if (QuestIndex % 10 == 0 && !WorldEventTag.IsNone())
+        {
+            UObjective* Objective = NewObject<UObjective>(Quest);
+            Objective->HandledEventTags.Add(WorldEventTag);
+            Quest->Objectives.Add(Objective);
+        }
+        QuestPool.Add(Quest);
+    }
+
+    // Compiled in one batch up front; registered lazily by AddQuest, each quest would be compiled on its own.
+    if (UQuestDefinitionSubsystem* Definitions = UQuestDefinitionSubsystem::Get())
+    {
+        FirstPoolQuestId = Definitions->GetQuestGraph().Num();
+        Definitions->RegisterQuests(QuestPool);
+    }
+}
+
+void AQuestLoadTestGameMode::SpawnBots(int32 NumPlayers)
+{
+    while (Bots.Num() < NumPlayers)
+    {
+        APlayerState* Bot = GetWorld()->SpawnActor<APlayerState>(PlayerStateClass ? *PlayerStateClass : APlayerState::StaticClass());
+        Bot->SetPlayerName(FString::Printf(TEXT("QuestBot%d"), Bots.Num()));
+
+        UQuestManagerComponent* QuestManager = Bot->FindComponentByClass<UQuestManagerComponent>();
+        if (!QuestManager)
+        {
+            QuestManager = NewObject<UQuestManagerComponent>(Bot, TEXT("QuestManager"));
+            QuestManager->RegisterComponent();
+        }
+
+        UQuestLoadTestBotComponent* BotComponent = NewObject<UQuestLoadTestBotComponent>(Bot, TEXT("QuestBot"));
+        BotComponent->Seed = Bots.Num();
+        BotComponent->RegisterComponent();
+
+        Bots.Add(Bot);
+    }
+}
+
+void AQuestLoadTestGameMode::StartStage(int32 StageIndex)
+{
+    if (!PlayerCounts.IsValidIndex(StageIndex))
+    {
+        CurrentStage = INDEX_NONE;
+        WriteResults();
+        if (bQuitWhenDone)
+        {
+            FPlatformMisc::RequestExit(false, TEXT("QuestLoadTest"));
+        }
+        return;
+    }
+
+    CurrentStage = StageIndex;
+    SpawnBots(PlayerCounts[StageIndex]);
+    StageStartTime = FPlatformTime::Seconds();
+    bMeasuring = false;
+    UE_LOG(LogTemp, Display, TEXT("QuestLoadTest: stage %d, %d players, warming up for %.0f s."), StageIndex, Bots.Num(), WarmupSeconds);
+}
+
+void AQuestLoadTestGameMode::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    if (CurrentStage == INDEX_NONE)
+    {
+        return;
+    }
+
+    WorldEventAccumulator += WorldEventsPerSecond * DeltaSeconds;
+    if (WorldEventAccumulator >= 1.0)
+    {
+        WorldEventAccumulator -= 1.0;
+        if (UQuestProgressSubsystem* ProgressSubsystem = GetWorld()->GetSubsystem<UQuestProgressSubsystem>())
+        {
+            QuestStats::FScopedGameThreadCycles CycleScope;
+            ProgressSubsystem->ProcessEventForAllPlayers(FObjectiveEventData(WorldEventTag, nullptr, this));
+        }
+    }
+
+    const double Elapsed = FPlatformTime::Seconds() - StageStartTime;
+    if (!bMeasuring)
+    {
+        if (Elapsed >= WarmupSeconds)
+        {
+            bMeasuring = true;
+            StageStartTime = FPlatformTime::Seconds();
+            FrameMs.Reset();
+            WorldTickMs.Reset();
+            QuestCyclesAtStart = QuestStats::GetGameThreadCycles();
+        }
+        return;
+    }
+
+    FrameMs.Add(DeltaSeconds * 1000.0f);
+    if (Elapsed >= MeasureSeconds)
+    {
+        FinishStage();
+        StartStage(CurrentStage + 1);
+    }
+}
+
+void AQuestLoadTestGameMode::OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+    if (InWorld == GetWorld())
+    {
+        WorldTickStartCycles = FPlatformTime::Cycles64();
+    }
+}
+
+void AQuestLoadTestGameMode::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+    if (InWorld == GetWorld() && bMeasuring && WorldTickStartCycles != 0)
+    {
+        WorldTickMs.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - WorldTickStartCycles));
+    }
+}
+
+void AQuestLoadTestGameMode::FinishStage()
+{
+    auto Average = [](const TArray<float>& Samples)
+    {
+        float Sum = 0.0f;
+        for (const float Sample : Samples)
+        {
+            Sum += Sample;
+        }
+        return Samples.Num() > 0 ? Sum / Samples.Num() : 0.0f;
+    };
+    auto P99 = [](TArray<float> Samples)
+    {
+        Samples.Sort();
+        return Samples.Num() > 0 ? Samples[FMath::Clamp(FMath::CeilToInt32(0.99f * Samples.Num()) - 1, 0, Samples.Num() - 1)] : 0.0f;
+    };
+
+    FStageResult& Result = Results.AddDefaulted_GetRef();
+    Result.NumPlayers = Bots.Num();
+    Result.NumFrames = FrameMs.Num();
+    Result.FrameMsAvg = Average(FrameMs);
+    Result.FrameMsP99 = P99(FrameMs);
+    Result.WorldTickMsAvg = Average(WorldTickMs);
+    Result.WorldTickMsP99 = P99(WorldTickMs);
+    Result.QuestMsPerFrame = FrameMs.Num() > 0 ? FPlatformTime::ToMilliseconds64(QuestStats::GetGameThreadCycles() - QuestCyclesAtStart) / FrameMs.Num() : 0.0f;
+    Result.UsedPhysicalBytes = FPlatformMemory::GetStats().UsedPhysical;
+    if (const UQuestProgressSubsystem* ProgressSubsystem = GetWorld()->GetSubsystem<UQuestProgressSubsystem>())
+    {
+        Result.NumActiveQuests = ProgressSubsystem->GetNumActiveQuests();
+    }
+    for (const APlayerState* Bot : Bots)
+    {
+        if (const UQuestManagerComponent* QuestManager = Bot ? Bot->FindComponentByClass<UQuestManagerComponent>() : nullptr)
+        {
+            FQuestPlayerMemory Memory;
+            QuestManager->GetMemoryUsage(Memory);
+            Result.QuestBytes += Memory.GetTotal();
+        }
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("QuestLoadTest: %d players, %d frames: frame %.2f ms (p99 %.2f), world tick %.2f ms (p99 %.2f), quests %.3f ms/frame, %d active quests, quest state %.1f KB (%.2f KB/player), process %.1f MB"),
+        Result.NumPlayers, Result.NumFrames, Result.FrameMsAvg, Result.FrameMsP99, Result.WorldTickMsAvg, Result.WorldTickMsP99, Result.QuestMsPerFrame,
+        Result.NumActiveQuests, Result.QuestBytes / 1024.0, Result.NumPlayers > 0 ? Result.QuestBytes / 1024.0 / Result.NumPlayers : 0.0, Result.UsedPhysicalBytes / (1024.0 * 1024.0));
+}
+
+void AQuestLoadTestGameMode::WriteResults() const
+{
+    FString Csv = TEXT("Players,Frames,FrameMsAvg,FrameMsP99,WorldTickMsAvg,WorldTickMsP99,QuestMsPerFrame,ActiveQuests,QuestBytes,UsedPhysicalBytes\n");
+    for (const FStageResult& Result : Results)
+    {
+        Csv += FString::Printf(TEXT("%d,%d,%.3f,%.3f,%.3f,%.3f,%.4f,%d,%llu,%llu\n"), Result.NumPlayers, Result.NumFrames, Result.FrameMsAvg, Result.FrameMsP99,
+            Result.WorldTickMsAvg, Result.WorldTickMsP99, Result.QuestMsPerFrame, Result.NumActiveQuests, Result.QuestBytes, Result.UsedPhysicalBytes);
+    }
+
+    const FString Path = FPaths::ProjectSavedDir() / TEXT("LoadTest") / FString::Printf(TEXT("QuestLoadTest-%s.csv"), *FDateTime::Now().ToString());
+    if (FFileHelper::SaveStringToFile(Csv, *Path))
+    {
+        UE_LOG(LogTemp, Display, TEXT("QuestLoadTest: results written to %s"), *Path);
+    }
+    else
+    {
+        UE_LOG(LogTemp, Error, TEXT("QuestLoadTest: failed to write results to %s"), *Path);
+    }
+}
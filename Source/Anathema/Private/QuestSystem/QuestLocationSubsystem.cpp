@@ -0,0 +1,253 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestLocationSubsystem.h"
+#include "QuestSystem/QuestStats.h"
+#include "QuestSystem/LocationObjective.h"
+#include "QuestSystem/QuestPlayerRegistrySubsystem.h"
+#include "QuestSystem/QuestEventRecorderSubsystem.h"
+#include "QuestManagerComponent.h"
+#include "GameFramework/PlayerState.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+
+// --- REGIONS ---
+
+void UQuestLocationSubsystem::AddRegionInterest(const ULocationObjective* Objective, AActor* Player)
+{
+    LLM_SCOPE_BYTAG(Quests_Runtime);
+
+    if (!IsValid(Objective) || !IsValid(Player) || Objective->RegionTag.IsNone())
+    {
+        return;
+    }
+
+    // The region is shared by every player working towards the objective.
+    int32 RegionIndex = INDEX_NONE;
+    if (const int32* ExistingIndex = RegionIndices.Find(Objective))
+    {
+        RegionIndex = *ExistingIndex;
+    }
+    else
+    {
+        RegionIndex = FreeRegions.Num() > 0 ? FreeRegions.Pop(EAllowShrinking::No) : Regions.AddDefaulted();
+        FRegion& Region = Regions[RegionIndex];
+        Region.Objective = Objective;
+        Region.Center = Objective->TargetLocation;
+        Region.RadiusSquared = FMath::Square(Objective->Radius);
+        Region.Tag = Objective->RegionTag;
+        Region.MinCell = GetCell(Objective->TargetLocation - FVector(Objective->Radius));
+        Region.MaxCell = GetCell(Objective->TargetLocation + FVector(Objective->Radius));
+        Region.RefCount = 0;
+        RegionIndices.Add(Objective, RegionIndex);
+
+        for (int32 X = Region.MinCell.X; X <= Region.MaxCell.X; ++X)
+        {
+            for (int32 Y = Region.MinCell.Y; Y <= Region.MaxCell.Y; ++Y)
+            {
+                Cells.FindOrAdd(FIntPoint(X, Y)).Add(RegionIndex);
+            }
+        }
+    }
+    ++Regions[RegionIndex].RefCount;
+
+    FTrackedPlayer& Tracked = Players.FindOrAdd(Player);
+    if (Tracked.InterestCount++ == 0)
+    {
+        Tracked.Owner = Player;
+        const UQuestPlayerRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UQuestPlayerRegistrySubsystem>();
+        Tracked.QuestManager = Registry ? Registry->FindByOwner(Player) : nullptr;
+        if (!Tracked.QuestManager)
+        {
+            // The manager hasn't begun play yet.
+            Tracked.QuestManager = Player->FindComponentByClass<UQuestManagerComponent>();
+        }
+    }
+}
+
+void UQuestLocationSubsystem::RemoveRegionInterest(const ULocationObjective* Objective, AActor* Player)
+{
+    const int32* RegionIndexPtr = RegionIndices.Find(Objective);
+    if (!RegionIndexPtr)
+    {
+        return;
+    }
+    const int32 RegionIndex = *RegionIndexPtr;
+
+    if (FTrackedPlayer* Tracked = Players.Find(Player))
+    {
+        Tracked->InsideRegions.RemoveSingleSwap(RegionIndex);
+        if (--Tracked->InterestCount <= 0)
+        {
+            Players.Remove(Player);
+        }
+    }
+
+    FRegion& Region = Regions[RegionIndex];
+    if (--Region.RefCount > 0)
+    {
+        return;
+    }
+
+    // Nobody needs the region anymore: take it out of the grid and recycle the slot.
+    for (int32 X = Region.MinCell.X; X <= Region.MaxCell.X; ++X)
+    {
+        for (int32 Y = Region.MinCell.Y; Y <= Region.MaxCell.Y; ++Y)
+        {
+            const FIntPoint Cell(X, Y);
+            if (TArray<int32>* CellRegions = Cells.Find(Cell))
+            {
+                CellRegions->RemoveSingleSwap(RegionIndex);
+                if (CellRegions->IsEmpty())
+                {
+                    Cells.Remove(Cell);
+                }
+            }
+        }
+    }
+
+    // The slot will be reused, so no player may still think they're inside it.
+    for (TPair<TObjectKey<AActor>, FTrackedPlayer>& Pair : Players)
+    {
+        Pair.Value.InsideRegions.RemoveSingleSwap(RegionIndex);
+    }
+
+    RegionIndices.Remove(Objective);
+    Region = FRegion();
+    FreeRegions.Add(RegionIndex);
+}
+
+FIntPoint UQuestLocationSubsystem::GetCell(const FVector& Location) const
+{
+    const float SafeCellSize = FMath::Max(CellSize, 1.0f);
+    return FIntPoint(FMath::FloorToInt(Location.X / SafeCellSize), FMath::FloorToInt(Location.Y / SafeCellSize));
+}
+
+// --- PLAYER TESTS ---
+
+void UQuestLocationSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    QuestStats::FScopedGameThreadCycles CycleScope;
+
+    TimeSinceLastCheck += DeltaTime;
+    if (Players.IsEmpty() || TimeSinceLastCheck < CheckInterval)
+    {
+        return;
+    }
+    TimeSinceLastCheck = 0.0f;
+
+    TArray<FRegionEntry> Entries;
+    for (TPair<TObjectKey<AActor>, FTrackedPlayer>& Pair : Players)
+    {
+        APlayerController* PlayerController = nullptr;
+        if (AActor* Pawn = GetPlayerPawn(Pair.Value.Owner.Get(), PlayerController))
+        {
+            TestPlayer(Pair.Value, Pawn->GetActorLocation(), PlayerController, Pawn, Entries);
+        }
+    }
+
+    // Events can complete objectives, which removes regions and players, so they're sent after the loop.
+    SendEntryEvents(Entries);
+}
+
+void UQuestLocationSubsystem::TestPlayerLocation(AActor* Player, const FVector& Location)
+{
+    FTrackedPlayer* Tracked = Players.Find(Player);
+    if (!Tracked)
+    {
+        return;
+    }
+
+    APlayerController* PlayerController = nullptr;
+    AActor* Pawn = GetPlayerPawn(Player, PlayerController);
+
+    TArray<FRegionEntry> Entries;
+    TestPlayer(*Tracked, Location, PlayerController, Pawn, Entries);
+    SendEntryEvents(Entries);
+}
+
+void UQuestLocationSubsystem::TestPlayer(FTrackedPlayer& Player, const FVector& Location, APlayerController* PlayerController, AActor* Pawn, TArray<FRegionEntry>& OutEntries)
+{
+    // Only the regions overlapping the player's cell can contain the player.
+    TArray<int32, TInlineAllocator<4>> NowInside;
+    if (const TArray<int32>* CellRegions = Cells.Find(GetCell(Location)))
+    {
+        for (const int32 RegionIndex : *CellRegions)
+        {
+            const FRegion& Region = Regions[RegionIndex];
+            if (FVector::DistSquared(Location, Region.Center) > Region.RadiusSquared)
+            {
+                continue;
+            }
+
+            NowInside.Add(RegionIndex);
+
+            // Only transitions from outside to inside count, and only for players who want the event.
+            const UQuestManagerComponent* QuestManager = Player.QuestManager.Get();
+            if (!Player.InsideRegions.Contains(RegionIndex) && QuestManager && QuestManager->HasSubscribersForEvent(Region.Tag))
+            {
+                OutEntries.Add({ Player.QuestManager, Region.Tag, PlayerController, Pawn });
+            }
+        }
+    }
+    Player.InsideRegions = MoveTemp(NowInside);
+}
+
+void UQuestLocationSubsystem::SendEntryEvents(const TArray<FRegionEntry>& Entries) const
+{
+    // A replayed capture brings its own entry events.
+    if (UQuestEventRecorderSubsystem::IsReplayingCapture(GetWorld()))
+    {
+        return;
+    }
+
+    for (const FRegionEntry& Entry : Entries)
+    {
+        if (UQuestManagerComponent* QuestManager = Entry.QuestManager.Get())
+        {
+            FObjectiveEventData E;
+            E.EventTag = Entry.Tag;
+            E.ResponsiblePlayerController = Entry.PlayerController.Get();
+            E.TriggeringActor = Entry.Pawn.Get();
+            QuestManager->NotifyEvent(E);
+        }
+    }
+}
+
+AActor* UQuestLocationSubsystem::GetPlayerPawn(const AActor* Owner, APlayerController*& OutPlayerController)
+{
+    APawn* Pawn = nullptr;
+    if (const APlayerState* PlayerState = Cast<APlayerState>(Owner))
+    {
+        Pawn = PlayerState->GetPawn();
+    }
+    else if (const AController* Controller = Cast<AController>(Owner))
+    {
+        Pawn = Controller->GetPawn();
+    }
+    else
+    {
+        Pawn = const_cast<APawn*>(Cast<APawn>(Owner));
+    }
+
+    OutPlayerController = Pawn ? Cast<APlayerController>(Pawn->GetController()) : nullptr;
+    return Pawn;
+}
+
+TStatId UQuestLocationSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UQuestLocationSubsystem, STATGROUP_Quests);
+}
+
+void UQuestLocationSubsystem::Deinitialize()
+{
+    Regions.Empty();
+    FreeRegions.Empty();
+    RegionIndices.Empty();
+    Cells.Empty();
+    Players.Empty();
+
+    Super::Deinitialize();
+}
@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestMemoryReport.h"
+#include "QuestSystem/QuestNode.h"
+#include "QuestSystem/QuestDefinitionSubsystem.h"
+#include "QuestSystem/QuestProgressSubsystem.h"
+#include "QuestManagerComponent.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+#include "Engine/World.h"
+
+static TAutoConsoleVariable<int32> CVarQuestMemoryBudgetQuestKB(
+    TEXT("quest.MemoryBudget.QuestKB"),
+    0,
+    TEXT("Memory budget of one quest definition (quest + objectives), in KB. 0 disables the check."));
+
+static TAutoConsoleVariable<int32> CVarQuestMemoryBudgetPlayerKB(
+    TEXT("quest.MemoryBudget.PlayerKB"),
+    0,
+    TEXT("Memory budget of one player's quest state, in KB. 0 disables the check."));
+
+namespace QuestMemoryReport
+{
+    int64 GetQuestBudgetBytes()
+    {
+        return static_cast<int64>(CVarQuestMemoryBudgetQuestKB.GetValueOnGameThread()) * 1024;
+    }
+
+    int64 GetPlayerBudgetBytes()
+    {
+        return static_cast<int64>(CVarQuestMemoryBudgetPlayerKB.GetValueOnGameThread()) * 1024;
+    }
+
+    SIZE_T GetDefinitionSize(const UQuestNode* Quest)
+    {
+        if (!IsValid(Quest))
+        {
+            return 0;
+        }
+
+        // FArchiveCountMem doesn't follow object references, so the instanced objectives are counted one by one.
+        SIZE_T Size = FArchiveCountMem(const_cast<UQuestNode*>(Quest)).GetMax();
+        for (const UObjective* Objective : Quest->Objectives)
+        {
+            if (IsValid(Objective))
+            {
+                Size += FArchiveCountMem(const_cast<UObjective*>(Objective)).GetMax();
+            }
+        }
+        return Size;
+    }
+
+    static bool IsOverBudget(SIZE_T Bytes, int64 BudgetBytes)
+    {
+        return BudgetBytes > 0 && static_cast<int64>(Bytes) > BudgetBytes;
+    }
+
+    int32 ReportDefinitions(TConstArrayView<const UQuestNode*> Quests, FOutputDevice& Ar)
+    {
+        TArray<TPair<const UQuestNode*, SIZE_T>> Sizes;
+        SIZE_T Total = 0;
+        for (const UQuestNode* Quest : Quests)
+        {
+            const SIZE_T Size = GetDefinitionSize(Quest);
+            Sizes.Add({ Quest, Size });
+            Total += Size;
+        }
+        Sizes.Sort([](const TPair<const UQuestNode*, SIZE_T>& A, const TPair<const UQuestNode*, SIZE_T>& B) { return A.Value > B.Value; });
+
+        const int64 Budget = GetQuestBudgetBytes();
+        int32 NumOverBudget = 0;
+        Ar.Logf(TEXT("Quest definitions: %d quests, %.1f KB"), Quests.Num(), Total / 1024.0);
+        for (const TPair<const UQuestNode*, SIZE_T>& Entry : Sizes)
+        {
+            const bool bOverBudget = IsOverBudget(Entry.Value, Budget);
+            NumOverBudget += bOverBudget ? 1 : 0;
+            Ar.Logf(TEXT("  %8.1f KB  %2d objectives  %s%s"), Entry.Value / 1024.0, Entry.Key->Objectives.Num(), *GetPathNameSafe(Entry.Key), bOverBudget ? TEXT("  OVER BUDGET") : TEXT(""));
+        }
+        return NumOverBudget;
+    }
+
+    int32 ReportWorld(UWorld* World, FOutputDevice& Ar)
+    {
+        TArray<UQuestManagerComponent*> QuestManagers;
+        for (TObjectIterator<UQuestManagerComponent> It; It; ++It)
+        {
+            if (It->GetWorld() == World && !It->IsTemplate())
+            {
+                QuestManagers.Add(*It);
+            }
+        }
+
+        // Per quest: how many players have it active, and what their state for it costs.
+        struct FQuestRuntimeUsage
+        {
+            int32 NumPlayers = 0;
+            SIZE_T RuntimeBytes = 0;
+        };
+        TMap<const UQuestNode*, FQuestRuntimeUsage> RuntimeUsage;
+        for (const UQuestManagerComponent* QuestManager : QuestManagers)
+        {
+            for (const FQuestRuntimeState& State : QuestManager->ActiveQuests.Items)
+            {
+                FQuestRuntimeUsage& Usage = RuntimeUsage.FindOrAdd(State.Quest);
+                ++Usage.NumPlayers;
+                Usage.RuntimeBytes += sizeof(FQuestRuntimeState) + State.ObjectiveProgress.Values.GetAllocatedSize()
+                    + State.Quest->Objectives.Num() * UQuestProgressSubsystem::GetBytesPerRow();
+            }
+        }
+
+        TArray<const UQuestNode*> Quests;
+        if (const UQuestDefinitionSubsystem* Definitions = UQuestDefinitionSubsystem::Get())
+        {
+            const FQuestGraph& Graph = Definitions->GetQuestGraph();
+            for (int32 QuestId = 0; QuestId < Graph.Num(); ++QuestId)
+            {
+                Quests.Add(Graph.GetQuest(QuestId));
+            }
+        }
+        int32 NumOverBudget = ReportDefinitions(Quests, Ar);
+
+        Ar.Logf(TEXT("Active quest state by quest:"));
+        for (const TPair<const UQuestNode*, FQuestRuntimeUsage>& Entry : RuntimeUsage)
+        {
+            Ar.Logf(TEXT("  %8.1f KB  %5d players  %s"), Entry.Value.RuntimeBytes / 1024.0, Entry.Value.NumPlayers, *GetPathNameSafe(Entry.Key));
+        }
+
+        const int64 Budget = GetPlayerBudgetBytes();
+        SIZE_T Total = 0;
+        Ar.Logf(TEXT("Quest state by player (%d players):"), QuestManagers.Num());
+        Ar.Logf(TEXT("  %8s %8s %8s %8s %8s %8s %8s  Player"), TEXT("Total"), TEXT("Active"), TEXT("Rows"), TEXT("Done"), TEXT("Index"), TEXT("Queue"), TEXT("Deleg."));
+        for (const UQuestManagerComponent* QuestManager : QuestManagers)
+        {
+            FQuestPlayerMemory Memory;
+            QuestManager->GetMemoryUsage(Memory);
+            Total += Memory.GetTotal();
+
+            const bool bOverBudget = IsOverBudget(Memory.GetTotal(), Budget);
+            NumOverBudget += bOverBudget ? 1 : 0;
+            Ar.Logf(TEXT("  %8llu %8llu %8llu %8llu %8llu %8llu %8llu  %s%s"),
+                static_cast<uint64>(Memory.GetTotal()), static_cast<uint64>(Memory.ActiveQuestBytes), static_cast<uint64>(Memory.ProgressRowBytes),
+                static_cast<uint64>(Memory.CompletionBytes), static_cast<uint64>(Memory.EventIndexBytes), static_cast<uint64>(Memory.EventQueueBytes),
+                static_cast<uint64>(Memory.DelegateBytes), *GetNameSafe(QuestManager->GetOwner()), bOverBudget ? TEXT("  OVER BUDGET") : TEXT(""));
+        }
+        Ar.Logf(TEXT("Quest state total: %.1f KB, %.1f KB per player"), Total / 1024.0, QuestManagers.Num() > 0 ? Total / 1024.0 / QuestManagers.Num() : 0.0);
+
+        if (NumOverBudget > 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("QuestMemoryReport: %d quests/players are over their memory budget."), NumOverBudget);
+        }
+        return NumOverBudget;
+    }
+}
+
+static FAutoConsoleCommandWithWorldAndArgs QuestMemReportCommand(
+    TEXT("Quest.MemReport"),
+    TEXT("Prints the memory used by quest definitions, per quest and per player, flagging entries over quest.MemoryBudget.*."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        QuestMemoryReport::ReportWorld(World, *GLog);
+    }));
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestMemoryReportCommandlet.h"
+#include "QuestSystem/QuestMemoryReport.h"
+#include "QuestSystem/QuestNode.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "HAL/IConsoleManager.h"
+
+UQuestMemoryReportCommandlet::UQuestMemoryReportCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 UQuestMemoryReportCommandlet::Main(const FString& Params)
+{
+    int32 QuestBudgetKB = 0;
+    if (FParse::Value(*Params, TEXT("QuestBudgetKB="), QuestBudgetKB))
+    {
+        if (IConsoleVariable* BudgetVar = IConsoleManager::Get().FindConsoleVariable(TEXT("quest.MemoryBudget.QuestKB")))
+        {
+            BudgetVar->Set(QuestBudgetKB, ECVF_SetByCommandline);
+        }
+    }
+
+    IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+    AssetRegistry.SearchAllAssets(true);
+
+    TArray<FAssetData> QuestAssets;
+    AssetRegistry.GetAssetsByClass(UQuestNode::StaticClass()->GetClassPathName(), QuestAssets, true);
+
+    TArray<const UQuestNode*> Quests;
+    for (const FAssetData& Asset : QuestAssets)
+    {
+        if (const UQuestNode* Quest = Cast<UQuestNode>(Asset.GetAsset()))
+        {
+            Quests.Add(Quest);
+        }
+    }
+
+    const int32 NumOverBudget = QuestMemoryReport::ReportDefinitions(Quests, *GLog);
+    if (NumOverBudget > 0)
+    {
+        UE_LOG(LogTemp, Error, TEXT("QuestMemoryReport: %d of %d quests are over the %lld KB budget."), NumOverBudget, Quests.Num(), QuestMemoryReport::GetQuestBudgetBytes() / 1024);
+        return 1;
+    }
+    return 0;
+}
@@ -3,7 +3,11 @@
 
 #include "QuestSystem/QuestNode.h"
 #include "QuestSystem/Objective.h" // Include your Objective base class
+#include "QuestManagerComponent.h" // Per-player quest state (completed quests) lives here
+#include "QuestSystem/QuestDefinitionSubsystem.h"
 #include "Engine/World.h" // Needed for GetWorld() or similar contexts
+#include "QuestSystem/QuestStats.h"
+#include "UObject/Package.h"
 
 // --- CONSTRUCTORS ---
 
@@ -11,8 +15,6 @@ UQuestNode::UQuestNode(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer)
     , QuestName(FText::FromString("Default Quest Name"))
     , QuestDescription(FText::FromString("Default Quest Description"))
-    , bIsAvailable(true)
-    , bIsCompleted(false)
     , PrerequisiteQuests()
     , FollowUpQuests()
     , Objectives()
@@ -23,15 +25,15 @@ UQuestNode::UQuestNode(FText InQuestName, FText InQuestDescription, TArray<UObje
     : Super(ObjectInitializer)
     , QuestName(InQuestName)
     , QuestDescription(InQuestDescription)
-    , bIsAvailable(InPrerequisiteQuests.IsEmpty())
-    , bIsCompleted(false)
 	, PrerequisiteQuests(InPrerequisiteQuests)
 	, FollowUpQuests() // Initialize FollowUpQuests as an empty array
 	, Objectives(InObjectives)
 {
     for (UQuestNode* Prerequisite : InPrerequisiteQuests)
     {
-        if (IsValid(Prerequisite))
+        // A clustered prerequisite can't take new references (see AddFollowup). The quest graph still links the two
+        // once this quest is registered, since it compiles the edges from PrerequisiteQuests.
+        if (IsValid(Prerequisite) && !UQuestDefinitionSubsystem::IsClustered(Prerequisite))
         {
             Prerequisite->AddFollowup(this); // Add this quest as a follow-up to each prerequisite
         }
@@ -42,66 +44,51 @@ UQuestNode::UQuestNode(FText InQuestName, FText InQuestDescription, TArray<UObje
 
 // --- FUNCTIONS (IMPLEMENTATIONS) ---
 
-void UQuestNode::InitializeQuestObjectives(AActor* OwningActor)
+void UQuestNode::InitializeQuestObjectives(AActor* OwningActor) const
 {
-    // First, unbind any existing events to ensure a clean state upon re-initialization
-    UninitializeQuestObjectives();
+    SCOPE_CYCLE_COUNTER(STAT_Quest_InitializeObjectives);
 
-    bIsCompleted = false; // Reset completion status when initializing/re-initializing
+    UE_LOG(LogTemp, Log, TEXT("UQuestNode '%s' initializing %d objectives for '%s'."), *QuestName.ToString(), Objectives.Num(), *GetNameSafe(OwningActor));
 
-    bIsAvailable = true; // You might set this to true here, or have separate logic for availability
-    for (UQuestNode* Prerequisite : PrerequisiteQuests)
-    {
-        if (IsValid(Prerequisite) && !Prerequisite->bIsCompleted)
-        {
-            bIsAvailable = false; // If any prerequisite is not completed, this quest cannot be available
-            UE_LOG(LogTemp, Warning, TEXT("UQuestNode '%s' cannot be initialized because prerequisite '%s' is not completed."), *QuestName.ToString(), *Prerequisite->QuestName.ToString());
-            return; // Exit early if prerequisites are not met
-        }
-	}
-
-    UE_LOG(LogTemp, Log, TEXT("UQuestNode '%s' initializing %d objectives."), *QuestName.ToString(), Objectives.Num());
-
-    for (UObjective* Objective : Objectives)
+    for (const UObjective* Objective : Objectives)
     {
         if (IsValid(Objective))
         {
-            // Call the Objective's Initialize method (BlueprintNativeEvent, so use Execute_ prefix if Blueprintable)
+            // Call the Objective's Initialize method (BlueprintNativeEvent, so Blueprint overrides are honored)
             Objective->InitializeObjective(OwningActor);
         }
         else 
         {
-			Objectives.Remove(Objective); // Remove invalid objectives from the list
             UE_LOG(LogTemp, Warning, TEXT("UQuestNode '%s' has an invalid objective."), *QuestName.ToString());
         }
     }
-
-    // After all objectives are initialized, bind to their completion events.
-    BindToObjectiveCompletionEvents();
 }
 
-void UQuestNode::UninitializeQuestObjectives()
+void UQuestNode::UninitializeQuestObjectives(AActor* OwningActor) const
 {
-    // Unbind all objective completion events to prevent memory leaks and unnecessary calls.
-    UnbindFromObjectiveCompletionEvents();
-
-    UE_LOG(LogTemp, Log, TEXT("UQuestNode '%s' uninitializing all objectives."), *QuestName.ToString());
+    UE_LOG(LogTemp, Log, TEXT("UQuestNode '%s' uninitializing all objectives for '%s'."), *QuestName.ToString(), *GetNameSafe(OwningActor));
 
     // Call uninitialize on each objective as well
-    for (UObjective* Objective : Objectives)
+    for (const UObjective* Objective : Objectives)
     {
         if (IsValid(Objective))
         {
-            Objective->UninitializeObjective(); // Call the Objective's Uninitialize
+            Objective->UninitializeObjective(OwningActor); // Call the Objective's Uninitialize
         }
     }
 }
 
-bool UQuestNode::IsQuestCompleted() const
+bool UQuestNode::IsQuestCompleted(const UQuestManagerComponent* QuestManager) const
 {
-    for (const UObjective* Objective : Objectives)
+    if (!IsValid(QuestManager))
+    {
+        return false;
+    }
+
+    for (int32 Index = 0; Index < Objectives.Num(); ++Index)
     {
-        if (IsValid(Objective) && !Objective->IsObjectiveCurrentlyComplete())
+        const UObjective* Objective = Objectives[Index];
+        if (IsValid(Objective) && !Objective->IsObjectiveCurrentlyComplete(QuestManager->GetObjectiveProgress(this, Index)))
         {
             // Found at least one objective that is not yet complete.
             return false;
@@ -113,6 +100,14 @@ bool UQuestNode::IsQuestCompleted() const
 
 void UQuestNode::AddFollowup(UQuestNode* InFollowUpQuest)
 {
+    // Garbage collection doesn't trace the references of a clustered quest, so a follow-up added now could be
+    // collected while this quest still points to it. Quest lines have to be built before they are registered.
+    if (!ensureMsgf(!UQuestDefinitionSubsystem::IsClustered(this), TEXT("Quest '%s' is in a GC cluster and can't take follow-up '%s'."),
+        *QuestName.ToString(), *GetNameSafe(InFollowUpQuest)))
+    {
+        return;
+    }
+
     if (IsValid(InFollowUpQuest) && !FollowUpQuests.Contains(InFollowUpQuest))
     {
         FollowUpQuests.Add(InFollowUpQuest);
@@ -123,104 +118,24 @@ void UQuestNode::AddFollowup(UQuestNode* InFollowUpQuest)
 }
 
 // Default C++ implementation for BlueprintNativeEvent
-bool UQuestNode::IsQuestAvailable_Implementation() const
+bool UQuestNode::IsQuestAvailable_Implementation(const UQuestManagerComponent* QuestManager) const
 {
-    // Default logic: a quest can be taken if it's available and all its prerequisites are met.
-    if (!bIsAvailable)
-    {
-        return false;
-    }
-
-    // You would typically check if the player's QuestManagerComponent indicates prerequisites are complete.
-    // For now, let's assume they are if the quest is available.
-    // Example:
-    // UQuestManagerComponent* QuestManager = ... get from PlayerController->PlayerState ...
-    // for (UQuestNode* Prereq : Prerequisites)
-    // {
-    //     if (IsValid(Prereq) && !QuestManager->HasQuestCompleted(Prereq))
-    //     // This would require HasQuestCompleted on QuestManagerComponent.
-    //     {
-    //         return false;
-    //     }
-    // }
-
-    return true; // Placeholder: Add real prerequisite checking logic here.
+    // Default logic: a quest can be taken once the player has completed all its prerequisites.
+    // The quest manager keeps a remaining-prerequisites counter per quest, so this is a lookup rather than a walk.
+    return IsValid(QuestManager) && QuestManager->GetNumRemainingPrerequisites(this) == 0;
 }
 
 // Default C++ implementation for BlueprintNativeEvent
-void UQuestNode::OnQuestCompleted_Implementation()
+void UQuestNode::OnQuestCompleted_Implementation(UQuestManagerComponent* QuestManager)
 {
-    UE_LOG(LogTemp, Log, TEXT("UQuestNode '%s' C++ OnQuestCompleted_Implementation called."), *QuestName.ToString());
-    // Example: Trigger follow-up quests availability
-    for (UQuestNode* FollowUp : FollowUpQuests)
-    {
-        if (IsValid(FollowUp))
-        {
-            FollowUp->bIsAvailable = true; // Make follow-up quests available
-            FollowUp->OnQuestUnlocked(); // Call its unlock event (BlueprintImplementableEvent)
-            UE_LOG(LogTemp, Log, TEXT("UQuestNode '%s' unlocked follow-up quest '%s'."), *QuestName.ToString(), *FollowUp->QuestName.ToString());
-        }
-    }
+    UE_LOG(LogTemp, Log, TEXT("UQuestNode '%s' C++ OnQuestCompleted_Implementation called for '%s'."), *QuestName.ToString(), *GetNameSafe(QuestManager ? QuestManager->GetOwner() : nullptr));
 
     // Any other C++ specific completion logic
 }
 
-// --- INTERNAL HELPER FUNCTIONS ---
-
-void UQuestNode::OnObjectiveCompleted(UObjective* CompletedObjective)
+bool UQuestNode::CanBeClusterRoot() const
 {
-    UE_LOG(LogTemp, Log, TEXT("UQuestNode '%s': Received completion for objective '%s'."), *QuestName.ToString(), *CompletedObjective->ObjectiveDescription.ToString());
-
-    // After an objective completes, immediately unbind from its specific delegate
-    // to prevent further calls and cleanup.
-    if (IsValid(CompletedObjective))
-    {
-        CompletedObjective->OnObjectiveCompletedDelegate.RemoveDynamic(this, &UQuestNode::OnObjectiveCompleted);
-        // Also call Uninitialize on the specific objective if it has bindings to global events
-        CompletedObjective->UninitializeObjective();
-    }
-
-    // Check if all objectives are now complete.
-    if (IsQuestCompleted())
-    {
-        bIsCompleted = true; // Mark the quest as completed
-        UE_LOG(LogTemp, Log, TEXT("UQuestNode '%s': All objectives completed!"), *QuestName.ToString());
-
-        // Call the BlueprintNativeEvent for quest completion
-        OnQuestCompleted();
-
-        // Broadcast the delegate to notify the UQuestManagerComponent (or other listeners)
-        OnQuestCompletedDelegate.Broadcast(this);
-
-        // Crucial: Unbind from ALL remaining objective events for this quest,
-        // as the quest is now fully completed.
-        UnbindFromObjectiveCompletionEvents();
-    }
+    // Only top-level quests: the cluster would also take in the outer of a quest created inside another object
+    // (e.g., a game mode's generated quests).
+    return GetOuter() && GetOuter()->IsA<UPackage>();
 }
-
-void UQuestNode::BindToObjectiveCompletionEvents()
-{
-    for (UObjective* Objective : Objectives)
-    {
-        if (IsValid(Objective))
-        {
-            // Bind our callback function to each objective's completion delegate.
-            Objective->OnObjectiveCompletedDelegate.AddDynamic(this, &UQuestNode::OnObjectiveCompleted);
-            UE_LOG(LogTemp, Log, TEXT("UQuestNode '%s' bound to objective '%s'."), *QuestName.ToString(), *Objective->ObjectiveDescription.ToString());
-        }
-    }
-}
-
-void UQuestNode::UnbindFromObjectiveCompletionEvents()
-{
-    for (UObjective* Objective : Objectives)
-    {
-        if (IsValid(Objective))
-        {
-            // Remove the binding. This is important for garbage collection and preventing calls
-            // on invalid objects if the objective or quest is destroyed.
-            Objective->OnObjectiveCompletedDelegate.RemoveDynamic(this, &UQuestNode::OnObjectiveCompleted);
-            UE_LOG(LogTemp, Log, TEXT("UQuestNode '%s' unbound from objective '%s'."), *QuestName.ToString(), *Objective->ObjectiveDescription.ToString());
-        }
-    }
-}
\ No newline at end of file
@@ -0,0 +1,177 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestPlayerRegistrySubsystem.h"
+#include "QuestSystem/QuestStats.h"
+#include "QuestManagerComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+
+namespace QuestPlayerRegistry
+{
+    // Removes Key from Map if it still points to QuestManager. Another manager may have taken the key over since
+    // (e.g., a reconnecting player's new PlayerState), and must stay findable.
+    template <typename MapType, typename KeyType>
+    void RemoveIfOwned(MapType& Map, const KeyType& Key, const UQuestManagerComponent* QuestManager)
+    {
+        if (const TWeakObjectPtr<UQuestManagerComponent>* Found = Map.Find(Key); Found && Found->Get() == QuestManager)
+        {
+            Map.Remove(Key);
+        }
+    }
+}
+
+bool UQuestPlayerRegistrySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    const UWorld* World = Cast<UWorld>(Outer);
+    return Super::ShouldCreateSubsystem(Outer) && World && World->IsGameWorld();
+}
+
+void UQuestPlayerRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    PostLoginHandle = FGameModeEvents::GameModePostLoginEvent.AddUObject(this, &UQuestPlayerRegistrySubsystem::OnPostLogin);
+}
+
+void UQuestPlayerRegistrySubsystem::Deinitialize()
+{
+    FGameModeEvents::GameModePostLoginEvent.Remove(PostLoginHandle);
+
+    Entries.Empty();
+    ByOwner.Empty();
+    ByController.Empty();
+    ByUniqueNetId.Empty();
+
+    Super::Deinitialize();
+}
+
+// --- REGISTRATION ---
+
+void UQuestPlayerRegistrySubsystem::RegisterQuestManager(UQuestManagerComponent* QuestManager)
+{
+    LLM_SCOPE_BYTAG(Quests_Runtime);
+
+    if (!IsValid(QuestManager) || !QuestManager->GetOwner())
+    {
+        return;
+    }
+
+    FEntry& Entry = Entries.FindOrAdd(QuestManager);
+    Entry.Owner = QuestManager->GetOwner();
+    ByOwner.Add(Entry.Owner, QuestManager);
+    IndexPlayerIds(QuestManager);
+}
+
+void UQuestPlayerRegistrySubsystem::UnregisterQuestManager(UQuestManagerComponent* QuestManager)
+{
+    FEntry Entry;
+    if (!Entries.RemoveAndCopyValue(QuestManager, Entry))
+    {
+        return;
+    }
+
+    using QuestPlayerRegistry::RemoveIfOwned;
+    RemoveIfOwned(ByOwner, Entry.Owner, QuestManager);
+    RemoveIfOwned(ByController, Entry.Controller, QuestManager);
+    if (Entry.UniqueNetId.IsValid())
+    {
+        RemoveIfOwned(ByUniqueNetId, Entry.UniqueNetId, QuestManager);
+    }
+}
+
+void UQuestPlayerRegistrySubsystem::IndexPlayerIds(UQuestManagerComponent* QuestManager)
+{
+    FEntry* Entry = Entries.Find(QuestManager);
+    const APlayerState* PlayerState = QuestManager->GetOwner<APlayerState>();
+    if (!Entry || !PlayerState)
+    {
+        return;
+    }
+
+    if (AController* Controller = PlayerState->GetOwningController())
+    {
+        if (Entry->Controller != Controller)
+        {
+            QuestPlayerRegistry::RemoveIfOwned(ByController, Entry->Controller, QuestManager);
+            Entry->Controller = Controller;
+        }
+        ByController.Add(Controller, QuestManager);
+    }
+
+    const FUniqueNetIdRepl& UniqueNetId = PlayerState->GetUniqueId();
+    if (UniqueNetId.IsValid())
+    {
+        if (Entry->UniqueNetId.IsValid() && Entry->UniqueNetId != UniqueNetId)
+        {
+            QuestPlayerRegistry::RemoveIfOwned(ByUniqueNetId, Entry->UniqueNetId, QuestManager);
+        }
+        Entry->UniqueNetId = UniqueNetId;
+        ByUniqueNetId.Add(UniqueNetId, QuestManager);
+    }
+}
+
+void UQuestPlayerRegistrySubsystem::OnPostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer)
+{
+    if (NewPlayer && NewPlayer->GetWorld() == GetWorld())
+    {
+        if (UQuestManagerComponent* QuestManager = FindByOwner(NewPlayer->PlayerState))
+        {
+            IndexPlayerIds(QuestManager);
+        }
+    }
+}
+
+// --- LOOKUP ---
+
+UQuestManagerComponent* UQuestPlayerRegistrySubsystem::FindByOwner(const AActor* Owner) const
+{
+    const TWeakObjectPtr<UQuestManagerComponent>* Found = Owner ? ByOwner.Find(Owner) : nullptr;
+    return Found ? Found->Get() : nullptr;
+}
+
+UQuestManagerComponent* UQuestPlayerRegistrySubsystem::FindByController(const AController* Controller)
+{
+    if (!Controller)
+    {
+        return nullptr;
+    }
+    if (const TWeakObjectPtr<UQuestManagerComponent>* Found = ByController.Find(Controller))
+    {
+        if (UQuestManagerComponent* QuestManager = Found->Get())
+        {
+            return QuestManager;
+        }
+    }
+
+    // Not indexed yet: go through the PlayerState once and remember the controller.
+    UQuestManagerComponent* QuestManager = FindByOwner(Controller->PlayerState);
+    if (QuestManager)
+    {
+        IndexPlayerIds(QuestManager);
+    }
+    return QuestManager;
+}
+
+UQuestManagerComponent* UQuestPlayerRegistrySubsystem::FindByUniqueNetId(const FUniqueNetIdRepl& UniqueNetId) const
+{
+    const TWeakObjectPtr<UQuestManagerComponent>* Found = UniqueNetId.IsValid() ? ByUniqueNetId.Find(UniqueNetId) : nullptr;
+    return Found ? Found->Get() : nullptr;
+}
+
+// --- EVENTS ---
+
+bool UQuestPlayerRegistrySubsystem::NotifyEventForPlayer(const FObjectiveEventData& E)
+{
+    UQuestManagerComponent* QuestManager = FindByController(E.ResponsiblePlayerController);
+    if (!QuestManager)
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("QuestPlayerRegistrySubsystem: No quest manager for '%s', dropping event '%s'."), *GetNameSafe(E.ResponsiblePlayerController), *E.EventTag.ToString());
+        return false;
+    }
+
+    QuestManager->NotifyEvent(E);
+    return true;
+}
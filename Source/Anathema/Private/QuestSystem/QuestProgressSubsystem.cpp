@@ -0,0 +1,541 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestProgressSubsystem.h"
+#include "QuestSystem/QuestNode.h"
+#include "QuestSystem/QuestEventTags.h"
+#include "QuestSystem/QuestStats.h"
+#include "QuestSystem/QuestEventRecorderSubsystem.h"
+#include "Engine/World.h"
+#include "QuestManagerComponent.h"
+#include "Async/ParallelFor.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarQuestPoolTrimInterval(
+    TEXT("quest.Pool.TrimInterval"),
+    30.0f,
+    TEXT("Seconds between checks for trimming the quest progress pools. 0 disables automatic trimming."));
+
+static TAutoConsoleVariable<float> CVarQuestPoolTrimMaxAllocationsPerSecond(
+    TEXT("quest.Pool.TrimMaxAllocationsPerSecond"),
+    5.0f,
+    TEXT("The pools are only trimmed if fewer quests than this were started per second since the last check."));
+
+static FAutoConsoleCommandWithWorldAndArgs QuestPoolTrimCommand(
+    TEXT("Quest.Pool.Trim"),
+    TEXT("Trims the quest progress pools now and logs their state."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+    {
+        if (UQuestProgressSubsystem* Progress = World ? World->GetSubsystem<UQuestProgressSubsystem>() : nullptr)
+        {
+            Progress->TrimPools();
+            Progress->LogPoolStats();
+        }
+    }));
+
+void UQuestProgressSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UQuestProgressSubsystem::OnWorldPostActorTick);
+}
+
+void UQuestProgressSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+    if (InWorld == GetWorld())
+    {
+        QuestStats::FScopedGameThreadCycles CycleScope;
+        QuestStats::RecordFrameTotals(NumActiveQuests, Players.Num() - FreePlayerIndices.Num());
+        TrimPoolsIfIdle();
+    }
+}
+
+// --- PLAYERS ---
+
+int32 UQuestProgressSubsystem::RegisterPlayer(UQuestManagerComponent* QuestManager)
+{
+    LLM_SCOPE_BYTAG(Quests_Runtime);
+
+    if (FreePlayerIndices.Num() > 0)
+    {
+        const int32 PlayerIndex = FreePlayerIndices.Pop(EAllowShrinking::No);
+        Players[PlayerIndex] = QuestManager;
+        return PlayerIndex;
+    }
+    return Players.Add(QuestManager);
+}
+
+void UQuestProgressSubsystem::UnregisterPlayer(int32 PlayerIndex)
+{
+    if (!Players.IsValidIndex(PlayerIndex))
+    {
+        return;
+    }
+
+    // Free any rows the player still owns (e.g., quests that were active when the player left).
+    for (int32 Row = 0; Row < RowPlayer.Num(); ++Row)
+    {
+        if (RowPlayer[Row] == PlayerIndex && RowObjectiveIndex[Row] == 0)
+        {
+            FreeQuestRows(Row);
+        }
+    }
+
+    Players[PlayerIndex].Reset();
+    FreePlayerIndices.Add(PlayerIndex);
+}
+
+UQuestManagerComponent* UQuestProgressSubsystem::GetQuestManager(int32 PlayerIndex) const
+{
+    return Players.IsValidIndex(PlayerIndex) ? Players[PlayerIndex].Get() : nullptr;
+}
+
+// --- PROGRESS ROWS ---
+
+int32 UQuestProgressSubsystem::AllocateQuestRows(int32 PlayerIndex, UQuestNode* Quest)
+{
+    LLM_SCOPE_BYTAG(Quests_Runtime);
+
+    const int32 NumObjectives = Quest->Objectives.Num();
+    check(NumObjectives <= MAX_uint8 + 1);
+
+    // A quest without objectives has nothing to track. Handing out RowPlayer.Num() instead would alias whatever
+    // block is appended next.
+    if (NumObjectives == 0)
+    {
+        return INDEX_NONE;
+    }
+
+    IndexObjectiveDefinitions(Quest);
+
+    // Reuse a freed block of the same size if there is one, otherwise grow every column.
+    int32 FirstRow = INDEX_NONE;
+    FRowBlockPool& Pool = RowBlockPools.FindOrAdd(NumObjectives);
+    if (Pool.FreeBlocks.Num() > 0)
+    {
+        FirstRow = Pool.FreeBlocks.Pop(EAllowShrinking::No);
+    }
+    else
+    {
+        FirstRow = RowPlayer.AddUninitialized(NumObjectives);
+        RowQuest.AddUninitialized(NumObjectives);
+        RowObjective.AddUninitialized(NumObjectives);
+        RowObjectiveIndex.AddUninitialized(NumObjectives);
+        RowProgress.AddUninitialized(NumObjectives);
+        RowCompleted.AddUninitialized(NumObjectives);
+    }
+
+    for (int32 Index = 0; Index < NumObjectives; ++Index)
+    {
+        const int32 Row = FirstRow + Index;
+        RowPlayer[Row] = PlayerIndex;
+        RowQuest[Row] = Quest;
+        RowObjective[Row] = Quest->Objectives[Index];
+        RowObjectiveIndex[Row] = static_cast<uint8>(Index);
+        RowProgress[Row] = 0;
+        RowCompleted[Row] = false;
+    }
+
+    ++Pool.NumInUse;
+    Pool.HighWaterMark = FMath::Max(Pool.HighWaterMark, Pool.NumInUse);
+    Pool.PeakInUse = FMath::Max(Pool.PeakInUse, Pool.NumInUse);
+    ++NumAllocationsSinceTrimCheck;
+
+    NumAllocatedRows += NumObjectives;
+    ++NumActiveQuests;
+    return FirstRow;
+}
+
+void UQuestProgressSubsystem::FreeQuestRows(int32 FirstRow)
+{
+    if (!RowPlayer.IsValidIndex(FirstRow) || RowPlayer[FirstRow] == INDEX_NONE)
+    {
+        return;
+    }
+
+    // Rows of a block share the quest, so its objective count gives the block size.
+    const int32 NumObjectives = RowQuest[FirstRow]->Objectives.Num();
+    for (int32 Row = FirstRow; Row < FirstRow + NumObjectives; ++Row)
+    {
+        RowPlayer[Row] = INDEX_NONE;
+        RowQuest[Row] = nullptr;
+        RowObjective[Row] = nullptr;
+        RowCompleted[Row] = true; // Free rows never match events.
+    }
+
+    FRowBlockPool& Pool = RowBlockPools.FindChecked(NumObjectives);
+    Pool.FreeBlocks.Add(FirstRow);
+    --Pool.NumInUse;
+
+    NumAllocatedRows -= NumObjectives;
+    --NumActiveQuests;
+}
+
+void UQuestProgressSubsystem::AcquireCounters(int32 NumObjectives, TArray<int32>& Counters)
+{
+    FRowBlockPool* Pool = RowBlockPools.Find(NumObjectives);
+    if (Pool && Pool->SpareCounters.Num() > 0)
+    {
+        Counters = Pool->SpareCounters.Pop(EAllowShrinking::No);
+    }
+    Counters.SetNumZeroed(NumObjectives);
+}
+
+void UQuestProgressSubsystem::ReleaseCounters(TArray<int32>& Counters)
+{
+    // Only as many spare arrays as free blocks are worth keeping; each one goes with a quest that can reuse a block.
+    FRowBlockPool* Pool = RowBlockPools.Find(Counters.Num());
+    if (Pool && Pool->SpareCounters.Num() < Pool->FreeBlocks.Num())
+    {
+        Counters.Reset();
+        Pool->SpareCounters.Add(MoveTemp(Counters));
+    }
+}
+
+// --- POOLS ---
+
+void UQuestProgressSubsystem::TrimPoolsIfIdle()
+{
+    const float TrimInterval = CVarQuestPoolTrimInterval.GetValueOnGameThread();
+    const double Now = GetWorld()->GetRealTimeSeconds();
+    if (TrimInterval <= 0.0f || Now - LastTrimCheckTime < TrimInterval)
+    {
+        return;
+    }
+
+    const double AllocationsPerSecond = NumAllocationsSinceTrimCheck / (Now - LastTrimCheckTime);
+    if (AllocationsPerSecond < CVarQuestPoolTrimMaxAllocationsPerSecond.GetValueOnGameThread())
+    {
+        TrimPools();
+    }
+    else
+    {
+        // Still busy: start a new window, but keep the high-water marks so the pools don't shrink under load.
+        NumAllocationsSinceTrimCheck = 0;
+        LastTrimCheckTime = Now;
+    }
+}
+
+int32 UQuestProgressSubsystem::TrimPools()
+{
+    SCOPE_CYCLE_COUNTER(STAT_Quest_TrimPools);
+
+    // Each pool keeps enough free blocks to get back to its high-water mark; the rest are released, the ones
+    // furthest down the table first since those leave the least to move.
+    TBitArray<> ReleasedRows(false, RowPlayer.Num());
+    int32 NumReleasedRows = 0;
+    for (TPair<int32, FRowBlockPool>& Entry : RowBlockPools)
+    {
+        FRowBlockPool& Pool = Entry.Value;
+        const int32 NumToKeep = Pool.HighWaterMark - Pool.NumInUse;
+        if (Pool.FreeBlocks.Num() > NumToKeep)
+        {
+            Pool.FreeBlocks.Sort();
+            for (int32 Index = NumToKeep; Index < Pool.FreeBlocks.Num(); ++Index)
+            {
+                ReleasedRows.SetRange(Pool.FreeBlocks[Index], Entry.Key, true);
+                NumReleasedRows += Entry.Key;
+            }
+            Pool.FreeBlocks.SetNum(NumToKeep);
+        }
+        Pool.SpareCounters.SetNum(FMath::Min(Pool.SpareCounters.Num(), Pool.FreeBlocks.Num()));
+        Pool.SpareCounters.Shrink();
+
+        // Start a new window.
+        Pool.HighWaterMark = Pool.NumInUse;
+    }
+    NumAllocationsSinceTrimCheck = 0;
+    LastTrimCheckTime = GetWorld()->GetRealTimeSeconds();
+
+    if (NumReleasedRows == 0)
+    {
+        return 0;
+    }
+
+    // Slide every kept block down over the released ones, in row order. A block starts at the row whose
+    // RowObjectiveIndex is 0 (free rows keep theirs), so block sizes can be read off the table.
+    for (TPair<int32, FRowBlockPool>& Entry : RowBlockPools)
+    {
+        Entry.Value.FreeBlocks.Reset();
+    }
+    const int32 NumRows = RowPlayer.Num();
+    int32 WriteRow = 0;
+    for (int32 Row = 0; Row < NumRows;)
+    {
+        int32 BlockSize = 1;
+        while (Row + BlockSize < NumRows && RowObjectiveIndex[Row + BlockSize] != 0)
+        {
+            ++BlockSize;
+        }
+
+        if (!ReleasedRows[Row])
+        {
+            if (WriteRow != Row)
+            {
+                FMemory::Memmove(&RowPlayer[WriteRow], &RowPlayer[Row], BlockSize * sizeof(int32));
+                FMemory::Memmove(&RowQuest[WriteRow], &RowQuest[Row], BlockSize * sizeof(UQuestNode*));
+                FMemory::Memmove(&RowObjective[WriteRow], &RowObjective[Row], BlockSize * sizeof(const UObjective*));
+                FMemory::Memmove(&RowObjectiveIndex[WriteRow], &RowObjectiveIndex[Row], BlockSize * sizeof(uint8));
+                FMemory::Memmove(&RowProgress[WriteRow], &RowProgress[Row], BlockSize * sizeof(int32));
+                FMemory::Memmove(&RowCompleted[WriteRow], &RowCompleted[Row], BlockSize * sizeof(bool));
+            }
+
+            if (RowPlayer[WriteRow] == INDEX_NONE)
+            {
+                RowBlockPools.FindChecked(BlockSize).FreeBlocks.Add(WriteRow);
+            }
+            else if (WriteRow != Row)
+            {
+                if (UQuestManagerComponent* QuestManager = GetQuestManager(RowPlayer[WriteRow]))
+                {
+                    QuestManager->OnQuestRowsMoved(RowQuest[WriteRow], WriteRow);
+                }
+            }
+            WriteRow += BlockSize;
+        }
+        Row += BlockSize;
+    }
+
+    RowPlayer.SetNum(WriteRow);
+    RowQuest.SetNum(WriteRow);
+    RowObjective.SetNum(WriteRow);
+    RowObjectiveIndex.SetNum(WriteRow);
+    RowProgress.SetNum(WriteRow);
+    RowCompleted.SetNum(WriteRow);
+    RowPlayer.Shrink();
+    RowQuest.Shrink();
+    RowObjective.Shrink();
+    RowObjectiveIndex.Shrink();
+    RowProgress.Shrink();
+    RowCompleted.Shrink();
+
+    UE_LOG(LogTemp, Log, TEXT("QuestProgressSubsystem: Trimmed %d pooled progress rows, %d rows left (%d in use)."), NumReleasedRows, WriteRow, NumAllocatedRows);
+    return NumReleasedRows;
+}
+
+void UQuestProgressSubsystem::LogPoolStats() const
+{
+    UE_LOG(LogTemp, Display, TEXT("QuestProgressSubsystem: %d rows (%d in use), %d active quests."), RowPlayer.Num(), NumAllocatedRows, NumActiveQuests);
+    for (const TPair<int32, FRowBlockPool>& Entry : RowBlockPools)
+    {
+        const FRowBlockPool& Pool = Entry.Value;
+        UE_LOG(LogTemp, Display, TEXT("  %d objectives: %d in use, %d free blocks, %d spare counter arrays, high-water mark %d (peak %d)"),
+            Entry.Key, Pool.NumInUse, Pool.FreeBlocks.Num(), Pool.SpareCounters.Num(), Pool.HighWaterMark, Pool.PeakInUse);
+    }
+}
+
+void UQuestProgressSubsystem::IndexObjectiveDefinitions(const UQuestNode* Quest)
+{
+    LLM_SCOPE_BYTAG(Quests_Definitions);
+
+    bool bAlreadyIndexed = false;
+    IndexedQuests.Add(Quest, &bAlreadyIndexed);
+    if (bAlreadyIndexed)
+    {
+        return;
+    }
+
+    for (const UObjective* Objective : Quest->Objectives)
+    {
+        if (!IsValid(Objective))
+        {
+            continue;
+        }
+
+        if (Objective->HandledEventTags.IsEmpty())
+        {
+            WildcardObjectives.AddUnique(Objective);
+        }
+        TArray<int32, TInlineAllocator<4>> TagIndices;
+        FQuestEventTags::Get().GetEffectiveSubscriptions(Objective->HandledEventTags, TagIndices);
+        for (const int32 TagIndex : TagIndices)
+        {
+            ObjectivesByTag.FindOrAdd(TagIndex).AddUnique(Objective);
+        }
+    }
+}
+
+// --- EVENT PROCESSING ---
+
+void UQuestProgressSubsystem::ProcessEventForPlayers(const FObjectiveEventData& E, const TArray<UQuestManagerComponent*>& QuestManagers)
+{
+    UQuestEventRecorderSubsystem* Recorder = GetWorld()->GetSubsystem<UQuestEventRecorderSubsystem>();
+    if (Recorder && Recorder->IsRecording())
+    {
+        Recorder->RecordGroupEvent(QuestManagers, E);
+    }
+
+    TBitArray<> PlayerMask(false, Players.Num());
+    for (const UQuestManagerComponent* QuestManager : QuestManagers)
+    {
+        const int32 PlayerIndex = IsValid(QuestManager) ? QuestManager->GetProgressPlayerIndex() : INDEX_NONE;
+        if (Players.IsValidIndex(PlayerIndex) && Players[PlayerIndex].Get() == QuestManager)
+        {
+            PlayerMask[PlayerIndex] = true;
+        }
+    }
+
+    ProcessEventForPlayerMask(E, PlayerMask);
+}
+
+void UQuestProgressSubsystem::ProcessEventForAllPlayers(const FObjectiveEventData& E)
+{
+    UQuestEventRecorderSubsystem* Recorder = GetWorld()->GetSubsystem<UQuestEventRecorderSubsystem>();
+    if (Recorder && Recorder->IsRecording())
+    {
+        Recorder->RecordWorldEvent(E);
+    }
+
+    ProcessEventForPlayerMask(E, TBitArray<>(true, Players.Num()));
+}
+
+void UQuestProgressSubsystem::ProcessEventForPlayerMask(const FObjectiveEventData& E, const TBitArray<>& PlayerMask)
+{
+    SCOPE_CYCLE_COUNTER(STAT_Quest_ProcessEventForPlayers);
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(QuestProgress_ProcessEventForPlayers, QuestChannel);
+    INC_DWORD_STAT(STAT_Quest_EventsDispatched);
+    CSV_CUSTOM_STAT(Quests, EventsDispatched, 1, ECsvCustomStatOp::Accumulate);
+    const uint64 StartCycle = FPlatformTime::Cycles64();
+
+    // The handful of objective definitions that want this event. Rows are matched against these by pointer,
+    // so the scan below never dereferences a row's objective unless it is actually going to process it.
+    TArray<const UObjective*, TInlineAllocator<8>> MatchingObjectives;
+    FQuestEventTags& Tags = FQuestEventTags::Get();
+    for (const int32 TagIndex : Tags.GetSelfAndAncestors(Tags.RegisterTag(E.EventTag)))
+    {
+        if (const TArray<const UObjective*>* Objectives = ObjectivesByTag.Find(TagIndex))
+        {
+            MatchingObjectives.Append(*Objectives);
+        }
+    }
+    MatchingObjectives.Append(WildcardObjectives);
+    if (MatchingObjectives.IsEmpty())
+    {
+        return;
+    }
+
+    // Decide once per definition whether it can be evaluated on a worker thread.
+    TArray<bool, TInlineAllocator<8>> MatchingObjectiveIsParallel;
+    for (const UObjective* Objective : MatchingObjectives)
+    {
+        MatchingObjectiveIsParallel.Add(Objective->CanProcessEventsInParallel());
+    }
+
+    // A row that matched the event. Rows whose objective must run on the game thread are evaluated after the scan.
+    struct FRowMatch
+    {
+        int32 Row;
+        UQuestNode* Quest;
+        int32 NewProgress;
+        bool bNeedsGameThread;
+    };
+
+    // Pass 1: scan the table in fixed-size chunks on worker threads. Each chunk only writes its own result list,
+    // and the table is not modified until pass 3, so no locking is needed.
+    const int32 NumRows = RowPlayer.Num();
+    const int32 NumChunks = FMath::DivideAndRoundUp(NumRows, RowsPerParallelChunk);
+    TArray<TArray<FRowMatch>> ChunkMatches;
+    ChunkMatches.SetNum(NumChunks);
+
+    ParallelFor(NumChunks, [&](int32 Chunk)
+    {
+        SCOPE_CYCLE_COUNTER(STAT_Quest_ParallelScanChunk);
+        TArray<FRowMatch>& Matches = ChunkMatches[Chunk];
+        const int32 EndRow = FMath::Min((Chunk + 1) * RowsPerParallelChunk, NumRows);
+        for (int32 Row = Chunk * RowsPerParallelChunk; Row < EndRow; ++Row)
+        {
+            if (RowCompleted[Row] || !PlayerMask[RowPlayer[Row]])
+            {
+                continue;
+            }
+
+            const int32 MatchIndex = MatchingObjectives.Find(RowObjective[Row]);
+            if (MatchIndex == INDEX_NONE)
+            {
+                continue;
+            }
+
+            if (!MatchingObjectiveIsParallel[MatchIndex])
+            {
+                Matches.Add({ Row, RowQuest[Row], RowProgress[Row], true });
+                continue;
+            }
+
+            const int32 NewProgress = RowObjective[Row]->ProcessGameEventThreadSafe(E, RowProgress[Row]);
+            if (NewProgress != RowProgress[Row])
+            {
+                Matches.Add({ Row, RowQuest[Row], NewProgress, false });
+            }
+        }
+    }, NumChunks > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+    // Pass 2: evaluate the remaining rows (e.g., Blueprint objectives) on the game thread, in row order.
+    // Pass 3 collects progress changes, also in row order, so the result doesn't depend on thread scheduling.
+    // Evaluate first, apply afterwards: applying can complete quests, which frees and reuses rows.
+    struct FProgressChange
+    {
+        int32 PlayerIndex;
+        UQuestNode* Quest;
+        int32 ObjectiveIndex;
+        int32 NewProgress;
+    };
+    TArray<FProgressChange> Changes;
+
+    for (TArray<FRowMatch>& Matches : ChunkMatches)
+    {
+        for (FRowMatch& Match : Matches)
+        {
+            // A game-thread objective evaluated before this row may have removed or completed its quest, and the
+            // freed rows may already hold another quest.
+            const int32 Row = Match.Row;
+            if (!RowPlayer.IsValidIndex(Row) || RowPlayer[Row] == INDEX_NONE || RowCompleted[Row] || RowQuest[Row] != Match.Quest)
+            {
+                continue;
+            }
+
+            if (Match.bNeedsGameThread)
+            {
+                SCOPE_CYCLE_COUNTER(STAT_Quest_ProcessGameEvent);
+                Match.NewProgress = RowObjective[Row]->ProcessGameEvent(E, RowProgress[Row]);
+                if (Match.NewProgress == RowProgress[Row])
+                {
+                    continue;
+                }
+            }
+            Changes.Add({ RowPlayer[Row], RowQuest[Row], RowObjectiveIndex[Row], Match.NewProgress });
+        }
+    }
+
+    for (const FProgressChange& Change : Changes)
+    {
+        if (UQuestManagerComponent* QuestManager = GetQuestManager(Change.PlayerIndex))
+        {
+            QuestManager->ApplyObjectiveProgress(Change.Quest, Change.ObjectiveIndex, Change.NewProgress);
+        }
+    }
+
+    QuestStats::TraceEventDispatch(E.EventTag, E.Count, Changes.Num(), StartCycle, FPlatformTime::Cycles64());
+}
+
+void UQuestProgressSubsystem::Deinitialize()
+{
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+    Players.Empty();
+    FreePlayerIndices.Empty();
+    RowPlayer.Empty();
+    RowQuest.Empty();
+    RowObjective.Empty();
+    RowObjectiveIndex.Empty();
+    RowProgress.Empty();
+    RowCompleted.Empty();
+    RowBlockPools.Empty();
+    NumAllocatedRows = 0;
+    NumActiveQuests = 0;
+    ObjectivesByTag.Empty();
+    WildcardObjectives.Empty();
+    IndexedQuests.Empty();
+
+    Super::Deinitialize();
+}
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestRuntimeState.h"
+#include "QuestManagerComponent.h"
+
+bool FQuestObjectiveProgress::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    uint32 NumValues = Values.Num();
+    Ar.SerializeIntPacked(NumValues);
+
+    if (Ar.IsLoading())
+    {
+        // Quests don't have anywhere near this many objectives; treat it as a corrupt packet.
+        if (NumValues > MAX_uint8 + 1)
+        {
+            Ar.SetError();
+            bOutSuccess = false;
+            return false;
+        }
+        Values.SetNumUninitialized(NumValues);
+    }
+
+    for (int32& Value : Values)
+    {
+        uint32 PackedValue = static_cast<uint32>(FMath::Max(Value, 0));
+        Ar.SerializeIntPacked(PackedValue);
+        Value = static_cast<int32>(PackedValue);
+    }
+
+    bOutSuccess = !Ar.IsError();
+    return true;
+}
+
+void FQuestRuntimeStateArray::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+    if (Owner)
+    {
+        Owner->OnQuestLogReplicated();
+    }
+}
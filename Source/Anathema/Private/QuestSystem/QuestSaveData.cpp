@@ -0,0 +1,306 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestSaveData.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+namespace
+{
+    // Writes a field header, lets WritePayload fill in the payload, then patches the payload size.
+    template <typename FunctorType>
+    void WriteField(FMemoryWriter& Ar, FQuestSaveSnapshot::EField FieldId, FunctorType&& WritePayload)
+    {
+        uint16 Id = static_cast<uint16>(FieldId);
+        uint32 PayloadSize = 0;
+        Ar << Id;
+        const int64 SizeOffset = Ar.Tell();
+        Ar << PayloadSize;
+
+        const int64 PayloadStart = Ar.Tell();
+        WritePayload();
+        const int64 PayloadEnd = Ar.Tell();
+
+        PayloadSize = static_cast<uint32>(PayloadEnd - PayloadStart);
+        Ar.Seek(SizeOffset);
+        Ar << PayloadSize;
+        Ar.Seek(PayloadEnd);
+    }
+
+    void SerializeCount(FArchive& Ar, int32& Count)
+    {
+        uint32 PackedCount = static_cast<uint32>(Count);
+        Ar.SerializeIntPacked(PackedCount);
+        Count = static_cast<int32>(PackedCount);
+    }
+}
+
+void FQuestSaveSnapshot::WriteTo(TArray<uint8>& Out) const
+{
+    Out.Reset();
+    FMemoryWriter Ar(Out);
+
+    // Build the name table so each path is written once, however many fields reference it.
+    TArray<FString> Paths;
+    TMap<FSoftObjectPath, int32> PathIndices;
+    auto GetPathIndex = [&Paths, &PathIndices](const FSoftObjectPath& Path) -> uint32
+    {
+        if (const int32* Existing = PathIndices.Find(Path))
+        {
+            return *Existing;
+        }
+        const int32 NewIndex = Paths.Add(Path.ToString());
+        PathIndices.Add(Path, NewIndex);
+        return NewIndex;
+    };
+    for (const FQuestSaveRecord& Record : ActiveQuests) GetPathIndex(Record.Quest);
+    for (const FSoftObjectPath& Quest : CompletedQuests) GetPathIndex(Quest);
+    for (const FQuestSaveCompletion& Completion : CompletionHistory) GetPathIndex(Completion.Quest);
+
+    uint32 FileMagic = Magic;
+    uint16 Version = CurrentVersion;
+    uint16 NumFields = 5;
+    Ar << FileMagic << Version << NumFields;
+
+    WriteField(Ar, EField::QuestPaths, [&]()
+    {
+        int32 NumPaths = Paths.Num();
+        SerializeCount(Ar, NumPaths);
+        for (FString& Path : Paths)
+        {
+            Ar << Path;
+        }
+    });
+
+    WriteField(Ar, EField::ActiveQuests, [&]()
+    {
+        int32 NumRecords = ActiveQuests.Num();
+        SerializeCount(Ar, NumRecords);
+        for (const FQuestSaveRecord& Record : ActiveQuests)
+        {
+            uint32 PathIndex = GetPathIndex(Record.Quest);
+            uint8 Status = static_cast<uint8>(Record.Status);
+            int32 NumValues = Record.ObjectiveProgress.Num();
+            Ar.SerializeIntPacked(PathIndex);
+            Ar << Status;
+            SerializeCount(Ar, NumValues);
+            for (const int32 Value : Record.ObjectiveProgress)
+            {
+                uint32 PackedValue = static_cast<uint32>(FMath::Max(Value, 0));
+                Ar.SerializeIntPacked(PackedValue);
+            }
+        }
+    });
+
+    WriteField(Ar, EField::CompletedQuests, [&]()
+    {
+        int32 NumCompleted = CompletedQuests.Num();
+        SerializeCount(Ar, NumCompleted);
+        for (const FSoftObjectPath& Quest : CompletedQuests)
+        {
+            uint32 PathIndex = GetPathIndex(Quest);
+            Ar.SerializeIntPacked(PathIndex);
+        }
+    });
+
+    WriteField(Ar, EField::CompletionHistory, [&]()
+    {
+        int32 NumEntries = CompletionHistory.Num();
+        SerializeCount(Ar, NumEntries);
+        int64 PreviousTimestamp = 0;
+        for (const FQuestSaveCompletion& Completion : CompletionHistory)
+        {
+            uint32 PathIndex = GetPathIndex(Completion.Quest);
+            uint64 TimestampDelta = static_cast<uint64>(FMath::Max<int64>(Completion.UnixTimestamp - PreviousTimestamp, 0));
+            Ar.SerializeIntPacked(PathIndex);
+            Ar.SerializeIntPacked64(TimestampDelta);
+            PreviousTimestamp = FMath::Max(Completion.UnixTimestamp, PreviousTimestamp);
+        }
+    });
+
+    WriteField(Ar, EField::ObjectiveDeadlines, [&]()
+    {
+        int32 NumRecords = 0;
+        for (const FQuestSaveRecord& Record : ActiveQuests)
+        {
+            NumRecords += Record.ObjectiveDeadlines.IsEmpty() ? 0 : 1;
+        }
+        SerializeCount(Ar, NumRecords);
+        for (int32 RecordIndex = 0; RecordIndex < ActiveQuests.Num(); ++RecordIndex)
+        {
+            const TArray<int64>& Deadlines = ActiveQuests[RecordIndex].ObjectiveDeadlines;
+            if (Deadlines.IsEmpty())
+            {
+                continue;
+            }
+
+            uint32 PackedIndex = static_cast<uint32>(RecordIndex);
+            int32 NumValues = Deadlines.Num();
+            Ar.SerializeIntPacked(PackedIndex);
+            SerializeCount(Ar, NumValues);
+            for (const int64 Deadline : Deadlines)
+            {
+                uint64 PackedDeadline = static_cast<uint64>(FMath::Max<int64>(Deadline, 0));
+                Ar.SerializeIntPacked64(PackedDeadline);
+            }
+        }
+    });
+}
+
+bool FQuestSaveSnapshot::ReadFrom(TConstArrayView<uint8> Data)
+{
+    ActiveQuests.Reset();
+    CompletedQuests.Reset();
+    CompletionHistory.Reset();
+
+    FMemoryReaderView Ar(MakeMemoryView(Data));
+
+    uint32 FileMagic = 0;
+    uint16 Version = 0;
+    uint16 NumFields = 0;
+    Ar << FileMagic << Version << NumFields;
+    if (Ar.IsError() || FileMagic != Magic)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FQuestSaveSnapshot: Not a quest save."));
+        return false;
+    }
+    if (Version > CurrentVersion)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FQuestSaveSnapshot: Save version %d is newer than supported version %d."), Version, CurrentVersion);
+        return false;
+    }
+
+    TArray<FSoftObjectPath> Paths;
+    auto ReadPath = [&Ar, &Paths](FSoftObjectPath& OutPath)
+    {
+        uint32 PathIndex = 0;
+        Ar.SerializeIntPacked(PathIndex);
+        if (!Paths.IsValidIndex(PathIndex))
+        {
+            Ar.SetError();
+            return;
+        }
+        OutPath = Paths[PathIndex];
+    };
+
+    for (int32 Field = 0; Field < NumFields && !Ar.IsError(); ++Field)
+    {
+        uint16 FieldId = 0;
+        uint32 PayloadSize = 0;
+        Ar << FieldId << PayloadSize;
+
+        const int64 PayloadStart = Ar.Tell();
+        const int64 PayloadEnd = PayloadStart + PayloadSize;
+        if (Ar.IsError() || PayloadEnd > Ar.TotalSize())
+        {
+            Ar.SetError();
+            break;
+        }
+
+        int32 Count = 0;
+        switch (static_cast<EField>(FieldId))
+        {
+        case EField::QuestPaths:
+            SerializeCount(Ar, Count);
+            for (int32 Index = 0; Index < Count && !Ar.IsError() && Ar.Tell() < PayloadEnd; ++Index)
+            {
+                FString Path;
+                Ar << Path;
+                Paths.Emplace(Path);
+            }
+            break;
+
+        case EField::ActiveQuests:
+            SerializeCount(Ar, Count);
+            for (int32 Index = 0; Index < Count && !Ar.IsError() && Ar.Tell() < PayloadEnd; ++Index)
+            {
+                FQuestSaveRecord& Record = ActiveQuests.AddDefaulted_GetRef();
+                uint8 Status = 0;
+                int32 NumValues = 0;
+                ReadPath(Record.Quest);
+                Ar << Status;
+                SerializeCount(Ar, NumValues);
+                if (NumValues > MAX_uint8 + 1)
+                {
+                    Ar.SetError();
+                    break;
+                }
+                Record.Status = static_cast<EQuestStatus>(FMath::Min<uint8>(Status, static_cast<uint8>(EQuestStatus::Completed)));
+                Record.ObjectiveProgress.SetNumUninitialized(NumValues);
+                for (int32& Value : Record.ObjectiveProgress)
+                {
+                    uint32 PackedValue = 0;
+                    Ar.SerializeIntPacked(PackedValue);
+                    Value = static_cast<int32>(FMath::Min<uint32>(PackedValue, MAX_int32));
+                }
+            }
+            break;
+
+        case EField::CompletedQuests:
+            SerializeCount(Ar, Count);
+            for (int32 Index = 0; Index < Count && !Ar.IsError() && Ar.Tell() < PayloadEnd; ++Index)
+            {
+                ReadPath(CompletedQuests.AddDefaulted_GetRef());
+            }
+            break;
+
+        case EField::CompletionHistory:
+        {
+            SerializeCount(Ar, Count);
+            int64 Timestamp = 0;
+            for (int32 Index = 0; Index < Count && !Ar.IsError() && Ar.Tell() < PayloadEnd; ++Index)
+            {
+                FQuestSaveCompletion& Completion = CompletionHistory.AddDefaulted_GetRef();
+                uint64 TimestampDelta = 0;
+                ReadPath(Completion.Quest);
+                Ar.SerializeIntPacked64(TimestampDelta);
+                Timestamp += static_cast<int64>(TimestampDelta);
+                Completion.UnixTimestamp = Timestamp;
+            }
+            break;
+        }
+
+        case EField::ObjectiveDeadlines:
+            SerializeCount(Ar, Count);
+            for (int32 Index = 0; Index < Count && !Ar.IsError() && Ar.Tell() < PayloadEnd; ++Index)
+            {
+                uint32 RecordIndex = 0;
+                int32 NumValues = 0;
+                Ar.SerializeIntPacked(RecordIndex);
+                SerializeCount(Ar, NumValues);
+                if (!ActiveQuests.IsValidIndex(RecordIndex) || NumValues > MAX_uint8 + 1)
+                {
+                    Ar.SetError();
+                    break;
+                }
+                TArray<int64>& Deadlines = ActiveQuests[RecordIndex].ObjectiveDeadlines;
+                Deadlines.SetNumUninitialized(NumValues);
+                for (int64& Deadline : Deadlines)
+                {
+                    uint64 PackedDeadline = 0;
+                    Ar.SerializeIntPacked64(PackedDeadline);
+                    Deadline = static_cast<int64>(FMath::Min<uint64>(PackedDeadline, MAX_int64));
+                }
+            }
+            break;
+
+        default:
+            // Written by a newer build; skip it.
+            break;
+        }
+
+        if (Ar.Tell() > PayloadEnd)
+        {
+            Ar.SetError();
+            break;
+        }
+        Ar.Seek(PayloadEnd);
+    }
+
+    if (Ar.IsError())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FQuestSaveSnapshot: Quest save is corrupt."));
+        return false;
+    }
+    return true;
+}
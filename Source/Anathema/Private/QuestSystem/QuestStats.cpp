@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestStats.h"
+#include "Trace/Trace.inl"
+
+DEFINE_STAT(STAT_Quest_NotifyEvent);
+DEFINE_STAT(STAT_Quest_AddQuest);
+DEFINE_STAT(STAT_Quest_RemoveQuest);
+DEFINE_STAT(STAT_Quest_InitializeObjectives);
+DEFINE_STAT(STAT_Quest_ProcessGameEvent);
+DEFINE_STAT(STAT_Quest_ProcessEventForPlayers);
+DEFINE_STAT(STAT_Quest_ParallelScanChunk);
+DEFINE_STAT(STAT_Quest_DrainIngress);
+DEFINE_STAT(STAT_Quest_TrimPools);
+DEFINE_STAT(STAT_Quest_EventsDispatched);
+DEFINE_STAT(STAT_Quest_ActiveQuests);
+DEFINE_STAT(STAT_Quest_Players);
+
+LLM_DEFINE_TAG(Quests);
+LLM_DEFINE_TAG(Quests_Definitions, TEXT("Quests/Definitions"), TEXT("Quests"));
+LLM_DEFINE_TAG(Quests_Runtime, TEXT("Quests/Runtime"), TEXT("Quests"));
+LLM_DEFINE_TAG(Quests_EventQueues, TEXT("Quests/EventQueues"), TEXT("Quests"));
+
+CSV_DEFINE_CATEGORY_MODULE(ANATHEMA_API, Quests, true);
+
+UE_TRACE_CHANNEL_DEFINE(QuestChannel);
+
+UE_TRACE_EVENT_BEGIN(Quest, EventDispatch)
+    UE_TRACE_EVENT_FIELD(uint64, StartCycle)
+    UE_TRACE_EVENT_FIELD(uint64, EndCycle)
+    UE_TRACE_EVENT_FIELD(int32, Count)
+    UE_TRACE_EVENT_FIELD(int32, NumTargets)
+    UE_TRACE_EVENT_FIELD(UE::Trace::WideString, EventTag)
+UE_TRACE_EVENT_END()
+
+namespace QuestStats
+{
+    namespace
+    {
+        uint64 GameThreadCycles = 0;
+        int32 GameThreadScopeDepth = 0;
+    }
+
+    void TraceEventDispatch(FName EventTag, int32 Count, int32 NumTargets, uint64 StartCycle, uint64 EndCycle)
+    {
+        // The tag is only turned into a string when somebody is actually recording the channel.
+        if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(QuestChannel))
+        {
+            return;
+        }
+
+        TCHAR TagBuffer[NAME_SIZE];
+        const uint32 TagLength = EventTag.ToString(TagBuffer);
+        UE_TRACE_LOG(Quest, EventDispatch, QuestChannel)
+            << EventDispatch.StartCycle(StartCycle)
+            << EventDispatch.EndCycle(EndCycle)
+            << EventDispatch.Count(Count)
+            << EventDispatch.NumTargets(NumTargets)
+            << EventDispatch.EventTag(TagBuffer, TagLength);
+    }
+
+    void RecordFrameTotals(int32 NumActiveQuests, int32 NumPlayers)
+    {
+        SET_DWORD_STAT(STAT_Quest_ActiveQuests, NumActiveQuests);
+        SET_DWORD_STAT(STAT_Quest_Players, NumPlayers);
+
+        CSV_CUSTOM_STAT(Quests, ActiveQuests, NumActiveQuests, ECsvCustomStatOp::Set);
+        CSV_CUSTOM_STAT(Quests, Players, NumPlayers, ECsvCustomStatOp::Set);
+        CSV_CUSTOM_STAT(Quests, ActiveQuestsPerPlayer, NumPlayers > 0 ? static_cast<float>(NumActiveQuests) / NumPlayers : 0.0f, ECsvCustomStatOp::Set);
+    }
+
+    uint64 GetGameThreadCycles()
+    {
+        return GameThreadCycles;
+    }
+
+    FScopedGameThreadCycles::FScopedGameThreadCycles()
+    {
+        if (IsInGameThread() && GameThreadScopeDepth++ == 0)
+        {
+            bCounting = true;
+            StartCycles = FPlatformTime::Cycles64();
+        }
+    }
+
+    FScopedGameThreadCycles::~FScopedGameThreadCycles()
+    {
+        if (bCounting)
+        {
+            GameThreadCycles += FPlatformTime::Cycles64() - StartCycles;
+        }
+        if (IsInGameThread())
+        {
+            --GameThreadScopeDepth;
+        }
+    }
+}
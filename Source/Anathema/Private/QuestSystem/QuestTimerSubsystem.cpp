@@ -0,0 +1,157 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestTimerSubsystem.h"
+#include "QuestSystem/QuestStats.h"
+#include "QuestSystem/TimedObjective.h"
+#include "QuestSystem/QuestPlayerRegistrySubsystem.h"
+#include "QuestSystem/QuestEventRecorderSubsystem.h"
+#include "QuestManagerComponent.h"
+#include "GameFramework/Actor.h"
+
+void UQuestTimerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    Wheel = FQuestTimingWheel(TickResolution);
+}
+
+// --- TIMERS ---
+
+void UQuestTimerSubsystem::StartObjectiveTimers(const UTimedObjective* Objective, AActor* Player)
+{
+    LLM_SCOPE_BYTAG(Quests_EventQueues);
+
+    if (!IsValid(Objective) || !IsValid(Player))
+    {
+        return;
+    }
+
+    // Restarting an objective replaces its running timers.
+    StopObjectiveTimers(Objective, Player);
+
+    const TObjectKey<AActor> PlayerKey(Player);
+    FObjectiveTimers Timers;
+    const UQuestPlayerRegistrySubsystem* Registry = GetWorld()->GetSubsystem<UQuestPlayerRegistrySubsystem>();
+    Timers.QuestManager = Registry ? Registry->FindByOwner(Player) : nullptr;
+    if (!Timers.QuestManager)
+    {
+        // The manager hasn't begun play yet.
+        Timers.QuestManager = Player->FindComponentByClass<UQuestManagerComponent>();
+    }
+    if (Objective->TimeLimit > 0.0f)
+    {
+        // Only what's left until the player's deadline, which survives loads. A deadline that passed while the
+        // player was away expires on the next wheel tick.
+        const FDateTime Deadline = Timers.QuestManager.IsValid() ? Timers.QuestManager->GetObjectiveDeadline(Objective) : FDateTime(0);
+        const double RemainingSeconds = Deadline.GetTicks() > 0 ? (Deadline - FDateTime::UtcNow()).GetTotalSeconds() : Objective->TimeLimit;
+        Timers.ExpiryHandle = Wheel.Schedule(FMath::Max(RemainingSeconds, 0.0), { PlayerKey, Objective, false });
+    }
+    if (Objective->CheckInterval > 0.0f && !Objective->CheckEventTag.IsNone())
+    {
+        Timers.CheckHandle = Wheel.Schedule(Objective->CheckInterval, { PlayerKey, Objective, true });
+    }
+
+    if (Timers.ExpiryHandle != 0 || Timers.CheckHandle != 0)
+    {
+        ActiveTimers.Add(FTimerKey(Objective, PlayerKey), Timers);
+    }
+}
+
+void UQuestTimerSubsystem::StopObjectiveTimers(const UTimedObjective* Objective, AActor* Player)
+{
+    CancelTimers(FTimerKey(Objective, TObjectKey<AActor>(Player)));
+}
+
+void UQuestTimerSubsystem::CancelTimers(const FTimerKey& Key)
+{
+    FObjectiveTimers Timers;
+    if (ActiveTimers.RemoveAndCopyValue(Key, Timers))
+    {
+        Wheel.Cancel(Timers.ExpiryHandle);
+        Wheel.Cancel(Timers.CheckHandle);
+    }
+}
+
+// --- FIRING ---
+
+void UQuestTimerSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    QuestStats::FScopedGameThreadCycles CycleScope;
+
+    FiredTimers.Reset();
+    Wheel.Advance(DeltaTime, FiredTimers);
+    if (FiredTimers.IsEmpty())
+    {
+        return;
+    }
+
+    // Resolve every fired timer before acting on any of them: expirations complete objectives and fail quests,
+    // which stops (and may restart) timers and must not happen while the batch is being read.
+    struct FExpiredObjective
+    {
+        TWeakObjectPtr<UQuestManagerComponent> QuestManager;
+        const UTimedObjective* Objective;
+    };
+    TArray<FExpiredObjective> Expired;
+
+    // A replayed capture brings its own check events.
+    const bool bReplayingCapture = UQuestEventRecorderSubsystem::IsReplayingCapture(GetWorld());
+
+    for (const FQuestTimingWheel::FPayload& Fired : FiredTimers)
+    {
+        const FTimerKey Key(Fired.Objective, Fired.Player);
+        FObjectiveTimers* Timers = ActiveTimers.Find(Key);
+        UQuestManagerComponent* QuestManager = Timers ? Timers->QuestManager.Get() : nullptr;
+        if (!QuestManager)
+        {
+            // The player is gone.
+            CancelTimers(Key);
+            continue;
+        }
+
+        if (Fired.bIsCheck)
+        {
+            // Periodic: schedule the next check, then feed this one into the player's event queue.
+            Timers->CheckHandle = Wheel.Schedule(Fired.Objective->CheckInterval, Fired);
+            if (bReplayingCapture)
+            {
+                continue;
+            }
+
+            FObjectiveEventData E;
+            E.EventTag = Fired.Objective->CheckEventTag;
+            E.TriggeringActor = Fired.Player.ResolveObjectPtr();
+            QuestManager->QueueEvent(E);
+        }
+        else
+        {
+            Timers->ExpiryHandle = 0;
+            Expired.Add({ QuestManager, Fired.Objective });
+        }
+    }
+
+    for (const FExpiredObjective& Expiry : Expired)
+    {
+        if (UQuestManagerComponent* QuestManager = Expiry.QuestManager.Get())
+        {
+            QuestManager->OnObjectiveTimeLimitExpired(Expiry.Objective);
+        }
+    }
+}
+
+TStatId UQuestTimerSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UQuestTimerSubsystem, STATGROUP_Quests);
+}
+
+void UQuestTimerSubsystem::Deinitialize()
+{
+    ActiveTimers.Empty();
+    FiredTimers.Empty();
+    Wheel.Reset();
+
+    Super::Deinitialize();
+}
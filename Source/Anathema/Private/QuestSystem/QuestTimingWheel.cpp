@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/QuestTimingWheel.h"
+
+FQuestTimingWheel::FQuestTimingWheel(double InTickSeconds)
+    : TickSeconds(FMath::Max(InTickSeconds, 0.001))
+{
+    Reset();
+}
+
+void FQuestTimingWheel::Reset()
+{
+    for (int32 Level = 0; Level < NumLevels; ++Level)
+    {
+        for (int32 Slot = 0; Slot < SlotsPerLevel; ++Slot)
+        {
+            SlotHeads[Level][Slot] = INDEX_NONE;
+        }
+    }
+    Timers.Reset();
+    FreeTimers.Reset();
+    NumPending = 0;
+    CurrentTick = 0;
+    PendingSeconds = 0.0;
+}
+
+FQuestTimingWheel::FHandle FQuestTimingWheel::Schedule(double DelaySeconds, const FPayload& Payload)
+{
+    const uint64 DelayTicks = FMath::Max<uint64>(static_cast<uint64>(FMath::CeilToDouble(DelaySeconds / TickSeconds)), 1);
+
+    const int32 TimerIndex = FreeTimers.Num() > 0 ? FreeTimers.Pop(EAllowShrinking::No) : Timers.AddDefaulted();
+    FTimer& Timer = Timers[TimerIndex];
+    Timer.ExpiryTick = CurrentTick + DelayTicks;
+    Timer.Payload = Payload;
+    ++Timer.Serial;
+    Link(TimerIndex);
+    ++NumPending;
+
+    return (static_cast<uint64>(Timer.Serial) << 32) | static_cast<uint64>(TimerIndex + 1);
+}
+
+void FQuestTimingWheel::Cancel(FHandle Handle)
+{
+    const int32 TimerIndex = static_cast<int32>(Handle & 0xFFFFFFFF) - 1;
+    const uint32 Serial = static_cast<uint32>(Handle >> 32);
+    if (!Timers.IsValidIndex(TimerIndex) || Timers[TimerIndex].Serial != Serial || Timers[TimerIndex].Level == INDEX_NONE)
+    {
+        return;
+    }
+
+    Unlink(TimerIndex);
+    Release(TimerIndex);
+}
+
+void FQuestTimingWheel::Advance(double DeltaSeconds, TArray<FPayload>& OutFired)
+{
+    PendingSeconds += DeltaSeconds;
+    const uint64 NumTicks = static_cast<uint64>(PendingSeconds / TickSeconds);
+    PendingSeconds -= NumTicks * TickSeconds;
+
+    for (uint64 Step = 0; Step < NumTicks; ++Step)
+    {
+        // Nothing left to fire: just move the clock.
+        if (NumPending == 0)
+        {
+            CurrentTick += NumTicks - Step;
+            return;
+        }
+
+        ++CurrentTick;
+
+        // When a level wraps around, the next slot of the level above is due: spread its timers over the
+        // finer levels. Coarser levels go first so their timers can cascade all the way down this tick.
+        for (int32 Level = NumLevels - 1; Level > 0; --Level)
+        {
+            if ((CurrentTick & ((uint64(1) << (SlotBits * Level)) - 1)) == 0)
+            {
+                Cascade(Level, static_cast<int32>((CurrentTick >> (SlotBits * Level)) & SlotMask));
+            }
+        }
+
+        // Everything in the current level 0 slot is due now.
+        const int32 Slot = static_cast<int32>(CurrentTick & SlotMask);
+        while (SlotHeads[0][Slot] != INDEX_NONE)
+        {
+            const int32 TimerIndex = SlotHeads[0][Slot];
+            Unlink(TimerIndex);
+            OutFired.Add(Timers[TimerIndex].Payload);
+            Release(TimerIndex);
+        }
+    }
+}
+
+void FQuestTimingWheel::Link(int32 TimerIndex)
+{
+    FTimer& Timer = Timers[TimerIndex];
+
+    // Pick the finest level whose span covers the remaining delay. Delays beyond the last level are parked
+    // in its furthest slot and re-cascaded until they fit.
+    const uint64 Delay = Timer.ExpiryTick > CurrentTick ? Timer.ExpiryTick - CurrentTick : 0;
+    const uint64 PlacementTick = Delay > MaxDelayTicks ? CurrentTick + MaxDelayTicks : FMath::Max(Timer.ExpiryTick, CurrentTick);
+    int32 Level = 0;
+    while (Level < NumLevels - 1 && (PlacementTick - CurrentTick) >= (uint64(1) << (SlotBits * (Level + 1))))
+    {
+        ++Level;
+    }
+
+    Timer.Level = Level;
+    Timer.Slot = static_cast<int32>((PlacementTick >> (SlotBits * Level)) & SlotMask);
+    Timer.Prev = INDEX_NONE;
+    Timer.Next = SlotHeads[Level][Timer.Slot];
+    if (Timer.Next != INDEX_NONE)
+    {
+        Timers[Timer.Next].Prev = TimerIndex;
+    }
+    SlotHeads[Level][Timer.Slot] = TimerIndex;
+}
+
+void FQuestTimingWheel::Unlink(int32 TimerIndex)
+{
+    FTimer& Timer = Timers[TimerIndex];
+    if (Timer.Prev != INDEX_NONE)
+    {
+        Timers[Timer.Prev].Next = Timer.Next;
+    }
+    else
+    {
+        SlotHeads[Timer.Level][Timer.Slot] = Timer.Next;
+    }
+    if (Timer.Next != INDEX_NONE)
+    {
+        Timers[Timer.Next].Prev = Timer.Prev;
+    }
+    Timer.Prev = Timer.Next = INDEX_NONE;
+    Timer.Level = Timer.Slot = INDEX_NONE;
+}
+
+void FQuestTimingWheel::Cascade(int32 Level, int32 Slot)
+{
+    int32 TimerIndex = SlotHeads[Level][Slot];
+    SlotHeads[Level][Slot] = INDEX_NONE;
+    while (TimerIndex != INDEX_NONE)
+    {
+        const int32 Next = Timers[TimerIndex].Next;
+        Link(TimerIndex);
+        TimerIndex = Next;
+    }
+}
+
+void FQuestTimingWheel::Release(int32 TimerIndex)
+{
+    Timers[TimerIndex].Payload = FPayload();
+    FreeTimers.Add(TimerIndex);
+    --NumPending;
+}
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "QuestSystem/TimedObjective.h"
+#include "QuestSystem/QuestTimerSubsystem.h"
+#include "GameFramework/Actor.h"
+#include "Engine/World.h"
+
+void UTimedObjective::PostInitProperties()
+{
+    Super::PostInitProperties();
+    SyncHandledEventTags();
+}
+
+void UTimedObjective::PostLoad()
+{
+    Super::PostLoad();
+    SyncHandledEventTags();
+}
+
+#if WITH_EDITOR
+void UTimedObjective::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+    SyncHandledEventTags();
+}
+#endif
+
+bool UTimedObjective::CanProcessEventsInParallel() const
+{
+    return GetClass() == UTimedObjective::StaticClass();
+}
+
+bool UTimedObjective::ReadsTriggeringActor() const
+{
+    return GetClass() != UTimedObjective::StaticClass();
+}
+
+void UTimedObjective::SyncHandledEventTags()
+{
+    if (!CheckEventTag.IsNone())
+    {
+        HandledEventTags.AddUnique(CheckEventTag);
+    }
+}
+
+void UTimedObjective::InitializeObjective_Implementation(AActor* OwningActor) const
+{
+    Super::InitializeObjective_Implementation(OwningActor);
+
+    UWorld* World = OwningActor ? OwningActor->GetWorld() : nullptr;
+    if (UQuestTimerSubsystem* Timers = World ? World->GetSubsystem<UQuestTimerSubsystem>() : nullptr)
+    {
+        Timers->StartObjectiveTimers(this, OwningActor);
+    }
+}
+
+void UTimedObjective::UninitializeObjective_Implementation(AActor* OwningActor) const
+{
+    UWorld* World = OwningActor ? OwningActor->GetWorld() : nullptr;
+    if (UQuestTimerSubsystem* Timers = World ? World->GetSubsystem<UQuestTimerSubsystem>() : nullptr)
+    {
+        Timers->StopObjectiveTimers(this, OwningActor);
+    }
+
+    Super::UninitializeObjective_Implementation(OwningActor);
+}
@@ -0,0 +1,538 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "QuestManagerComponent.h"
+#include "QuestSystem/QuestNode.h"
+#include "QuestSystem/Objective.h"
+#include "QuestSystem/QuestDefinitionSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerState.h"
+#include "UObject/StrongObjectPtr.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Math/RandomStream.h"
+#include "HAL/IConsoleManager.h"
+
+/**
+ * Quest runtime micro-benchmarks ("Anathema.Quests.Performance.*", perf filter).
+ *
+ * Each test builds a synthetic quest graph in a fresh game world, drives one part of the quest API for a number of
+ * players, and records per-call latencies. Results (calls per second, p50 and p99 in microseconds) are written to
+ * Saved/Automation/QuestBenchmarks.json and compared with the baseline checked in at
+ * Build/Automation/QuestBenchmarkBaseline.json; a test fails if a metric is worse than the baseline by more than the
+ * threshold, or if the baseline file is missing. A benchmark without a baseline for its workload only warns.
+ * Baselines are recorded on the reference machine with -QuestBenchUpdateBaseline, and the file checked in.
+ *
+ * Command line options:
+ *   -QuestBenchPlayers=N       players (quest managers), default 8
+ *   -QuestBenchQuests=N        quests in the synthetic graph, default 256
+ *   -QuestBenchObjectives=N    objectives per quest, default 4
+ *   -QuestBenchTags=N          distinct event tags, default 32
+ *   -QuestBenchEvents=N        events per player for the NotifyEvent benchmark, default 4096
+ *   -QuestBenchThreshold=F     allowed regression as a fraction, default 0.2 (20%)
+ *   -QuestBenchBaseline=Path   baseline file, default Build/Automation/QuestBenchmarkBaseline.json
+ *   -QuestBenchUpdateBaseline  overwrite the baseline with this run's results
+ *
+ * The GarbageCollection test times full GC passes without the quests, with them, and with them clustered. It clusters
+ * them with an explicit UQuestDefinitionSubsystem::ClusterQuests call: registration never clusters in the editor
+ * (GIsEditor, which UnrealEditor-Cmd sets too), so it shows what clustering buys, not that registration applies it.
+ * To cover the automatic path as well, run with -game, where the other tests also see their quests clustered.
+ *
+ * Run them headless with e.g.
+ *   UnrealEditor-Cmd Anathema.uproject -ExecCmds="Automation RunFilter Perf; Quit" -unattended -nullrhi
+ */
+namespace QuestBenchmark
+{
+    struct FSettings
+    {
+        int32 NumPlayers = 8;
+        int32 NumQuests = 256;
+        int32 NumObjectives = 4;
+        int32 NumTags = 32;
+        int32 NumEventsPerPlayer = 4096;
+        float Threshold = 0.2f;
+        FString BaselinePath;
+        bool bUpdateBaseline = false;
+
+        FSettings()
+        {
+            const TCHAR* CommandLine = FCommandLine::Get();
+            FParse::Value(CommandLine, TEXT("QuestBenchPlayers="), NumPlayers);
+            FParse::Value(CommandLine, TEXT("QuestBenchQuests="), NumQuests);
+            FParse::Value(CommandLine, TEXT("QuestBenchObjectives="), NumObjectives);
+            FParse::Value(CommandLine, TEXT("QuestBenchTags="), NumTags);
+            FParse::Value(CommandLine, TEXT("QuestBenchEvents="), NumEventsPerPlayer);
+            FParse::Value(CommandLine, TEXT("QuestBenchThreshold="), Threshold);
+            bUpdateBaseline = FParse::Param(CommandLine, TEXT("QuestBenchUpdateBaseline"));
+            if (!FParse::Value(CommandLine, TEXT("QuestBenchBaseline="), BaselinePath))
+            {
+                BaselinePath = FPaths::ProjectDir() / TEXT("Build/Automation/QuestBenchmarkBaseline.json");
+            }
+
+            NumPlayers = FMath::Max(NumPlayers, 1);
+            NumQuests = FMath::Max(NumQuests, 1);
+            NumObjectives = FMath::Clamp(NumObjectives, 1, 255);
+            NumTags = FMath::Max(NumTags, 1);
+        }
+
+        // Results are only compared with a baseline recorded for the same workload.
+        FString GetWorkloadKey() const
+        {
+            return FString::Printf(TEXT("Players=%d,Quests=%d,Objectives=%d,Tags=%d,Events=%d"), NumPlayers, NumQuests, NumObjectives, NumTags, NumEventsPerPlayer);
+        }
+    };
+
+    // Per-call latencies of one benchmarked operation.
+    struct FSamples
+    {
+        TArray<uint64> Cycles;
+
+        void Add(uint64 StartCycles) { Cycles.Add(FPlatformTime::Cycles64() - StartCycles); }
+
+        TSharedRef<FJsonObject> ToJson() const
+        {
+            TArray<uint64> Sorted = Cycles;
+            Sorted.Sort();
+            uint64 TotalCycles = 0;
+            for (const uint64 Sample : Sorted)
+            {
+                TotalCycles += Sample;
+            }
+            auto Percentile = [&Sorted](double Fraction)
+            {
+                const int32 Index = FMath::Clamp(FMath::CeilToInt32(Fraction * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+                return FPlatformTime::ToMilliseconds64(Sorted[Index]) * 1000.0;
+            };
+
+            TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+            Json->SetNumberField(TEXT("Count"), Sorted.Num());
+            Json->SetNumberField(TEXT("OpsPerSecond"), TotalCycles > 0 ? Sorted.Num() / FPlatformTime::ToSeconds64(TotalCycles) : 0.0);
+            Json->SetNumberField(TEXT("P50Us"), Sorted.Num() > 0 ? Percentile(0.5) : 0.0);
+            Json->SetNumberField(TEXT("P99Us"), Sorted.Num() > 0 ? Percentile(0.99) : 0.0);
+            return Json;
+        }
+    };
+
+    // The quest system logs every add/remove/completion; at benchmark volumes that would be most of what's measured.
+    struct FScopedQuietLog
+    {
+        ELogVerbosity::Type PreviousVerbosity;
+
+        FScopedQuietLog() : PreviousVerbosity(LogTemp.GetVerbosity()) { LogTemp.SetVerbosity(ELogVerbosity::Error); }
+        ~FScopedQuietLog() { LogTemp.SetVerbosity(PreviousVerbosity); }
+    };
+
+    /**
+     * A game world with one quest manager per player, and a synthetic quest graph.
+     *
+     * The graph is a forest: the first NumQuests / 8 quests are roots, and every later quest I has quest
+     * (I - NumRoots) / 2 as its prerequisite, so completing a quest unlocks up to two follow-ups. Objective J of quest I handles the tag "QuestBench.Kill.<(I * NumObjectives + J) % NumTags>", so
+     * events fan out to several quests of each player. The quests are compiled into the quest graph as one batch and
+     * removed from it again when the fixture goes away, so repeated runs don't grow the graph.
+     */
+    // Event tag TagIndex of the synthetic quests.
+    FName MakeEventTag(int32 TagIndex)
+    {
+        return FName(*FString::Printf(TEXT("QuestBench.Kill.%d"), TagIndex));
+    }
+
+    // Builds the synthetic quest graph (see FFixture).
+    TArray<TStrongObjectPtr<UQuestNode>> BuildQuests(const FSettings& Settings, int32 RequiredProgress)
+    {
+        const int32 NumRoots = FMath::Max(Settings.NumQuests / 8, 1);
+        TArray<UQuestNode*> NewQuests;
+        TArray<TStrongObjectPtr<UQuestNode>> Quests;
+        for (int32 QuestIndex = 0; QuestIndex < Settings.NumQuests; ++QuestIndex)
+        {
+            UQuestNode* Quest = NewObject<UQuestNode>(GetTransientPackage());
+            Quest->QuestName = FText::FromString(FString::Printf(TEXT("Benchmark Quest %d"), QuestIndex));
+            for (int32 ObjectiveIndex = 0; ObjectiveIndex < Settings.NumObjectives; ++ObjectiveIndex)
+            {
+                UObjective* Objective = NewObject<UObjective>(Quest);
+                Objective->RequiredProgress = RequiredProgress;
+                Objective->HandledEventTags.Add(MakeEventTag((QuestIndex * Settings.NumObjectives + ObjectiveIndex) % Settings.NumTags));
+                Quest->Objectives.Add(Objective);
+            }
+            if (QuestIndex >= NumRoots)
+            {
+                UQuestNode* Prerequisite = NewQuests[(QuestIndex - NumRoots) / 2];
+                Quest->PrerequisiteQuests.Add(Prerequisite);
+                Prerequisite->AddFollowup(Quest);
+            }
+            NewQuests.Add(Quest);
+            Quests.Emplace(Quest);
+        }
+
+        // Registered as a whole, so the graph holds every quest of the set and not only those a run happened to add.
+        UQuestDefinitionSubsystem::Get()->RegisterQuests(NewQuests);
+        return Quests;
+    }
+
+    struct FFixture
+    {
+        const FSettings& Settings;
+        UWorld* World = nullptr;
+        TArray<UQuestManagerComponent*> QuestManagers;
+        TArray<TStrongObjectPtr<UQuestNode>> Quests;
+        TArray<FName> EventTags;
+        FScopedQuietLog QuietLog;
+        // ID of the first of Quests in the quest graph.
+        int32 FirstQuestId = 0;
+
+        FFixture(const FSettings& InSettings, int32 RequiredProgress)
+            : Settings(InSettings)
+        {
+            World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("QuestBenchmarkWorld"));
+            FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+            WorldContext.SetCurrentWorld(World);
+            World->InitializeActorsForPlay(FURL());
+            World->BeginPlay();
+
+            for (int32 TagIndex = 0; TagIndex < Settings.NumTags; ++TagIndex)
+            {
+                EventTags.Add(MakeEventTag(TagIndex));
+            }
+            FirstQuestId = UQuestDefinitionSubsystem::Get()->GetQuestGraph().Num();
+            Quests = BuildQuests(Settings, RequiredProgress);
+
+            for (int32 PlayerIndex = 0; PlayerIndex < Settings.NumPlayers; ++PlayerIndex)
+            {
+                APlayerState* PlayerState = World->SpawnActor<APlayerState>();
+                UQuestManagerComponent* QuestManager = NewObject<UQuestManagerComponent>(PlayerState);
+                QuestManager->RegisterComponent();
+                QuestManagers.Add(QuestManager);
+            }
+        }
+
+        ~FFixture()
+        {
+            GEngine->DestroyWorldContext(World);
+            World->DestroyWorld(false);
+            UQuestDefinitionSubsystem::Get()->UnregisterQuestsFrom(FirstQuestId);
+        }
+
+        // Gives every player every quest whose prerequisites it has completed.
+        void AddAvailableQuests()
+        {
+            for (UQuestManagerComponent* QuestManager : QuestManagers)
+            {
+                for (const TStrongObjectPtr<UQuestNode>& Quest : Quests)
+                {
+                    if (!QuestManager->IsQuestActive(Quest.Get()) && !QuestManager->HasQuestBeenCompleted(Quest.Get()) && QuestManager->GetNumRemainingPrerequisites(Quest.Get()) == 0)
+                    {
+                        QuestManager->AddQuest(Quest.Get());
+                    }
+                }
+            }
+        }
+    };
+
+    // Writes this run's results for Name, compares them with the baseline and reports regressions as errors.
+    bool ReportResults(FAutomationTestBase& Test, const FSettings& Settings, const FString& Name, const TMap<FString, FSamples>& Metrics)
+    {
+        auto LoadJson = [](const FString& Path)
+        {
+            TSharedPtr<FJsonObject> Json;
+            FString Text;
+            if (FFileHelper::LoadFileToString(Text, *Path))
+            {
+                FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Text), Json);
+            }
+            return Json.IsValid() ? Json.ToSharedRef() : MakeShared<FJsonObject>();
+        };
+        auto SaveJson = [](const FString& Path, const TSharedRef<FJsonObject>& Json)
+        {
+            FString Text;
+            FJsonSerializer::Serialize(Json, TJsonWriterFactory<>::Create(&Text));
+            return FFileHelper::SaveStringToFile(Text, *Path);
+        };
+
+        TSharedRef<FJsonObject> Results = MakeShared<FJsonObject>();
+        Results->SetStringField(TEXT("Workload"), Settings.GetWorkloadKey());
+        for (const TPair<FString, FSamples>& Metric : Metrics)
+        {
+            const TSharedRef<FJsonObject> MetricJson = Metric.Value.ToJson();
+            Results->SetObjectField(Metric.Key, MetricJson);
+            Test.AddInfo(FString::Printf(TEXT("%s.%s: %.0f ops/s, p50 %.2f us, p99 %.2f us"), *Name, *Metric.Key,
+                MetricJson->GetNumberField(TEXT("OpsPerSecond")), MetricJson->GetNumberField(TEXT("P50Us")), MetricJson->GetNumberField(TEXT("P99Us"))));
+        }
+
+        const FString ResultsPath = FPaths::ProjectSavedDir() / TEXT("Automation/QuestBenchmarks.json");
+        TSharedRef<FJsonObject> AllResults = LoadJson(ResultsPath);
+        AllResults->SetObjectField(Name, Results);
+        SaveJson(ResultsPath, AllResults);
+
+        TSharedRef<FJsonObject> Baseline = LoadJson(Settings.BaselinePath);
+        if (Settings.bUpdateBaseline)
+        {
+            Baseline->SetObjectField(Name, Results);
+            SaveJson(Settings.BaselinePath, Baseline);
+            Test.AddInfo(FString::Printf(TEXT("Recorded %s baseline in %s; check it in."), *Name, *Settings.BaselinePath));
+            return true;
+        }
+
+        // The baseline is part of the repository. Never invent one here, or a regression would pass as the new normal.
+        if (!FPaths::FileExists(Settings.BaselinePath))
+        {
+            Test.AddError(FString::Printf(TEXT("Baseline file %s is missing. Record it with -QuestBenchUpdateBaseline and check it in."), *Settings.BaselinePath));
+            return false;
+        }
+
+        const TSharedPtr<FJsonObject>* BaselineResults = nullptr;
+        const bool bHasBaseline = Baseline->TryGetObjectField(Name, BaselineResults)
+            && (*BaselineResults)->GetStringField(TEXT("Workload")) == Settings.GetWorkloadKey();
+        if (!bHasBaseline)
+        {
+            Test.AddWarning(FString::Printf(TEXT("%s has no baseline for workload %s in %s, so nothing was compared. Record one with -QuestBenchUpdateBaseline."),
+                *Name, *Settings.GetWorkloadKey(), *Settings.BaselinePath));
+            return true;
+        }
+
+        bool bPassed = true;
+        for (const TPair<FString, TSharedPtr<FJsonValue>>& Metric : Results->Values)
+        {
+            const TSharedPtr<FJsonObject>* BaselineMetric = nullptr;
+            if (Metric.Value->Type != EJson::Object || !(*BaselineResults)->TryGetObjectField(Metric.Key, BaselineMetric))
+            {
+                continue;
+            }
+            const TSharedPtr<FJsonObject>& Current = Metric.Value->AsObject();
+
+            // Throughput regresses by going down, latencies by going up.
+            const TPair<const TCHAR*, bool> Fields[] = { { TEXT("OpsPerSecond"), true }, { TEXT("P50Us"), false }, { TEXT("P99Us"), false } };
+            for (const TPair<const TCHAR*, bool>& Field : Fields)
+            {
+                const double Value = Current->GetNumberField(Field.Key);
+                const double BaselineValue = (*BaselineMetric)->GetNumberField(Field.Key);
+                const bool bRegressed = Field.Value
+                    ? Value < BaselineValue * (1.0 - Settings.Threshold)
+                    : Value > BaselineValue * (1.0 + Settings.Threshold);
+                if (bRegressed)
+                {
+                    Test.AddError(FString::Printf(TEXT("%s.%s.%s regressed: %.2f (baseline %.2f, threshold %.0f%%)"), *Name, *Metric.Key, Field.Key, Value, BaselineValue, Settings.Threshold * 100.0f));
+                    bPassed = false;
+                }
+            }
+        }
+        return bPassed;
+    }
+}
+
+using namespace QuestBenchmark;
+
+static constexpr EAutomationTestFlags QuestBenchmarkFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQuestBenchmarkAddRemoveTest, "Anathema.Quests.Performance.AddRemoveQuest", QuestBenchmarkFlags)
+
+bool FQuestBenchmarkAddRemoveTest::RunTest(const FString& Parameters)
+{
+    const FSettings Settings;
+    FFixture Fixture(Settings, 1);
+
+    // Only quests without prerequisites can be added directly; add and remove them repeatedly, so the progress
+    // table's free-block reuse and the subscriber index churn are part of the measurement.
+    TArray<UQuestNode*> RootQuests;
+    for (const TStrongObjectPtr<UQuestNode>& Quest : Fixture.Quests)
+    {
+        if (Quest->PrerequisiteQuests.IsEmpty())
+        {
+            RootQuests.Add(Quest.Get());
+        }
+    }
+
+    FSamples AddSamples;
+    FSamples RemoveSamples;
+    const int32 NumRounds = FMath::Max(Settings.NumQuests / FMath::Max(RootQuests.Num(), 1), 1);
+    for (int32 Round = 0; Round < NumRounds; ++Round)
+    {
+        for (UQuestManagerComponent* QuestManager : Fixture.QuestManagers)
+        {
+            for (UQuestNode* Quest : RootQuests)
+            {
+                const uint64 StartCycles = FPlatformTime::Cycles64();
+                QuestManager->AddQuest(Quest);
+                AddSamples.Add(StartCycles);
+            }
+            for (UQuestNode* Quest : RootQuests)
+            {
+                const uint64 StartCycles = FPlatformTime::Cycles64();
+                QuestManager->RemoveQuest(Quest);
+                RemoveSamples.Add(StartCycles);
+            }
+        }
+    }
+
+    TMap<FString, FSamples> Metrics;
+    Metrics.Add(TEXT("AddQuest"), MoveTemp(AddSamples));
+    Metrics.Add(TEXT("RemoveQuest"), MoveTemp(RemoveSamples));
+    return ReportResults(*this, Settings, TEXT("AddRemoveQuest"), Metrics);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQuestBenchmarkNotifyEventTest, "Anathema.Quests.Performance.NotifyEvent", QuestBenchmarkFlags)
+
+bool FQuestBenchmarkNotifyEventTest::RunTest(const FString& Parameters)
+{
+    const FSettings Settings;
+
+    // Objectives that never complete, so every event is pure dispatch and progress bookkeeping.
+    FFixture Fixture(Settings, MAX_int32);
+    Fixture.AddAvailableQuests();
+
+    FSamples NotifySamples;
+    FSamples UnmatchedSamples;
+    FRandomStream Random(0x51E57);
+    const FName UnmatchedTag(TEXT("QuestBench.Unmatched"));
+    for (int32 EventIndex = 0; EventIndex < Settings.NumEventsPerPlayer; ++EventIndex)
+    {
+        for (UQuestManagerComponent* QuestManager : Fixture.QuestManagers)
+        {
+            const FObjectiveEventData Event(Fixture.EventTags[Random.RandHelper(Fixture.EventTags.Num())], nullptr, nullptr);
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            QuestManager->NotifyEvent(Event);
+            NotifySamples.Add(StartCycles);
+
+            // Events nobody subscribed to should be rejected almost for free.
+            const FObjectiveEventData Unmatched(UnmatchedTag, nullptr, nullptr);
+            const uint64 UnmatchedStartCycles = FPlatformTime::Cycles64();
+            QuestManager->NotifyEvent(Unmatched);
+            UnmatchedSamples.Add(UnmatchedStartCycles);
+        }
+    }
+
+    TMap<FString, FSamples> Metrics;
+    Metrics.Add(TEXT("NotifyEvent"), MoveTemp(NotifySamples));
+    Metrics.Add(TEXT("NotifyEventUnmatched"), MoveTemp(UnmatchedSamples));
+    return ReportResults(*this, Settings, TEXT("NotifyEvent"), Metrics);
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQuestBenchmarkCompletionCascadeTest, "Anathema.Quests.Performance.CompletionCascade", QuestBenchmarkFlags)
+
+bool FQuestBenchmarkCompletionCascadeTest::RunTest(const FString& Parameters)
+{
+    const FSettings Settings;
+
+    // Every event completes an objective, and the last objective of a quest completes it, which removes the quest,
+    // records the completion and unlocks its follow-ups. The whole tree is worked through this way, one generation
+    // of follow-ups at a time.
+    FFixture Fixture(Settings, 1);
+
+    FSamples CompletingSamples;
+    FSamples AddFollowUpSamples;
+    int32 NumCompleted = 0;
+    for (bool bAnyActive = true; bAnyActive;)
+    {
+        const int32 NumCompletedBefore = NumCompleted;
+        for (UQuestManagerComponent* QuestManager : Fixture.QuestManagers)
+        {
+            for (const TStrongObjectPtr<UQuestNode>& Quest : Fixture.Quests)
+            {
+                if (!QuestManager->IsQuestActive(Quest.Get()) && !QuestManager->HasQuestBeenCompleted(Quest.Get()) && QuestManager->GetNumRemainingPrerequisites(Quest.Get()) == 0)
+                {
+                    const uint64 StartCycles = FPlatformTime::Cycles64();
+                    QuestManager->AddQuest(Quest.Get());
+                    AddFollowUpSamples.Add(StartCycles);
+                }
+            }
+
+            for (const TStrongObjectPtr<UQuestNode>& Quest : Fixture.Quests)
+            {
+                for (int32 ObjectiveIndex = 0; ObjectiveIndex < Quest->Objectives.Num() && QuestManager->IsQuestActive(Quest.Get()); ++ObjectiveIndex)
+                {
+                    if (QuestManager->GetObjectiveProgress(Quest.Get(), ObjectiveIndex) > 0)
+                    {
+                        continue;
+                    }
+                    const FObjectiveEventData Event(Quest->Objectives[ObjectiveIndex]->HandledEventTags[0], nullptr, nullptr);
+                    const uint64 StartCycles = FPlatformTime::Cycles64();
+                    QuestManager->NotifyEvent(Event);
+                    CompletingSamples.Add(StartCycles);
+                }
+            }
+        }
+
+        NumCompleted = 0;
+        for (const UQuestManagerComponent* QuestManager : Fixture.QuestManagers)
+        {
+            NumCompleted += QuestManager->GetNumCompletedQuests();
+        }
+        bAnyActive = NumCompleted > NumCompletedBefore;
+    }
+
+    TestEqual(TEXT("Every quest was completed by every player"), NumCompleted, Settings.NumQuests * Settings.NumPlayers);
+    TMap<FString, FSamples> Metrics;
+    Metrics.Add(TEXT("CompletingEvent"), MoveTemp(CompletingSamples));
+    Metrics.Add(TEXT("AddFollowUp"), MoveTemp(AddFollowUpSamples));
+    return ReportResults(*this, Settings, TEXT("CompletionCascade"), Metrics) && !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FQuestBenchmarkGarbageCollectionTest, "Anathema.Quests.Performance.GarbageCollection", QuestBenchmarkFlags)
+
+bool FQuestBenchmarkGarbageCollectionTest::RunTest(const FString& Parameters)
+{
+    const FSettings Settings;
+
+    // Full GC passes; with nothing to collect, each pass is almost all reachability analysis.
+    constexpr int32 NumPasses = 16;
+    auto MeasureGarbageCollection = [](FSamples& Samples)
+    {
+        for (int32 Pass = 0; Pass < NumPasses; ++Pass)
+        {
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+            Samples.Add(StartCycles);
+        }
+    };
+
+    FSamples WithoutQuestsSamples;
+    FSamples UnclusteredSamples;
+    FSamples ClusteredSamples;
+    MeasureGarbageCollection(WithoutQuestsSamples);
+
+    // Build the definitions unclustered, so the same objects can be measured both ways.
+    IConsoleVariable* ClusterDefinitions = IConsoleManager::Get().FindConsoleVariable(TEXT("quest.ClusterDefinitions"));
+    const bool bWasClustering = ClusterDefinitions->GetBool();
+    ClusterDefinitions->Set(false);
+    FFixture Fixture(Settings, MAX_int32);
+    Fixture.AddAvailableQuests();
+    ClusterDefinitions->Set(bWasClustering);
+    MeasureGarbageCollection(UnclusteredSamples);
+
+    TArray<UQuestNode*> Quests;
+    for (const TStrongObjectPtr<UQuestNode>& Quest : Fixture.Quests)
+    {
+        Quests.Add(Quest.Get());
+    }
+    const int32 NumClustered = UQuestDefinitionSubsystem::Get()->ClusterQuests(Quests);
+    MeasureGarbageCollection(ClusteredSamples);
+
+    // The quests' share of a pass (the fixture's handful of actors included).
+    auto MedianMs = [](const FSamples& Samples)
+    {
+        TArray<uint64> Sorted = Samples.Cycles;
+        Sorted.Sort();
+        return FPlatformTime::ToMilliseconds64(Sorted[Sorted.Num() / 2]);
+    };
+    AddInfo(FString::Printf(TEXT("GC time attributable to %d quests: %.3f ms unclustered, %.3f ms with %d of them clustered."), Quests.Num(),
+        MedianMs(UnclusteredSamples) - MedianMs(WithoutQuestsSamples), MedianMs(ClusteredSamples) - MedianMs(WithoutQuestsSamples), NumClustered));
+    if (NumClustered == 0)
+    {
+        AddWarning(TEXT("No quest could be clustered; is gc.CreateGCClusters off?"));
+    }
+
+    TMap<FString, FSamples> Metrics;
+    Metrics.Add(TEXT("GCWithoutQuests"), MoveTemp(WithoutQuestsSamples));
+    Metrics.Add(TEXT("GCUnclustered"), MoveTemp(UnclusteredSamples));
+    Metrics.Add(TEXT("GCClustered"), MoveTemp(ClusteredSamples));
+    return ReportResults(*this, Settings, TEXT("GarbageCollection"), Metrics) && !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -4,13 +4,60 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "UObject/ObjectKey.h"
 #include "QuestSystem/QuestNode.h"
+#include "QuestSystem/QuestRuntimeState.h"
+#include "QuestSystem/QuestCompletionHistory.h"
+#include "QuestSystem/QuestSaveData.h"
+#include "QuestSystem/QuestJournal.h"
 #include "QuestManagerComponent.generated.h"
 
+class AGameModeBase;
+class APlayerController;
+class UQuestProgressSubsystem;
+class UQuestJournalSubsystem;
+class UQuestEventRecorderSubsystem;
+class UTimedObjective;
+struct FQuestPlayerMemory;
+
 // Delegate for when a quest is completed by THIS specific player.
 // Useful for updating UI, triggering achievements, etc.
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPlayerQuestCompleted, UQuestNode*, CompletedQuest);
 
+// Delegate for when one objective of an active quest is completed by THIS specific player.
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnPlayerObjectiveCompleted, UQuestNode*, Quest, int32, ObjectiveIndex);
+
+// Delegate for when an active quest fails for THIS specific player (e.g., a timed objective ran out of time).
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPlayerQuestFailed, UQuestNode*, FailedQuest);
+
+// Native counterparts of the delegates above, for C++ listeners (quest tracker, achievements, analytics, ...).
+// Binding and broadcasting these doesn't go through reflection, so prefer them over the dynamic delegates in C++.
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnPlayerQuestCompletedNative, UQuestNode* /*CompletedQuest*/);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnPlayerObjectiveCompletedNative, UQuestNode* /*Quest*/, int32 /*ObjectiveIndex*/);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnPlayerQuestFailedNative, UQuestNode* /*FailedQuest*/);
+
+// Delegates for when an asynchronous save or load of this player's quest state has finished.
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnQuestStateSaved, const FString&, SlotName, bool, bSuccess);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnQuestStateLoaded, const FString&, SlotName, bool, bSuccess);
+
+// A quest waiting to be activated by a UQuestManagerComponent (see AddQuests, RestoreSaveSnapshot).
+// Restored quests skip AddQuest's checks and journaling, and keep their counters.
+USTRUCT()
+struct FQuestPendingActivation
+{
+	GENERATED_BODY()
+
+    UPROPERTY()
+    TObjectPtr<UQuestNode> Quest = nullptr;
+
+    bool bRestored = false;
+    TArray<int32> ObjectiveProgress;
+    TArray<int64> ObjectiveDeadlines;
+};
+
+// Delegate for when replicated quest state (active quests, status, progress) arrives on the owning client.
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnQuestLogUpdated);
+
 UCLASS(Blueprintable, BlueprintType, meta=(BlueprintSpawnableComponent)) // meta=(BlueprintSpawnableComponent) allows adding it in Blueprint editor
 class ANATHEMA_API UQuestManagerComponent : public UActorComponent
 {
@@ -21,17 +68,38 @@ public:
 	UQuestManagerComponent();
 
 	// --- PLAYER QUEST DATA ---
-	// This array holds the quests currently active for THIS specific player.
-	// Consider adding ReplicatedUsing if you want clients to be aware of active quests.
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Quest Management")
-	TArray<UQuestNode*> ActiveQuests;
+	// This array holds the state (status and objective progress) of the quests currently active for THIS specific player.
+	// The UQuestNode definitions themselves are shared by all players.
+	// Replicated to the owning client only, as deltas: only quests whose status or progress changed are sent.
+	UPROPERTY(Replicated, VisibleAnywhere, BlueprintReadOnly, Category = "Quest Management")
+	FQuestRuntimeStateArray ActiveQuests;
 
     // --- PUBLIC API FOR ADDING/REMOVING/MANAGING QUESTS ---
     // Adds a quest to this player's active quests.
-    // Returns true if the quest was successfully added, false otherwise (e.g., already active).
+    // Returns true if the quest was successfully added, false otherwise (e.g., already active or prerequisites not met).
     UFUNCTION(BlueprintCallable, Category = "Quest Management")
     bool AddQuest(UQuestNode* QuestToAdd);
 
+    // Adds several quests over the next frames, spending at most MaxQuestActivationTimeMs per tick (e.g., a batch of
+    // daily quests on login). Each quest goes through the same checks as AddQuest when its turn comes. A quest only
+    // receives events once it is fully activated; until then IsQuestActive is false and IsQuestPendingActivation true.
+    UFUNCTION(BlueprintCallable, Category = "Quest Management")
+    void AddQuests(const TArray<UQuestNode*>& QuestsToAdd);
+
+    // Whether a quest is waiting to be activated by AddQuests or a time-sliced restore.
+    UFUNCTION(BlueprintPure, BlueprintCallable, Category = "Quest Management")
+    bool IsQuestPendingActivation(const UQuestNode* Quest) const;
+
+    UFUNCTION(BlueprintPure, BlueprintCallable, Category = "Quest Management")
+    int32 GetNumPendingQuestActivations() const { return PendingActivations.Num(); }
+
+    // Activates every pending quest right away, ignoring MaxQuestActivationTimeMs.
+    UFUNCTION(BlueprintCallable, Category = "Quest Management")
+    void FlushPendingQuestActivations();
+
+    // Broadcast once the last pending quest activation has been processed.
+    FSimpleMulticastDelegate OnPendingQuestActivationsFinished;
+
     // Removes a quest from this player's active quests.
     // Call this when a quest is completed, failed, or abandoned.
     UFUNCTION(BlueprintCallable, Category = "Quest Management")
@@ -41,36 +109,384 @@ public:
     UFUNCTION(BlueprintPure, BlueprintCallable, Category = "Quest Management")
     bool IsQuestActive(UQuestNode* QuestToCheck) const;
 
-    // Checks if a specific quest has been completed by this player (requires a 'CompletedQuests' array)
-    // UFUNCTION(BlueprintPure, BlueprintCallable, Category = "Quest Management")
-    // bool HasQuestBeenCompleted(UQuestNode* QuestToCheck) const;
-    // ... You might add a TArray<UQuestNode*> CompletedQuests; UPROPERTY for this later.
+    // Checks if a specific quest has been completed by this player.
+    UFUNCTION(BlueprintPure, BlueprintCallable, Category = "Quest Management")
+    bool HasQuestBeenCompleted(const UQuestNode* QuestToCheck) const;
+
+    // Returns every quest this player has completed, in quest graph order. Builds a new array; meant for UI.
+    UFUNCTION(BlueprintPure, BlueprintCallable, Category = "Quest Management")
+    TArray<UQuestNode*> GetCompletedQuests() const;
+
+    UFUNCTION(BlueprintPure, BlueprintCallable, Category = "Quest Management")
+    int32 GetNumCompletedQuests() const;
+
+    // Returns when this player (last) completed a quest, or a zero FDateTime if it hasn't been completed.
+    UFUNCTION(BlueprintPure, BlueprintCallable, Category = "Quest Management")
+    FDateTime GetQuestCompletionTime(const UQuestNode* Quest) const;
+
+    // Log of this player's quest completions with timestamps, oldest first.
+    const FQuestCompletionHistory& GetCompletionHistory() const { return CompletionHistory; }
+
+    // Returns how many of a quest's prerequisites this player has not completed yet (0 means the quest is available).
+    UFUNCTION(BlueprintPure, BlueprintCallable, Category = "Quest Management")
+    int32 GetNumRemainingPrerequisites(const UQuestNode* Quest) const;
+
+    // Copies this player's state for an active quest into OutState. Returns false if the quest isn't active.
+    UFUNCTION(BlueprintPure, BlueprintCallable, Category = "Quest Management")
+    bool GetQuestState(const UQuestNode* Quest, FQuestRuntimeState& OutState) const;
+
+    // Returns this player's progress on one objective of an active quest (0 if the quest isn't active).
+    UFUNCTION(BlueprintPure, BlueprintCallable, Category = "Quest Management")
+    int32 GetObjectiveProgress(const UQuestNode* Quest, int32 ObjectiveIndex) const;
+
+    // Sets this player's progress on one objective of an active quest directly (e.g., from a scripted sequence).
+    // Completes the objective, and possibly the quest, if the new progress reaches the objective's RequiredProgress.
+    UFUNCTION(BlueprintCallable, Category = "Quest Management")
+    void SetObjectiveProgress(UQuestNode* Quest, int32 ObjectiveIndex, int32 NewProgress);
+
+    // Marks one objective of an active quest as complete for this player.
+    UFUNCTION(BlueprintCallable, Category = "Quest Management")
+    void CompleteObjective(UQuestNode* Quest, int32 ObjectiveIndex);
+
+    // Fails an active quest for this player: it is removed from the active quests without counting as completed.
+    UFUNCTION(BlueprintCallable, Category = "Quest Management")
+    bool FailQuest(UQuestNode* Quest);
+
+    // This player's index in UQuestProgressSubsystem, or INDEX_NONE before the first quest is added.
+    int32 GetProgressPlayerIndex() const { return ProgressPlayerIndex; }
 
     // --- EVENT ROUTING FUNCTIONS (CALLED BY GAME MODE / GLOBAL LISTENERS) ---
     // These functions act as the entry points for external systems to notify this specific player's quest manager.
     // The GameMode will call these after it filters global events (e.g., when a player gets a kill).
+    // Producers that only have the player's controller can use UQuestPlayerRegistrySubsystem::NotifyEventForPlayer.
 
     // Notifies the quest manager that an enemy was killed by this player.
+    // If bQueueEvents is set, the event is buffered and dispatched in the next batch instead (see QueueEvent).
+    UFUNCTION(BlueprintCallable, Category = "Quest Management|Events")
+    void NotifyEvent(const FObjectiveEventData& E);
+
+    // Buffers an event for batched dispatch during TickComponent.
+    // Identical events (same tag, player, triggering actor and payload) queued before the next flush are coalesced
+    // into a single event whose Count is the number of occurrences.
+    UFUNCTION(BlueprintCallable, Category = "Quest Management|Events")
+    void QueueEvent(const FObjectiveEventData& E);
+
+    // Dispatches every queued event right away, ignoring MaxEventProcessingTimeMs.
     UFUNCTION(BlueprintCallable, Category = "Quest Management|Events")
-    void NotifyEvent(FObjectiveEventData& E);
+    void FlushQueuedEvents();
+
+    // Tests this player's location objectives at Location right away (e.g., after a teleport or from an overlap),
+    // instead of waiting for UQuestLocationSubsystem's next periodic check.
+    UFUNCTION(BlueprintCallable, Category = "Quest Management|Events")
+    void NotifyLocationReached(FVector Location);
+
+    // Whether any active objective of this player would receive an event with this tag.
+    bool HasSubscribersForEvent(FName EventTag) const;
+
+    // Adds up the heap memory of this player's quest state, by category (see QuestMemoryReport.h).
+    void GetMemoryUsage(FQuestPlayerMemory& OutMemory) const;
 
     // Add similar functions for other objective types as needed:
     // UFUNCTION(BlueprintCallable, Category = "Quest Management|Events")
     // void NotifyItemCollected(AActor* CollectedItem);
-    // UFUNCTION(BlueprintCallable, Category = "Quest Management|Events")
-    // void NotifyLocationReached(FVector Location);
 
     // --- DELEGATES ---
+    // Completion is signalled internally through direct calls (objective -> quest manager), never through these;
+    // they exist for external listeners only, and are skipped entirely when nothing is bound.
+
     // Event broadcast when a quest managed by this component is completed by the player.
     UPROPERTY(BlueprintAssignable, Category = "Quest Management|Events")
     FOnPlayerQuestCompleted OnPlayerQuestCompletedDelegate;
 
+    // Event broadcast when an objective of an active quest is completed by the player.
+    UPROPERTY(BlueprintAssignable, Category = "Quest Management|Events")
+    FOnPlayerObjectiveCompleted OnPlayerObjectiveCompletedDelegate;
+
+    // Event broadcast when an active quest fails for the player.
+    UPROPERTY(BlueprintAssignable, Category = "Quest Management|Events")
+    FOnPlayerQuestFailed OnPlayerQuestFailedDelegate;
+
+    // Native versions of the delegates above for C++ listeners.
+    FOnPlayerQuestCompletedNative OnPlayerQuestCompletedNative;
+    FOnPlayerObjectiveCompletedNative OnPlayerObjectiveCompletedNative;
+    FOnPlayerQuestFailedNative OnPlayerQuestFailedNative;
+
+    // Event broadcast on the owning client after replicated changes to ActiveQuests have been applied.
+    UPROPERTY(BlueprintAssignable, Category = "Quest Management|Events")
+    FOnQuestLogUpdated OnQuestLogUpdatedDelegate;
+
+    // Called by ActiveQuests after a replication update; refreshes client-side lookups and notifies listeners.
+    void OnQuestLogReplicated();
+
+    // --- SAVE / LOAD ---
+    // Quest state is saved in the compact binary format described in FQuestSaveSnapshot.
+
+    // Saves this player's quest state to a save slot. The state is copied on the calling (game) thread;
+    // encoding and writing happen on a worker thread. OnQuestStateSavedDelegate fires when done.
+    UFUNCTION(BlueprintCallable, Category = "Quest Management|Save")
+    void SaveQuestStateAsync(const FString& SlotName, int32 UserIndex);
+
+    // Loads this player's quest state from a save slot, replacing the current state. Reading and parsing happen
+    // on a worker thread; the state is applied on the game thread. OnQuestStateLoadedDelegate fires when done.
+    // Active quests are then activated over the next frames (see RestoreSaveSnapshot, OnPendingQuestActivationsFinished).
+    UFUNCTION(BlueprintCallable, Category = "Quest Management|Save")
+    void LoadQuestStateAsync(const FString& SlotName, int32 UserIndex);
+
+    // Copies this player's quest state into a snapshot that can be serialized on any thread.
+    void CaptureSaveSnapshot(FQuestSaveSnapshot& OutSnapshot) const;
+
+    // Replaces this player's quest state with a snapshot. Must be called on the game thread.
+    // Completed quests are restored right away. Active quests are too, unless bTimeSliced: then they are activated
+    // over the next frames like AddQuests (without the availability checks), which keeps a login with 100+ active
+    // quests from stalling the frame. Pending restored quests are still part of CaptureSaveSnapshot.
+    bool RestoreSaveSnapshot(const FQuestSaveSnapshot& Snapshot, bool bTimeSliced = false);
+
+    UPROPERTY(BlueprintAssignable, Category = "Quest Management|Save")
+    FOnQuestStateSaved OnQuestStateSavedDelegate;
+
+    UPROPERTY(BlueprintAssignable, Category = "Quest Management|Save")
+    FOnQuestStateLoaded OnQuestStateLoadedDelegate;
+
+    // Stable key of this player's quest state in the server's write-ahead journal (see UQuestJournalSubsystem).
+    // If empty, the owning PlayerState's unique net ID is used once it is known (BeginPlay, or PostLogin for a
+    // joining player).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest Management|Save")
+    FString PersistenceId;
+
+    // --- EVENT QUEUE SETTINGS ---
+    // When true, NotifyEvent queues events instead of dispatching them synchronously.
+    // Use this for players that can generate bursts of events (e.g., AoE kills).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest Management|Events")
+    bool bQueueEvents = false;
+
+    // How often queued events are flushed, in seconds. 0 flushes every frame.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Quest Management|Events", meta = (ClampMin = "0.0"))
+    float EventFlushInterval = 0.0f;
+
+    // Maximum time spent dispatching queued events per flush, in milliseconds. 0 means no limit.
+    // Events that don't fit in the budget are carried over to the next flush.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest Management|Events", meta = (ClampMin = "0.0"))
+    float MaxEventProcessingTimeMs = 1.0f;
+
+    // Maximum time spent activating pending quests (AddQuests, time-sliced restores) per tick, in milliseconds
+    // (0.2 = 200 microseconds). At least one quest is activated per tick. 0 means no limit.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest Management", meta = (ClampMin = "0.0"))
+    float MaxQuestActivationTimeMs = 0.2f;
+
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
-    // Callback function when an individual UQuestNode (managed by this component) completes all its objectives.
-    // This function MUST be a UFUNCTION() to be bound using AddDynamic.
-    UFUNCTION()
+    // Flushes any events still in the queue and releases this player's progress rows.
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    // Only ticks while events are queued; dispatches them within MaxEventProcessingTimeMs.
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+    // Called when all objectives of an active quest are complete for this player.
     void OnQuestCompleted(UQuestNode* CompletedQuest);
+
+private:
+    // The progress subsystem applies multi-player events through ApplyObjectiveProgress, and moves progress rows
+    // when it trims its pools (OnQuestRowsMoved).
+    friend class UQuestProgressSubsystem;
+    // The journal subsystem attaches itself once it has restored this player's recovered state.
+    friend class UQuestJournalSubsystem;
+    // The timer subsystem reports expired time limits through OnObjectiveTimeLimitExpired.
+    friend class UQuestTimerSubsystem;
+
+    // Completes the objective or fails its quest, depending on the objective's ExpiryBehavior.
+    void OnObjectiveTimeLimitExpired(const UTimedObjective* Objective);
+
+    // UTC deadline of Objective's time limit for this player, or a zero FDateTime if its quest isn't active.
+    FDateTime GetObjectiveDeadline(const UTimedObjective* Objective) const;
+
+    // --- JOURNAL ---
+    // Write-ahead journal this player's mutations are recorded in (server only), or nullptr.
+    UQuestJournalSubsystem* JournalSubsystem = nullptr;
+
+    // Appends a mutation of this player's quest state to the journal, if journaling.
+    void JournalMutation(EQuestJournalOp Op, const UQuestNode* Quest, int32 ObjectiveIndex = 0, int64 Value = 0);
+
+    // Resolves PersistenceId and registers with the journal subsystem, once the player's unique net ID is known.
+    void StartJournaling();
+
+    // Finishes StartJournaling for a joining player, whose unique net ID is only set during login.
+    void OnPlayerPostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer);
+    FDelegateHandle PostLoginHandle;
+
+    // --- EVENT CAPTURE ---
+    // Records this player's events and AddQuest calls while a capture is running (see UQuestEventRecorderSubsystem).
+    UQuestEventRecorderSubsystem* EventRecorder = nullptr;
+
+    // --- PROGRESS TABLE ---
+    // World subsystem holding this player's objective progress, and this player's index in it.
+    UQuestProgressSubsystem* ProgressSubsystem = nullptr;
+    int32 ProgressPlayerIndex = INDEX_NONE;
+
+    // Registers this player with the world's UQuestProgressSubsystem if needed. Returns nullptr if there is none.
+    UQuestProgressSubsystem* GetOrRegisterProgressPlayer();
+
+    // Updates an active quest's FirstProgressRow after the progress subsystem compacted its table.
+    void OnQuestRowsMoved(const UQuestNode* Quest, int32 NewFirstRow);
+
+    // Routes a single event to the objectives subscribed to its tag.
+    void DispatchEvent(const FObjectiveEventData& E);
+
+    // --- EVENT QUEUE ---
+    // Identity used to coalesce queued events. Count is deliberately not part of it, and TriggeringActor is null
+    // unless an objective receiving the tag reads it (see UObjective::ReadsTriggeringActor).
+    struct FQueuedEventKey
+    {
+        FName EventTag;
+        FObjectKey PlayerController;
+        FObjectKey TriggeringActor;
+        FQuestEventPayload Payload;
+
+        bool operator==(const FQueuedEventKey& Other) const
+        {
+            return EventTag == Other.EventTag && PlayerController == Other.PlayerController && TriggeringActor == Other.TriggeringActor && Payload == Other.Payload;
+        }
+
+        friend uint32 GetTypeHash(const FQueuedEventKey& Key)
+        {
+            const uint32 Hash = HashCombine(HashCombine(GetTypeHash(Key.EventTag), GetTypeHash(Key.PlayerController)), GetTypeHash(Key.TriggeringActor));
+            return HashCombine(Hash, GetTypeHash(Key.Payload));
+        }
+    };
+
+    // An event waiting for its flush, which can be frames away (EventFlushInterval, the processing budget). Nothing
+    // keeps its actors alive meanwhile, so Event holds none: they are kept weak and resolved at dispatch.
+    struct FQueuedEvent
+    {
+        FObjectiveEventData Event;
+        TWeakObjectPtr<APlayerController> PlayerController;
+        TWeakObjectPtr<AActor> TriggeringActor;
+        FQueuedEventKey Key;
+
+        // Returns the event with its actors filled back in, or false if the player controller, or a triggering
+        // actor that objectives read (one the event is keyed by), has been destroyed since.
+        bool Resolve(FObjectiveEventData& OutEvent) const;
+    };
+
+    // Events waiting for the next flush, in arrival order.
+    TArray<FQueuedEvent> QueuedEvents;
+
+    // Index into QueuedEvents for each distinct queued event, used for coalescing.
+    TMap<FQueuedEventKey, int32> QueuedEventIndices;
+
+    // Adds an event to the queue, merging it into an identical queued event if there is one.
+    void EnqueueEvent(const FObjectiveEventData& E);
+    void EnqueueEvent(FQueuedEvent&& Queued);
+
+    // Whether any objective this player has subscribed to EventTag reads the event's TriggeringActor.
+    bool IsTriggeringActorRead(FName EventTag) const;
+
+    // Dispatches queued events until the queue is empty or TimeBudgetSeconds is spent (0 = no budget).
+    void ProcessQueuedEvents(double TimeBudgetSeconds);
+
+    // --- ACTIVE QUEST LOOKUP ---
+    // Index of each active quest's state in ActiveQuests.
+    TMap<const UQuestNode*, int32> ActiveQuestIndices;
+
+    // Returns this player's state for an active quest, or nullptr.
+    FQuestRuntimeState* FindActiveQuestState(const UQuestNode* Quest);
+    const FQuestRuntimeState* FindActiveQuestState(const UQuestNode* Quest) const;
+
+    // Stores new progress for an objective and handles objective/quest completion.
+    void ApplyObjectiveProgress(UQuestNode* Quest, int32 ObjectiveIndex, int32 NewProgress);
+
+    // Flags one quest's state (or the whole array, after a removal) for replication.
+    void MarkQuestStateDirty(FQuestRuntimeState& State);
+    void MarkActiveQuestsDirty();
+
+    // --- COMPLETED QUESTS ---
+    // One bit per quest in the compiled quest graph, indexed by UQuestNode::QuestId.
+    // The definitions themselves are kept alive by the quest graph, so no UObject references are needed here.
+    TBitArray<> CompletedQuestBits;
+
+    // Every completion with its timestamp, compressed (see FQuestCompletionHistory).
+    UPROPERTY()
+    FQuestCompletionHistory CompletionHistory;
+
+    // Records a quest in CompletedQuestBits and CompletionHistory.
+    void MarkQuestCompleted(const UQuestNode* Quest);
+    void SetQuestCompletedBit(int32 QuestId);
+
+    // Calls InitializeObjective/UninitializeObjective on the objectives of a quest that aren't complete yet.
+    void InitializeOpenObjectives(const FQuestRuntimeState& State);
+    void UninitializeOpenObjectives(const FQuestRuntimeState& State);
+
+    // Creates this player's state for a quest (progress rows, objectives, event subscriptions) without any checks.
+    // InitialProgress holds restored objective counters; missing entries start at 0. InitialDeadlines holds restored
+    // time limit deadlines; objectives without one get a new deadline, TimeLimit from now.
+    bool ActivateQuest(UQuestNode* Quest, TConstArrayView<int32> InitialProgress, TConstArrayView<int64> InitialDeadlines = TConstArrayView<int64>());
+
+    // Journals the time limit deadlines of an active quest. Called once the quest's activation has been journaled.
+    void JournalObjectiveDeadlines(const UQuestNode* Quest);
+
+    // Completes an active quest that has no objectives. Called once the quest's activation has been journaled.
+    void CompleteIfWithoutObjectives(UQuestNode* Quest);
+
+    // --- PENDING ACTIVATIONS ---
+    // In request order. Referenced here as well as by the quest graph, so a quest removed from the graph meanwhile
+    // can't be collected under the queue.
+    UPROPERTY()
+    TArray<FQuestPendingActivation> PendingActivations;
+
+    // Activates pending quests until none are left or TimeBudgetSeconds is spent (0 = no budget).
+    void ProcessPendingActivations(double TimeBudgetSeconds);
+
+    // Ticks while there are queued events or pending activations.
+    void UpdateTickEnabled();
+
+    // --- QUEST AVAILABILITY ---
+    // Number of uncompleted prerequisites of each quest in the compiled quest graph, indexed by UQuestNode::QuestId.
+    // Completing a quest decrements the counters of its follow-ups; a follow-up unlocks when its counter hits 0.
+    TArray<uint16> RemainingPrerequisites;
+
+    // Adds counters for quests compiled into the graph since the last call.
+    void SyncPrerequisiteCounters();
+
+    // Decrements the counters of a completed quest's follow-ups and unlocks those that reach 0.
+    void UnlockFollowUps(const UQuestNode* CompletedQuest);
+
+    // --- EVENT SUBSCRIBER INDEX ---
+    // An objective of one of this player's active quests. Objectives are shared between players,
+    // so they're identified by quest and index rather than by the UObjective itself.
+    struct FObjectiveSubscriber
+    {
+        UQuestNode* Quest;
+        int32 ObjectiveIndex;
+
+        bool operator==(const FObjectiveSubscriber& Other) const
+        {
+            return Quest == Other.Quest && ObjectiveIndex == Other.ObjectiveIndex;
+        }
+    };
+
+    // Maps an event tag (index in FQuestEventTags) to the objectives of active quests that declared it in
+    // HandledEventTags, so NotifyEvent only touches objectives that care about the event instead of every active objective.
+    // An event is looked up under its own tag and each of its ancestors. An objective is only listed under tags that
+    // none of its other tags is an ancestor of, so it is found at most once per event.
+    // Quests are kept alive by ActiveQuests, so raw pointers are safe as long as the
+    // index is updated by AddQuest/RemoveQuest/objective completion.
+    TMap<int32, TArray<FObjectiveSubscriber>> EventSubscribers;
+
+    // Bits of the tags in EventSubscribers. An event with no subscribers at all is rejected with one AND of this
+    // and the event tag's ancestor mask.
+    TBitArray<> SubscribedTagMask;
+
+    // Objectives with no HandledEventTags; these receive every event.
+    TArray<FObjectiveSubscriber> WildcardSubscribers;
+
+    // Adds/removes all uncompleted objectives of a quest to/from the subscriber index.
+    void RegisterQuestObjectives(const FQuestRuntimeState& State);
+    void UnregisterQuestObjectives(UQuestNode* Quest);
+
+    // Adds/removes a single objective to/from the subscriber index.
+    void RegisterObjective(const FObjectiveSubscriber& Subscriber);
+    void UnregisterObjective(const FObjectiveSubscriber& Subscriber);
 };
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QuestSystem/Objective.h"
+#include "LocationObjective.generated.h"
+
+/**
+ * "Reach this place" objective.
+ *
+ * While a player has this objective active, its region (a sphere) is registered with UQuestLocationSubsystem,
+ * which tests the player's position against nearby regions only and sends an event tagged RegionTag when the
+ * player enters the region. RegionTag is added to HandledEventTags automatically, so only this objective
+ * (and others sharing the tag) receive it.
+ */
+UCLASS()
+class ANATHEMA_API ULocationObjective : public UObjective
+{
+	GENERATED_BODY()
+
+public:
+    // Center of the region to reach.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Objective|Location")
+    FVector TargetLocation = FVector::ZeroVector;
+
+    // Radius of the region to reach.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Objective|Location", meta = (ClampMin = "1.0"))
+    float Radius = 500.0f;
+
+    // Event tag sent when a player enters the region. Should be unique per place (e.g., "Reached.OldMill").
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Objective|Location")
+    FName RegionTag;
+
+    virtual void PostInitProperties() override;
+    virtual void PostLoad() override;
+
+    // Events are only counted, as in UObjective; subclasses have to opt in again.
+    virtual bool CanProcessEventsInParallel() const override;
+    virtual bool ReadsTriggeringActor() const override;
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+protected:
+    // Registers/unregisters the region with UQuestLocationSubsystem for the player.
+    virtual void InitializeObjective_Implementation(AActor* OwningActor) const override;
+    virtual void UninitializeObjective_Implementation(AActor* OwningActor) const override;
+
+private:
+    // Makes sure RegionTag is one of HandledEventTags.
+    void SyncHandledEventTags();
+};
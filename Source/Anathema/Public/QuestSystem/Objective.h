@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "Delegates/Delegate.h"
+#include "QuestSystem/QuestEventPayload.h"
 #include "Objective.generated.h"
 
 // Define a common base struct for event data
@@ -24,22 +25,37 @@ struct FObjectiveEventData
 
     UPROPERTY(BlueprintReadWrite, Category = "Objective Event")
     AActor* TriggeringActor = nullptr; // e.g., the killed enemy, collected item
-    // Add more common event data as needed.
+
+    // How many identical occurrences this event stands for.
+    // Queued events are coalesced by UQuestManagerComponent, so objectives should apply Count
+    // (e.g., return CurrentProgress + Count) instead of assuming one occurrence per call.
+    UPROPERTY(BlueprintReadWrite, Category = "Objective Event")
+    int32 Count = 1;
+
+    // Event-specific data (item, damage, location, ...); see FQuestEventPayload. Read it with GetPayload<T>().
+    // Not a UPROPERTY: it's read natively by objectives, without reflection, and copied along with the event.
+    FQuestEventPayload Payload;
 
     FObjectiveEventData() {}
 
-    FObjectiveEventData(FName& Tag, APlayerController* PlayerController, AActor* Actor) // For EnemyKilled, CollectedItem,
+    FObjectiveEventData(FName Tag, APlayerController* PlayerController, AActor* Actor) // For EnemyKilled, CollectedItem,
         : EventTag(Tag), ResponsiblePlayerController(PlayerController), TriggeringActor(Actor) {
     }
-};
 
-// Define a delegate to notify when an objective is completed
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnObjectiveCompleted, UObjective*, CompletedObjective);
+    // Returns the payload if it is a T, nullptr otherwise.
+    template <typename T>
+    const T* GetPayload() const { return Payload.Get<T>(); }
+};
 
 /**
  * Base class for all quest objectives.
  * This class serves as an abstract base for different objective types.
  *
+ * Objectives are part of a quest's definition and are shared by every player that has the quest,
+ * so they must not store per-player state. A player's progress on an objective is a single counter kept in
+ * UQuestProgressSubsystem's progress table (viewed through the player's UQuestManagerComponent), which is passed into
+ * the functions below. The objective is complete once that counter reaches RequiredProgress.
+ *
  * UCLASS() specifiers:
  *   - Blueprintable: Allows creating Blueprint classes from this C++ class.
  *   - BlueprintType: Allows this C++ class to be used as a type in Blueprints (e.g., for variables).
@@ -63,57 +79,95 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Objective")
     FText ObjectiveDescription;
 
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Objective")
-    bool bIsCompleted;
+    // Event tags (FObjectiveEventData::EventTag) this objective wants to receive.
+    // UQuestManagerComponent indexes objectives by these tags, so ProcessGameEvent is only called for matching events.
+    // Tags are hierarchical (see FQuestEventTags): "Event.Kill" also receives "Event.Kill.Goblin.Archer".
+    // Leave empty to receive every event (useful for objectives that inspect the event themselves).
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Objective")
+    TArray<FName> HandledEventTags;
+
+    // Progress a player needs to reach for this objective to be complete (e.g., 5 for "Kill 5 Goblins").
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Objective", meta = (ClampMin = "1"))
+    int32 RequiredProgress;
 
     // --- Functions (BlueprintNativeEvent allows C++ implementation and Blueprint override) ---
+    // All of these are const: the objective is shared between players, per-player data is passed in.
 
-    // Initializes the objective (e.g., binds to game events, resets internal state).
+    // Called when a quest containing this objective becomes active for a player (e.g., to spawn markers).
     // This is a BlueprintNativeEvent, meaning it has a C++ default implementation
     // (InitializeObjective_Implementation) and can be overridden in Blueprints.
     UFUNCTION(BlueprintNativeEvent, Category = "Objective")
-    void InitializeObjective(AActor* OwningActor); // Pass context like the quest owner
+    void InitializeObjective(AActor* OwningActor) const; // Pass context like the quest owner
 
-    // Uninitializes the objective (e.g., unbinds from game events).
-    // Called when the quest containing this objective becomes inactive or completed.
+    // Called when the objective is completed, or its quest becomes inactive for a player.
     UFUNCTION(BlueprintNativeEvent, Category = "Objective")
-    void UninitializeObjective(); // No parameters needed for base uninitialization
+    void UninitializeObjective(AActor* OwningActor) const;
 
-    // Checks if the objective is currently complete.
+    // Checks if the objective is complete for the given progress.
     // This is BlueprintPure as it just checks state, no side effects.
     // It's also a BlueprintNativeEvent for C++ and Blueprint overrides.
     UFUNCTION(BlueprintPure, BlueprintNativeEvent, Category = "Objective")
-    bool IsObjectiveCurrentlyComplete() const;
+    bool IsObjectiveCurrentlyComplete(int32 Progress) const;
 
-    // Returns current progress text (e.g., "0/5 Goblins Killed").
+    // Returns progress text for the given progress (e.g., "0/5 Goblins Killed").
     // BlueprintPure, BlueprintNativeEvent.
     UFUNCTION(BlueprintPure, BlueprintNativeEvent, Category = "Objective")
-    FText GetProgressText() const;
+    FText GetProgressText(int32 Progress) const;
 
-    // Marks the objective as complete and triggers relevant events.
-    // This usually contains common logic and broadcasts the completion delegate.
-    UFUNCTION(BlueprintCallable, Category = "Objective")
-    void CompleteObjective();
+    // --- Universal Event Processing Function ---
+    // Called by UQuestManagerComponent for events matching HandledEventTags.
+    // Returns the player's new progress for this objective; returning CurrentProgress means the event didn't count.
+    // Derived classes override this to implement specific logic (e.g., only count kills of a certain enemy class).
+    UFUNCTION(BlueprintNativeEvent, Category = "Objective")
+    int32 ProcessGameEvent(const FObjectiveEventData& EventData, int32 CurrentProgress) const;
+
+    // Whether an event tagged EventTag reaches this objective: HandledEventTags is empty, or contains EventTag
+    // or one of its ancestors. Handy for wildcard objectives that filter events themselves.
+    UFUNCTION(BlueprintPure, Category = "Objective")
+    bool HandlesEventTag(FName EventTag) const;
+
+    // Builds the tag mask HandlesEventTag tests events against from HandledEventTags. Called on the game thread by
+    // FQuestGraph when the objective's quest is compiled, by which time its tags are final.
+    void UpdateHandledTagMask();
+
+    // --- Parallel event processing ---
+    // Whether ProcessGameEventThreadSafe may be called from worker threads. UQuestProgressSubsystem uses this to
+    // evaluate world-wide events for many players in parallel; objectives that return false are evaluated on the
+    // game thread instead. Opt-in: only the built-in objective classes return true. A subclass (C++ or Blueprint)
+    // runs on the game thread unless it overrides this, which a C++ subclass may do if its
+    // ProcessGameEvent_Implementation only reads the event and its own properties.
+    virtual bool CanProcessEventsInParallel() const;
+
+    // Calls the native ProcessGameEvent_Implementation directly, bypassing ProcessEvent.
+    // Only valid when CanProcessEventsInParallel() returns true.
+    int32 ProcessGameEventThreadSafe(const FObjectiveEventData& EventData, int32 CurrentProgress) const
+    {
+        return ProcessGameEvent_Implementation(EventData, CurrentProgress);
+    }
 
-    // --- Delegates ---
-    // Event triggered when this objective is completed.
-    UPROPERTY(BlueprintAssignable, Category = "Objective")
-    FOnObjectiveCompleted OnObjectiveCompletedDelegate;
+    // --- Event coalescing ---
+    // Whether ProcessGameEvent looks at FObjectiveEventData::TriggeringActor. If no objective receiving a tag does,
+    // UQuestManagerComponent coalesces queued events regardless of their actor (keeping the last one), so e.g. an area
+    // attack killing ten enemies is dispatched once with Count 10. Opt-out: only the built-in objective classes return
+    // false. A subclass is assumed to read the actor unless it overrides this.
+    virtual bool ReadsTriggeringActor() const;
 
-    // --- NEW: Universal Event Processing Function ---
-    // This function will be called by UQuestManagerComponent for any relevant event.
-    // Derived classes will override this to implement specific logic.
-    UFUNCTION(BlueprintNativeEvent, Category = "Objective")
-    void ProcessGameEvent(const FObjectiveEventData& EventData);
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 
 protected:
     // --- C++ Implementation for BlueprintNativeEvents ---
     // You MUST provide a C++ body for BlueprintNativeEvents with _Implementation suffix.
     // These are also 'virtual' to allow C++ subclasses to override them further.
 
-    virtual void InitializeObjective_Implementation(AActor* OwningActor);
-    virtual void UninitializeObjective_Implementation();
-    virtual bool IsObjectiveCurrentlyComplete_Implementation() const;
-    virtual FText GetProgressText_Implementation() const;
-    virtual void ProcessGameEvent_Implementation(const FObjectiveEventData& EventData);
+    virtual void InitializeObjective_Implementation(AActor* OwningActor) const;
+    virtual void UninitializeObjective_Implementation(AActor* OwningActor) const;
+    virtual bool IsObjectiveCurrentlyComplete_Implementation(int32 Progress) const;
+    virtual FText GetProgressText_Implementation(int32 Progress) const;
+    virtual int32 ProcessGameEvent_Implementation(const FObjectiveEventData& EventData, int32 CurrentProgress) const;
+
+private:
+    // Bits of HandledEventTags (see FQuestEventTags), or empty until UpdateHandledTagMask runs.
+    TBitArray<> HandledTagMask;
 };
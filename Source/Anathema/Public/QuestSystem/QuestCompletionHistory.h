@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QuestCompletionHistory.generated.h"
+
+/**
+ * FQuestCompletionHistory is an append-only log of the quests a player has completed, and when.
+ *
+ * Entries are delta-encoded into a byte buffer: each one stores the difference to the previous entry's quest ID
+ * (zigzag varint) and the seconds elapsed since the previous completion (varint). A typical entry takes 2-4 bytes,
+ * so a character with thousands of finished quests carries a few kilobytes of history.
+ * The log is only read for UI and persistence; "has this quest been completed" is answered by the
+ * completed-quest bitset in UQuestManagerComponent.
+ *
+ * Quest IDs come from the compiled quest graph and are only stable for the lifetime of the process.
+ */
+USTRUCT()
+struct ANATHEMA_API FQuestCompletionHistory
+{
+    GENERATED_BODY()
+
+    // Appends a completion. UnixTimestamp is in seconds.
+    void Add(int32 QuestId, int64 UnixTimestamp);
+
+    // Decodes every entry, oldest first.
+    void ForEachEntry(TFunctionRef<void(int32 QuestId, int64 UnixTimestamp)> Visitor) const;
+
+    // Returns the time a quest was (last) completed, or 0 if it isn't in the log. Decodes the whole log.
+    int64 FindCompletionTime(int32 QuestId) const;
+
+    int32 Num() const { return NumEntries; }
+
+    // Size of the encoded log in bytes.
+    int32 GetEncodedSize() const { return EncodedEntries.Num(); }
+
+    // Heap memory held by the log.
+    SIZE_T GetAllocatedSize() const { return EncodedEntries.GetAllocatedSize(); }
+
+    void Reset();
+
+private:
+    static void WriteVarInt(TArray<uint8>& Out, uint64 Value);
+    static uint64 ReadVarInt(const TArray<uint8>& In, int32& Offset);
+
+    UPROPERTY()
+    TArray<uint8> EncodedEntries;
+
+    UPROPERTY()
+    int32 NumEntries = 0;
+
+    // Last entry's values, which the next entry is encoded against.
+    UPROPERTY()
+    int32 LastQuestId = 0;
+
+    UPROPERTY()
+    int64 LastTimestamp = 0;
+};
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "QuestSystem/QuestGraph.h"
+#include "QuestDefinitionSubsystem.generated.h"
+
+class UQuestNode;
+
+/**
+ * UQuestDefinitionSubsystem owns the compiled quest graph (see FQuestGraph).
+ *
+ * Quest definitions are shared by every player and every world, so the graph lives at engine level and
+ * is compiled once per process. Quests are compiled the first time they are registered, either explicitly
+ * (e.g., when a quest data asset is loaded) or implicitly by UQuestManagerComponent::AddQuest.
+ *
+ * Compiled quests are put in GC clusters (quest.ClusterDefinitions), so the definitions cost garbage collection
+ * one reachability check per cluster rather than a trace of every quest and objective. Per-player runtime state
+ * points into the definitions from flat, non-reflected tables, except the replicated ActiveQuests array.
+ */
+UCLASS()
+class ANATHEMA_API UQuestDefinitionSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+    // Returns the subsystem, or nullptr if the engine isn't up yet.
+    static UQuestDefinitionSubsystem* Get();
+
+    // Compiles the given quests, and every quest connected to them, into the quest graph.
+    // Registering the root quests of a quest line up front avoids compiling it during gameplay.
+    UFUNCTION(BlueprintCallable, Category = "Quest Management")
+    void RegisterQuests(const TArray<UQuestNode*>& Quests);
+
+    // Compiles a single quest (and its connected quests) if it isn't part of the graph yet.
+    void RegisterQuest(UQuestNode* Quest);
+
+    // Removes the quests compiled since FirstQuestId (the graph's Num() before they were registered), so synthetic
+    // quests (benchmarks, load tests) don't stay in the graph for the rest of the process. IDs are dense, so only the
+    // most recently compiled quests can be removed, and quests compiled after them are removed too (they compile
+    // again when next registered). Quest managers that track any of them must be destroyed first.
+    void UnregisterQuestsFrom(int32 FirstQuestId);
+
+    const FQuestGraph& GetQuestGraph() const { return QuestGraph; }
+
+    // Puts each quest that can be a cluster root (see UQuestNode::CanBeClusterRoot) in a GC cluster with its
+    // objectives. Quests already in a cluster are skipped; a quest line usually ends up as one cluster rooted at
+    // its first quest, since clusters take in the quests they reference. Returns how many of Quests are clustered.
+    int32 ClusterQuests(TConstArrayView<UQuestNode*> Quests);
+
+    // Whether Quest is a cluster root or part of a cluster. Clustered quests must not gain references: garbage
+    // collection doesn't trace them, so a newly referenced object could be collected while still in use.
+    static bool IsClustered(const UQuestNode* Quest);
+
+protected:
+    virtual void Deinitialize() override;
+
+private:
+    // Clusters the quests compiled since FirstQuestId, if enabled. Not in the editor, where definitions get edited.
+    void ClusterNewQuests(int32 FirstQuestId);
+
+    UPROPERTY()
+    FQuestGraph QuestGraph;
+};
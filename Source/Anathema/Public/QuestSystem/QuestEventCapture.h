@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+#include "UObject/ObjectKey.h"
+#include "QuestSystem/QuestEventPayload.h"
+
+// A player seen during a capture, with their quest state at that moment (FQuestSaveSnapshot::WriteTo format).
+// Since version 2, time limit deadlines in InitialState are ticks since the capture started rather than UTC ticks,
+// so a replay can rebase them onto its own clock.
+struct FQuestCapturedPlayer
+{
+    FString Name;
+    TArray<uint8> InitialState;
+};
+
+// An actor that triggered captured events. Only its identity is kept; the replayer can spawn a stand-in of Class.
+struct FQuestCapturedActor
+{
+    FString Name;
+    FSoftClassPath Class;
+};
+
+enum class EQuestCapturedEventKind : uint8
+{
+    // NotifyEvent on one player's quest manager, dispatched right away.
+    Event = 0,
+    // QueueEvent, or NotifyEvent on a manager with bQueueEvents: dispatched in a later batch.
+    QueuedEvent = 1,
+    // UQuestProgressSubsystem::ProcessEventForAllPlayers.
+    WorldEvent = 2,
+    // A quest was added to a player (UQuestManagerComponent::AddQuest).
+    QuestAdded = 3,
+    // UQuestProgressSubsystem::ProcessEventForPlayers, for the players in GroupPlayers.
+    GroupEvent = 4,
+};
+
+struct FQuestCapturedEvent
+{
+    EQuestCapturedEventKind Kind = EQuestCapturedEventKind::Event;
+    // Seconds since the capture started, and the engine frame (GFrameCounter) relative to the first captured frame.
+    double Time = 0.0;
+    uint64 Frame = 0;
+    // Index into FQuestEventCapture::Players; INDEX_NONE for world and group events.
+    int32 Player = INDEX_NONE;
+    // GroupEvent only: indices into FQuestEventCapture::Players.
+    TArray<int32> GroupPlayers;
+    FName EventTag;
+    // Indices into FQuestEventCapture::Actors, or INDEX_NONE. The player controller is only recorded since version 2.
+    int32 TriggeringActor = INDEX_NONE;
+    int32 ResponsiblePlayerController = INDEX_NONE;
+    int32 Count = 1;
+    FQuestEventPayload Payload;
+    // QuestAdded only.
+    FSoftObjectPath Quest;
+};
+
+/**
+ * A recorded stream of quest events (see UQuestEventRecorderSubsystem), fully loaded in memory.
+ *
+ * File layout (little endian): uint32 Magic, uint16 Version, uint16 Reserved, then chunks of
+ * uint32 ChunkSize + chunk. A chunk first lists the tags, players, actors, payload types and quests first referenced
+ * by its events (so every string is written once per capture), then the events themselves as packed integers with
+ * frame and time deltas. Chunks are written as the capture goes, so a capture cut short by a crash is still readable
+ * up to its last complete chunk.
+ */
+struct ANATHEMA_API FQuestEventCapture
+{
+    TArray<FQuestCapturedPlayer> Players;
+    TArray<FQuestCapturedActor> Actors;
+    TArray<FQuestCapturedEvent> Events;
+    // Format version of the file this was loaded from.
+    uint16 Version = CurrentVersion;
+
+    // Reads a capture file. Returns false if the file can't be read or isn't a capture; a truncated last chunk is ignored.
+    bool LoadFromFile(const FString& Path);
+
+    static constexpr uint32 Magic = 0x50414351; // "QCAP"
+    // 2: ResponsiblePlayerController per event, deadlines in InitialState relative to the capture start.
+    static constexpr uint16 CurrentVersion = 2;
+};
+
+/**
+ * Writes a capture file incrementally. Game thread only.
+ */
+class ANATHEMA_API FQuestEventCaptureWriter
+{
+public:
+    ~FQuestEventCaptureWriter();
+
+    bool Open(const FString& Path);
+    void Close();
+    bool IsOpen() const { return FileWriter.IsValid(); }
+
+    // Returns the index of a player (Key identifies it, e.g. its quest manager), registering it with its current
+    // quest state the first time it's seen.
+    int32 FindOrAddPlayer(FObjectKey Key, const FString& Name, TFunctionRef<void(TArray<uint8>&)> GetInitialState);
+
+    // Returns the index of an actor, registering it if needed, or INDEX_NONE for nullptr.
+    int32 FindOrAddActor(const AActor* Actor);
+
+    // Appends an event; Time is in seconds since the capture started. Events are flushed in chunks.
+    void AddEvent(const FQuestCapturedEvent& Event);
+
+    // Writes buffered events to the file.
+    void Flush();
+
+    int64 GetNumEvents() const { return NumEvents; }
+    int64 GetNumBytesWritten() const { return NumBytesWritten; }
+
+    // A chunk is written once this many events are buffered.
+    static constexpr int32 EventsPerChunk = 4096;
+
+private:
+    // Values referenced by events, indexed by key. Values added since the last chunk are written at its start.
+    template <typename KeyType, typename ValueType>
+    struct TTable
+    {
+        TMap<KeyType, int32> Indices;
+        TArray<ValueType> Values;
+        int32 NumWritten = 0;
+
+        template <typename FactoryType>
+        int32 FindOrAdd(const KeyType& Key, FactoryType&& MakeValue)
+        {
+            if (const int32* Index = Indices.Find(Key))
+            {
+                return *Index;
+            }
+            const int32 NewIndex = Values.Add(MakeValue());
+            Indices.Add(Key, NewIndex);
+            return NewIndex;
+        }
+    };
+
+    TUniquePtr<FArchive> FileWriter;
+
+    TTable<FName, FString> Tags;
+    TTable<FObjectKey, FQuestCapturedPlayer> Players;
+    TTable<FObjectKey, FQuestCapturedActor> Actors;
+    TTable<const UScriptStruct*, FString> PayloadTypes;
+    TTable<FSoftObjectPath, FString> Quests;
+
+    // Events of the current chunk, already encoded.
+    TArray<uint8> PendingEvents;
+    int32 NumPendingEvents = 0;
+    uint64 PreviousFrame = 0;
+    uint64 PreviousTimeMicros = 0;
+
+    int64 NumEvents = 0;
+    int64 NumBytesWritten = 0;
+};
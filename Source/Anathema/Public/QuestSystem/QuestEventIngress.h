@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QuestSystem/QuestEventPayload.h"
+#include <atomic>
+
+class UQuestManagerComponent;
+class APlayerController;
+
+/**
+ * A quest event posted from any thread, dispatched later on the game thread.
+ * Only holds weak object pointers: the objects may be gone by the time the event is drained.
+ */
+struct FQuestIngressEvent
+{
+    // Player the event is for. Unset sends the event to every player (see UQuestProgressSubsystem::ProcessEventForAllPlayers).
+    TWeakObjectPtr<UQuestManagerComponent> QuestManager;
+
+    FName EventTag;
+    TWeakObjectPtr<APlayerController> ResponsiblePlayerController;
+    TWeakObjectPtr<AActor> TriggeringActor;
+    int32 Count = 1;
+    FQuestEventPayload Payload;
+};
+
+/**
+ * FQuestEventIngressQueue is a bounded, lock-free multi-producer/single-consumer ring of FQuestIngressEvents.
+ *
+ * Each cell carries a sequence number that tells producers whether it is free and the consumer whether it is filled
+ * (Vyukov's bounded queue). Producers claim a cell with one compare-and-swap on the enqueue position; the single
+ * consumer (the game thread) needs no atomic read-modify-write at all. All cells are allocated up front, so posting
+ * never allocates; when the ring is full, Enqueue fails and the event is counted as dropped.
+ */
+class ANATHEMA_API FQuestEventIngressQueue
+{
+public:
+    // Capacity is rounded up to a power of two.
+    explicit FQuestEventIngressQueue(int32 InCapacity);
+
+    FQuestEventIngressQueue(const FQuestEventIngressQueue&) = delete;
+    FQuestEventIngressQueue& operator=(const FQuestEventIngressQueue&) = delete;
+
+    // Any thread. Returns false (and counts a drop) if the queue is full.
+    bool Enqueue(const FQuestIngressEvent& Event);
+
+    // Consumer thread only. Returns false if the queue is empty.
+    bool Dequeue(FQuestIngressEvent& OutEvent);
+
+    // Returns the number of events dropped since the last call and resets it.
+    int32 ConsumeNumDropped() { return NumDropped.exchange(0, std::memory_order_relaxed); }
+
+    int32 GetCapacity() const { return static_cast<int32>(Mask + 1); }
+
+private:
+    struct FCell
+    {
+        std::atomic<uint64> Sequence{ 0 };
+        FQuestIngressEvent Event;
+    };
+
+    TUniquePtr<FCell[]> Cells;
+    uint64 Mask = 0;
+
+    // Producers and the consumer each get their own cache line.
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> EnqueuePos{ 0 };
+    alignas(PLATFORM_CACHE_LINE_SIZE) uint64 DequeuePos = 0;
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<int32> NumDropped{ 0 };
+};
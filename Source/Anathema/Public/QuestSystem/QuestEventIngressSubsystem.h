@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "QuestSystem/QuestEventIngress.h"
+#include "QuestEventIngressSubsystem.generated.h"
+
+/**
+ * UQuestEventIngressSubsystem lets any thread (AI perception, physics callbacks, async traces, ...) post quest events
+ * without marshalling back to the game thread itself.
+ *
+ * Events go into a lock-free FQuestEventIngressQueue and are drained once per frame on the game thread, right before
+ * actors tick (FWorldDelegates::OnWorldPreActorTick), so everything posted during frame N is seen by quest logic at
+ * the start of frame N + 1. Events for one player go through UQuestManagerComponent::NotifyEvent (and so honour
+ * bQueueEvents); events without a player go to UQuestProgressSubsystem::ProcessEventForAllPlayers.
+ *
+ * Worker code should grab the queue on the game thread (GetQueue) and keep the shared reference: it stays valid after
+ * the world is gone, posting to it then simply has no effect.
+ */
+UCLASS(Config = Game)
+class ANATHEMA_API UQuestEventIngressSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+    using FQueueRef = TSharedRef<FQuestEventIngressQueue, ESPMode::ThreadSafe>;
+
+    // Game thread: the queue to hand to producers on other threads.
+    FQueueRef GetQueue() const { return Queue.ToSharedRef(); }
+
+    // Any thread. Returns false if the queue is full and the event was dropped.
+    bool PostEvent(const FQuestIngressEvent& Event) { return Queue->Enqueue(Event); }
+
+    // Dispatches every event posted so far. Called automatically before actors tick.
+    void DrainEvents();
+
+    // --- SETTINGS ([/Script/Anathema.QuestEventIngressSubsystem] in DefaultGame.ini) ---
+
+    // Maximum number of events waiting to be drained (rounded up to a power of two). Further events are dropped.
+    UPROPERTY(Config)
+    int32 QueueCapacity = 8192;
+
+protected:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+private:
+    void OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+    TSharedPtr<FQuestEventIngressQueue, ESPMode::ThreadSafe> Queue;
+    FDelegateHandle PreActorTickHandle;
+};
@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SharedPointer.h"
+#include <type_traits>
+#include "QuestEventPayload.generated.h"
+
+/**
+ * FQuestEventPayload carries one typed value along with an FObjectiveEventData (item count, damage type, location, ...).
+ *
+ * Payload types are plain USTRUCTs; their UScriptStruct is only used as a type tag (a pointer compare in Get), never
+ * for reflection. Small, trivially copyable types (up to InlineSize bytes, the common case) are stored inline, so
+ * setting, copying and reading a payload never allocates. Anything larger or non-trivial is stored once on the heap
+ * and shared (immutably) between copies of the event.
+ *
+ *     E.Payload.Set(FQuestItemPayload{ ItemId, 3 });
+ *     if (const FQuestItemPayload* Item = E.Payload.Get<FQuestItemPayload>()) { ... }
+ */
+struct ANATHEMA_API FQuestEventPayload
+{
+    static constexpr int32 InlineSize = 32;
+    static constexpr int32 InlineAlignment = 16;
+
+    FQuestEventPayload()
+    {
+        FMemory::Memzero(InlineData);
+    }
+
+    template <typename T>
+    explicit FQuestEventPayload(const T& Value)
+        : FQuestEventPayload()
+    {
+        Set(Value);
+    }
+
+    template <typename T>
+    void Set(const T& Value)
+    {
+        Reset();
+        Type = T::StaticStruct();
+        if constexpr (IsStoredInline<T>())
+        {
+            // The rest of the buffer stays zeroed, so equal values normally have equal bytes (see operator==).
+            FMemory::Memcpy(InlineData, &Value, sizeof(T));
+        }
+        else
+        {
+            HeapData = MakeShared<T, ESPMode::ThreadSafe>(Value);
+        }
+    }
+
+    // Returns the payload if it is a T, nullptr otherwise.
+    template <typename T>
+    const T* Get() const
+    {
+        if (Type != T::StaticStruct())
+        {
+            return nullptr;
+        }
+        if constexpr (IsStoredInline<T>())
+        {
+            // SetStruct may have put an inline-able type on the heap (see there).
+            return HeapData ? static_cast<const T*>(HeapData.Get()) : reinterpret_cast<const T*>(InlineData);
+        }
+        else
+        {
+            return static_cast<const T*>(HeapData.Get());
+        }
+    }
+
+    // Sets a payload whose type is only known at runtime (e.g. when reading a capture file); Data is copied.
+    // Only plain-old-data types are stored inline, everything else goes on the heap.
+    void SetStruct(const UScriptStruct* InType, const void* Data);
+
+    // The payload value, to be interpreted as GetType(), or nullptr if no payload is set.
+    const void* GetData() const { return !Type ? nullptr : HeapData ? HeapData.Get() : InlineData; }
+
+    bool IsSet() const { return Type != nullptr; }
+    const UScriptStruct* GetType() const { return Type; }
+
+    void Reset()
+    {
+        Type = nullptr;
+        HeapData.Reset();
+        FMemory::Memzero(InlineData);
+    }
+
+    // Inline payloads compare by value (byte-wise), heap payloads by identity. This can only miss equal values,
+    // never report different values as equal, which is what event coalescing needs.
+    bool operator==(const FQuestEventPayload& Other) const
+    {
+        return Type == Other.Type && HeapData == Other.HeapData && FMemory::Memcmp(InlineData, Other.InlineData, InlineSize) == 0;
+    }
+
+    friend uint32 GetTypeHash(const FQuestEventPayload& Payload)
+    {
+        if (!Payload.Type)
+        {
+            return 0;
+        }
+        const uint32 TypeHash = HashCombine(PointerHash(Payload.Type), PointerHash(Payload.HeapData.Get()));
+        return HashCombine(TypeHash, FCrc::MemCrc32(Payload.InlineData, InlineSize));
+    }
+
+private:
+    template <typename T>
+    static constexpr bool IsStoredInline()
+    {
+        return sizeof(T) <= InlineSize && alignof(T) <= InlineAlignment
+            && std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>;
+    }
+
+    const UScriptStruct* Type = nullptr;
+    alignas(InlineAlignment) uint8 InlineData[InlineSize];
+    TSharedPtr<const void, ESPMode::ThreadSafe> HeapData;
+};
+
+// --- COMMON PAYLOADS ---
+
+// An item changed hands (collected, delivered, crafted, ...).
+USTRUCT(BlueprintType)
+struct FQuestItemPayload
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest Event Payload")
+    FName ItemId;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest Event Payload")
+    int32 Quantity = 1;
+};
+
+// Damage was dealt (to or by the player, depending on the event tag).
+USTRUCT(BlueprintType)
+struct FQuestDamagePayload
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest Event Payload")
+    FName DamageType;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest Event Payload")
+    float Amount = 0.0f;
+};
+
+// Something happened at a place.
+USTRUCT(BlueprintType)
+struct FQuestLocationPayload
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest Event Payload")
+    FVector Location = FVector::ZeroVector;
+};
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "QuestSystem/QuestEventCapture.h"
+#include "QuestEventRecorderSubsystem.generated.h"
+
+class UQuestManagerComponent;
+class UQuestNode;
+struct FObjectiveEventData;
+
+/**
+ * UQuestEventRecorderSubsystem records every quest event that enters the quest system into a capture file
+ * (see FQuestEventCapture), so a production session can be replayed locally with UQuestEventReplayCommandlet.
+ *
+ * Recorded are: events passed to UQuestManagerComponent::NotifyEvent/QueueEvent, events passed to
+ * UQuestProgressSubsystem::ProcessEventForPlayers/ProcessEventForAllPlayers, and AddQuest calls. That includes the
+ * events quest subsystems generate themselves (timer checks, location entries, ingress); during a replay those
+ * subsystems stay quiet, so each of these events is dispatched once, from the capture. Each player's quest
+ * state is stored the first time the player shows up, so the replay starts from the same state.
+ *
+ * Start a capture with the "Quest.Capture.Start [Name]" console command or -QuestCapture=Name on the command line,
+ * and stop it with "Quest.Capture.Stop" (or by ending the world). Captures go to Saved/QuestCaptures/<Name>.qcap.
+ * While no capture is running, the quest manager only pays for one branch per event.
+ */
+UCLASS()
+class ANATHEMA_API UQuestEventRecorderSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+    // Starts a capture, replacing any running one. An empty name uses the current date and time.
+    bool StartRecording(const FString& CaptureName = FString());
+    void StopRecording();
+
+    bool IsRecording() const { return Writer.IsValid(); }
+
+    // --- CALLED BY THE QUEST SYSTEM WHILE RECORDING ---
+    void RecordEvent(const UQuestManagerComponent* QuestManager, const FObjectiveEventData& E, bool bQueued);
+    void RecordGroupEvent(TConstArrayView<UQuestManagerComponent*> QuestManagers, const FObjectiveEventData& E);
+    void RecordWorldEvent(const FObjectiveEventData& E);
+    void RecordQuestAdded(const UQuestManagerComponent* QuestManager, const UQuestNode* Quest);
+
+    // --- REPLAY ---
+
+    // Set by FQuestEventReplayer while it feeds a capture into this world. The capture already holds the events the
+    // timer, location and ingress subsystems generated while recording, so those subsystems don't dispatch their own
+    // (timers keep running for expirations, which aren't events).
+    void SetReplayingCapture(bool bReplaying) { bReplayingCapture = bReplaying; }
+
+    // Whether a capture is being replayed into World.
+    static bool IsReplayingCapture(const UWorld* World);
+
+protected:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+
+private:
+    // Fills in what every record has: time, frame and event fields.
+    FQuestCapturedEvent MakeRecord(EQuestCapturedEventKind Kind, const FObjectiveEventData* E);
+    int32 GetPlayerIndex(const UQuestManagerComponent* QuestManager);
+
+    TUniquePtr<FQuestEventCaptureWriter> Writer;
+    FString CapturePath;
+    double StartTime = 0.0;
+    FDateTime StartUtc;
+    uint64 StartFrame = 0;
+    bool bReplayingCapture = false;
+};
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "QuestEventReplayCommandlet.generated.h"
+
+/**
+ * Replays a quest event capture (see UQuestEventRecorderSubsystem) in a fresh, empty game world and reports how
+ * long the quest system took per captured frame, worst frames first.
+ *
+ *   UnrealEditor-Cmd Anathema.uproject -run=QuestEventReplay -Capture=<path.qcap> [-Paced] [-StandIns] [-WorstFrames=N]
+ *
+ * By default frames are replayed back to back, as fast as possible; -Paced waits for each frame's original time.
+ * -StandIns spawns an actor of each recorded triggering actor's class (see FQuestEventReplayer).
+ */
+UCLASS()
+class ANATHEMA_API UQuestEventReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UQuestEventReplayCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
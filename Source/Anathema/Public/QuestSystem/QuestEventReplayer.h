@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QuestSystem/QuestEventCapture.h"
+
+class UWorld;
+class AActor;
+class UQuestManagerComponent;
+
+/**
+ * Feeds a capture (see FQuestEventCapture) into a world, one recorded frame at a time.
+ *
+ * Each captured player gets a PlayerState with a UQuestManagerComponent, created at the player's first record and
+ * restored to the quest state stored in the capture, with its time limits rebased from the capture start onto the
+ * replayer's creation. Triggering actors and responsible player controllers are replayed as nullptr unless
+ * bSpawnActorStandIns is set, in which case an actor of the recorded class is spawned the first time one is needed
+ * (useful when objectives look at the actor's class; beware of classes with gameplay side effects). A stand-in
+ * controller isn't linked to the replayed player's PlayerState, so objectives that follow it there won't reproduce,
+ * and neither will any objective reading the controller of a version 1 capture, which didn't record it.
+ *
+ * The caller decides the pacing: call ReplayNextFrame as fast as possible, or wait until GetNextFrameTime() has
+ * passed since the start to reproduce the original timing. The world should be ticked between frames so queued
+ * events and timers are processed as they were; events the quest subsystems generated come from the capture.
+ */
+class ANATHEMA_API FQuestEventReplayer
+{
+public:
+    // Time spent replaying the records of one captured frame.
+    struct FFrameResult
+    {
+        uint64 Frame = 0;
+        double Time = 0.0;
+        int32 NumRecords = 0;
+        uint64 Cycles = 0;
+    };
+
+    // Puts the world's quest subsystems in replay mode (see UQuestEventRecorderSubsystem::SetReplayingCapture)
+    // for the lifetime of the replayer.
+    FQuestEventReplayer(UWorld* InWorld, const FQuestEventCapture& InCapture, bool bInSpawnActorStandIns = false);
+    ~FQuestEventReplayer();
+
+    bool HasMoreFrames() const { return NextRecord < Capture.Events.Num(); }
+
+    // Recorded time (seconds since the capture started) of the next frame.
+    double GetNextFrameTime() const { return HasMoreFrames() ? Capture.Events[NextRecord].Time : 0.0; }
+
+    // Replays every record of the next captured frame and returns how long that took.
+    FFrameResult ReplayNextFrame();
+
+    const TArray<FFrameResult>& GetFrameResults() const { return FrameResults; }
+
+private:
+    void ReplayRecord(const FQuestCapturedEvent& Record);
+    UQuestManagerComponent* GetQuestManager(int32 PlayerIndex);
+    AActor* GetActor(int32 ActorIndex);
+
+    UWorld* World;
+    const FQuestEventCapture& Capture;
+    bool bSpawnActorStandIns;
+
+    TArray<TWeakObjectPtr<UQuestManagerComponent>> QuestManagers;
+    TArray<TWeakObjectPtr<AActor>> Actors;
+    TBitArray<> ActorsResolved;
+
+    int32 NextRecord = 0;
+    TArray<FFrameResult> FrameResults;
+
+    // UTC ticks the capture's relative deadlines are rebased onto.
+    int64 StartUtcTicks = 0;
+};
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * FQuestEventTags gives event tags a hierarchy: "Event.Kill.Goblin.Archer" is a child of "Event.Kill.Goblin",
+ * "Event.Kill" and "Event", and an objective subscribed to "Event.Kill" receives it.
+ *
+ * Every tag seen is registered once (along with its ancestors, which always get lower indices) and gets:
+ *   - SelfAndAncestors: its own index followed by its parents' up to the root, walked by the dispatch code;
+ *   - AncestorMask: a bitset with the bits of the tag and all its ancestors set, so "does E match subscription S"
+ *     is a single bit test and "does E match any of these subscriptions" is a bitwise AND of two masks.
+ * The name is only split into its parts on registration, never during dispatch.
+ *
+ * Tags are registered on the game thread; lookups are safe from any thread as long as no registration is running
+ * (event processing on worker threads happens inside game thread calls, which don't register tags).
+ */
+class ANATHEMA_API FQuestEventTags
+{
+public:
+    static FQuestEventTags& Get();
+
+    // Registers Tag and its ancestors if needed and returns its index. Game thread only.
+    int32 RegisterTag(FName Tag);
+
+    // Returns the index of Tag, or INDEX_NONE if it was never registered.
+    int32 FindTag(FName Tag) const;
+
+    FName GetTagName(int32 TagIndex) const { return Tags[TagIndex].Name; }
+
+    // TagIndex itself first, then its parent, grandparent, ... up to the root.
+    TConstArrayView<int32> GetSelfAndAncestors(int32 TagIndex) const { return Tags[TagIndex].SelfAndAncestors; }
+
+    // Bits of TagIndex and all its ancestors.
+    const TBitArray<>& GetAncestorMask(int32 TagIndex) const { return Tags[TagIndex].AncestorMask; }
+
+    // Whether an event tagged EventTag is received by a subscription to SubscribedTag (equal or descendant).
+    bool Matches(int32 EventTagIndex, int32 SubscribedTagIndex) const;
+
+    // Whether two tag masks share a bit. Masks may have different lengths; missing bits count as unset.
+    static bool MasksIntersect(const TBitArray<>& A, const TBitArray<>& B);
+
+    // Sets the bit of TagIndex in Mask, growing it if needed.
+    static void AddToMask(TBitArray<>& Mask, int32 TagIndex);
+
+    // Registers Tags and returns only the ones not covered by another (ancestor) tag of the list, so each event
+    // reaches a subscriber through exactly one of its tags.
+    void GetEffectiveSubscriptions(TConstArrayView<FName> SubscribedTags, TArray<int32, TInlineAllocator<4>>& OutTagIndices);
+
+    int32 Num() const { return Tags.Num(); }
+
+private:
+    struct FTag
+    {
+        FName Name;
+        TArray<int32, TInlineAllocator<4>> SelfAndAncestors;
+        TBitArray<> AncestorMask;
+    };
+
+    TArray<FTag> Tags;
+    TMap<FName, int32> TagIndices;
+};
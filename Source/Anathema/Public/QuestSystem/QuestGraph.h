@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+#include "QuestGraph.generated.h"
+
+class UQuestNode;
+
+/**
+ * FQuestGraph is the compiled form of the quest graph described by UQuestNode::PrerequisiteQuests.
+ *
+ * Every quest gets a dense integer ID (also stored in UQuestNode::QuestId). Quests are numbered in
+ * topological order, so a quest's prerequisites always have smaller IDs than the quest itself.
+ * Prerequisite and follow-up lists are stored CSR-style: one flat array of IDs per direction, plus an offset
+ * array indexed by quest ID, so walking a quest's edges touches a single contiguous range.
+ *
+ * Quests can be added in several batches (e.g., when new content is loaded). IDs are append-only, so
+ * IDs handed out earlier stay valid; each batch is topologically ordered on its own, and its edge rows are
+ * appended after the existing ones. Only the most recently added quests can be removed again (RemoveQuestsFrom).
+ */
+USTRUCT()
+struct ANATHEMA_API FQuestGraph
+{
+    GENERATED_BODY()
+
+    // Adds the given quests, and every quest reachable from them through prerequisites or follow-ups,
+    // to the graph. Quests that are already part of the graph are ignored.
+    void AddQuests(TConstArrayView<UQuestNode*> RootQuests);
+
+    // Removes the quests with IDs FirstQuestId and up, and hands their IDs back (UQuestNode::QuestId).
+    void RemoveQuestsFrom(int32 FirstQuestId);
+
+    // Number of compiled quests. Valid IDs are [0, Num()).
+    int32 Num() const { return Quests.Num(); }
+
+    UQuestNode* GetQuest(int32 QuestId) const { return Quests[QuestId]; }
+
+    // Object path of a quest, cached at compile time. Used as the stable key for saved quest state.
+    const FSoftObjectPath& GetQuestPath(int32 QuestId) const { return QuestPaths[QuestId]; }
+
+    // Prerequisite/follow-up quest IDs of a quest.
+    TConstArrayView<int32> GetPrerequisites(int32 QuestId) const
+    {
+        return TConstArrayView<int32>(Prerequisites.GetData() + PrerequisiteOffsets[QuestId], PrerequisiteOffsets[QuestId + 1] - PrerequisiteOffsets[QuestId]);
+    }
+    TConstArrayView<int32> GetFollowUps(int32 QuestId) const
+    {
+        return TConstArrayView<int32>(FollowUps.GetData() + FollowUpOffsets[QuestId], FollowUpOffsets[QuestId + 1] - FollowUpOffsets[QuestId]);
+    }
+
+private:
+    // Appends the edge rows of the quests with IDs FirstQuestId and up, which were just added.
+    void AppendEdges(int32 FirstQuestId);
+
+    // Rebuilds the follow-up rows of the quests with IDs FirstQuestId and up from their prerequisite rows, keeping
+    // the rows before them. Only valid if none of these quests has a prerequisite with a smaller ID.
+    void BuildFollowUps(int32 FirstQuestId);
+
+    // Compiled quests, indexed by quest ID. Also keeps the definitions alive.
+    UPROPERTY()
+    TArray<TObjectPtr<UQuestNode>> Quests;
+
+    // Object path of each quest, indexed by quest ID.
+    TArray<FSoftObjectPath> QuestPaths;
+
+    // Prerequisites of quest I are Prerequisites[PrerequisiteOffsets[I] .. PrerequisiteOffsets[I + 1]).
+    TArray<int32> PrerequisiteOffsets;
+    TArray<int32> Prerequisites;
+
+    // Follow-ups of quest I are FollowUps[FollowUpOffsets[I] .. FollowUpOffsets[I + 1]).
+    TArray<int32> FollowUpOffsets;
+    TArray<int32> FollowUps;
+};
@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "UObject/SoftObjectPath.h"
+#include "QuestSystem/QuestSaveData.h"
+#include <atomic>
+
+class FRunnableThread;
+class FEvent;
+class IFileHandle;
+
+// Kind of quest state mutation recorded in the journal.
+enum class EQuestJournalOp : uint8
+{
+    QuestAdded = 1,        // Quest became active with all counters at 0.
+    ObjectiveProgress = 2, // ObjectiveIndex's counter was set to Value.
+    QuestRemoved = 3,      // Quest stopped being active (abandoned, or about to be completed).
+    QuestCompleted = 4,    // Quest was completed at unix time Value.
+    PlayerSnapshot = 5,    // The player's whole state was replaced by the FQuestSaveSnapshot encoded in Data.
+    ObjectiveDeadline = 6, // ObjectiveIndex's time limit runs out at UTC FDateTime ticks Value.
+};
+
+// One quest state mutation of one player.
+struct FQuestJournalRecord
+{
+    EQuestJournalOp Op = EQuestJournalOp::QuestAdded;
+    FString PlayerId;
+    FSoftObjectPath Quest;
+    int32 ObjectiveIndex = 0;
+    int64 Value = 0;
+    TArray<uint8> Data; // PlayerSnapshot only.
+};
+
+/**
+ * FQuestJournal is a write-ahead log of quest state mutations for one shard (server process).
+ *
+ * Append() encodes a record into an in-memory batch and returns immediately. A dedicated writer thread wakes up
+ * every commit interval, writes the whole batch with a single write and fsyncs it (group commit), so a burst of
+ * mutations costs one disk flush. At most one commit interval of progress is lost on a crash.
+ *
+ * The log is split into generations: <Shard>.<Generation>.journal. Compact() starts a new generation and writes a
+ * snapshot file for each player given (<Shard>.players/<hash of PlayerId>.snapshot, tagged with the new generation),
+ * then <Shard>.snapshot, which records that generation, after which older journals are deleted. Only players whose
+ * state changed since the last compaction need to be given; the files of everyone else are still current.
+ * Recover() replays the journals from the last compacted generation onward, on top of the snapshot files of the
+ * players they mention; other players are read with LoadPlayer() when needed. (Shards written before player files
+ * existed keep every player in <Shard>.snapshot; Recover() loads those too, and the next compaction moves them out.)
+ *
+ * Journal record layout: uint32 PayloadSize, uint32 PayloadCrc, payload. Replay stops at the first torn or
+ * corrupt record, which can only be the tail of the last write before a crash.
+ */
+class ANATHEMA_API FQuestJournal : public FRunnable
+{
+public:
+    // Starts the writer thread. Records go to generation FirstGeneration.
+    FQuestJournal(const FString& InDirectory, const FString& InShardName, int32 FirstGeneration, float CommitIntervalSeconds);
+
+    // Commits everything still pending and stops the writer thread.
+    virtual ~FQuestJournal();
+
+    // Queues a record for the next group commit. Thread-safe; never waits for IO.
+    void Append(const FQuestJournalRecord& Record);
+
+    // Starts a new generation whose base is the given per-player snapshots plus the snapshot files of everyone else.
+    // Records appended after this call belong to the new generation. The snapshots are encoded and written on the
+    // writer thread, which only reads them. Returns the new generation (see GetWrittenSnapshotGeneration).
+    int32 Compact(const TSharedRef<const TMap<FString, FQuestSaveSnapshot>>& Snapshots);
+
+    // The last generation whose player snapshot files are all written. Until then, the files of the players given to
+    // Compact may be out of date.
+    int32 GetWrittenSnapshotGeneration() const { return WrittenSnapshotGeneration.load(std::memory_order_acquire); }
+
+    // Journal bytes appended since the last compaction.
+    int64 GetBytesSinceCompaction() const { return BytesSinceCompaction.load(std::memory_order_relaxed); }
+
+    // Rebuilds the quest state of every player with journal records since their last snapshot file.
+    // Returns the generation a new FQuestJournal should start with.
+    static int32 Recover(const FString& Directory, const FString& ShardName, TMap<FString, FQuestSaveSnapshot>& OutPlayers);
+
+    // Reads a player's snapshot file. Returns false if the player has none (or it is corrupt). Not safe while a
+    // compaction that includes the player is being written.
+    static bool LoadPlayer(const FString& Directory, const FString& ShardName, const FString& PlayerId, FQuestSaveSnapshot& OutSnapshot, int32& OutGeneration);
+
+    // Applies one record to a player's quest state.
+    static void ApplyRecord(const FQuestJournalRecord& Record, FQuestSaveSnapshot& Snapshot);
+
+    // --- FRunnable ---
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    // A batch of encoded records for one generation, or a compaction marker.
+    struct FPendingItem
+    {
+        int32 Generation = 0;
+        TArray<uint8> Records;
+        TSharedPtr<const TMap<FString, FQuestSaveSnapshot>> Snapshots;
+    };
+
+    // Writer thread: writes everything queued so far and fsyncs.
+    void CommitPending();
+
+    // Writer thread: makes sure the journal file of Generation is open for appending.
+    bool OpenJournal(int32 Generation);
+
+    // Writer thread: writes the given players' snapshot files and the shard snapshot for Generation, and deletes
+    // older journals.
+    void WriteSnapshot(int32 Generation, const TMap<FString, FQuestSaveSnapshot>& Snapshots);
+
+    FString GetJournalPath(int32 Generation) const;
+    FString GetSnapshotPath() const;
+    static FString GetPlayerPath(const FString& Directory, const FString& ShardName, const FString& PlayerId);
+
+    const FString Directory;
+    const FString ShardName;
+    const uint32 CommitIntervalMs;
+
+    // Producer side, guarded by PendingLock. Only the swap of the batch is locked, never IO.
+    FCriticalSection PendingLock;
+    TArray<FPendingItem> PendingItems;
+    int32 CurrentGeneration;
+
+    std::atomic<int64> BytesSinceCompaction{ 0 };
+    std::atomic<int32> WrittenSnapshotGeneration{ INDEX_NONE };
+    std::atomic<bool> bStopRequested{ false };
+
+    // Writer side.
+    FEvent* WakeEvent = nullptr;
+    FRunnableThread* Thread = nullptr;
+    IFileHandle* JournalFile = nullptr;
+    int32 JournalFileGeneration = INDEX_NONE;
+};
@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "QuestSystem/QuestJournal.h"
+#include "QuestJournalSubsystem.generated.h"
+
+class UQuestManagerComponent;
+
+/**
+ * UQuestJournalSubsystem makes quest progress crash-safe on the server.
+ *
+ * Journaling is opt-in per process: it only runs with -QuestShard=<Name> on the command line, and only in dedicated
+ * or listen server worlds. Other game worlds (standalone play, benchmark fixtures, capture replays, load tests) never
+ * touch a shard's files.
+ *
+ * Every quest state mutation of a UQuestManagerComponent (quest added, objective progress, quest removed or completed)
+ * is appended to this shard's FQuestJournal. When the world starts, the shard's snapshot and journals are replayed,
+ * and each player gets their recovered state back when their quest manager registers.
+ * Once the journal grows past CompactionThresholdKB, the players whose state changed since the last compaction get
+ * their snapshot files rewritten and old journals are dropped. Players that are offline are only kept in memory
+ * until then; afterwards their state is read back from their snapshot file when they return.
+ *
+ * Settings live in DefaultGame.ini under [/Script/Anathema.QuestJournalSubsystem].
+ */
+UCLASS(Config = Game)
+class ANATHEMA_API UQuestJournalSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+    // Called by UQuestManagerComponent on the server once it knows its PersistenceId.
+    // Restores the player's recovered state, if there is any, and starts journaling its mutations.
+    void RegisterPlayer(UQuestManagerComponent* QuestManager);
+
+    // Keeps the player's final state for the next snapshot and stops journaling its mutations.
+    void UnregisterPlayer(UQuestManagerComponent* QuestManager);
+
+    // Appends a mutation to the journal. Cheap; the write happens on the journal's writer thread.
+    void Append(const FQuestJournalRecord& Record);
+
+    // Journals the player's whole current state as a single record. Used when the state was replaced wholesale
+    // (e.g., a save was loaded), so only this player is rewritten instead of compacting everyone.
+    void AppendPlayerSnapshot(const UQuestManagerComponent* QuestManager);
+
+    // Writes a snapshot of every player whose state changed now, and starts a fresh journal.
+    UFUNCTION(BlueprintCallable, Category = "Quest Management|Save")
+    void Compact();
+
+    // --- SETTINGS ---
+
+    // Turns journaling off even where -QuestShard= asks for it.
+    UPROPERTY(Config)
+    bool bEnableJournal = true;
+
+    // How often pending records are written and fsynced, in seconds. Bounds the progress lost on a crash.
+    UPROPERTY(Config)
+    float CommitInterval = 0.05f;
+
+    // Journal size that triggers a compaction.
+    UPROPERTY(Config)
+    int32 CompactionThresholdKB = 4096;
+
+protected:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+private:
+    // Name of this server's journal, from -QuestShard=. Servers sharing a Saved directory need distinct names.
+    FString ShardName;
+
+    TUniquePtr<FQuestJournal> Journal;
+
+    // Quest managers that are journaling, by PersistenceId.
+    TMap<FString, TWeakObjectPtr<UQuestManagerComponent>> OnlinePlayers;
+
+    // State of players that aren't online and aren't in a snapshot file yet: recovered from the journals, or
+    // captured when they left. Handed to the next compaction, which moves them to UnwrittenSnapshots.
+    TMap<FString, FQuestSaveSnapshot> OfflinePlayers;
+
+    // States given to a compaction whose snapshot files aren't written yet, oldest first. Players are read from
+    // here rather than from their files meanwhile, and a compaction that failed is carried over into the next one.
+    struct FUnwrittenSnapshots
+    {
+        int32 Generation = 0;
+        TSharedPtr<const TMap<FString, FQuestSaveSnapshot>> Players;
+    };
+    TArray<FUnwrittenSnapshots> UnwrittenSnapshots;
+
+    // Where the shard's files live.
+    FString Directory;
+
+    // Finds the last saved state of a player that isn't online: in memory if it hasn't been written out yet,
+    // otherwise in their snapshot file. Returns false for a player the shard has never seen.
+    bool FindOfflinePlayer(const FString& PlayerId, FQuestSaveSnapshot& OutSnapshot);
+};
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Math/RandomStream.h"
+#include "QuestLoadTestBotComponent.generated.h"
+
+class AQuestLoadTestGameMode;
+class UQuestManagerComponent;
+class UQuestNode;
+
+/**
+ * Scripted player for AQuestLoadTestGameMode. Keeps QuestsPerPlayer quests active on its owner's quest manager
+ * (re-taking completed quests, like repeatable content) and emits the game mode's EventMix at the configured rates,
+ * with randomized phases so bots don't all fire on the same frame.
+ */
+UCLASS()
+class ANATHEMA_API UQuestLoadTestBotComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UQuestLoadTestBotComponent();
+
+    // Seed of this bot's random stream, so runs are reproducible.
+    int32 Seed = 0;
+
+protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+    // Completion is reported from inside event dispatch, so replacement quests are added on the next tick.
+    void OnQuestCompleted(UQuestNode* CompletedQuest);
+
+    // Adds random quests from the pool until QuestsPerPlayer are active.
+    void TopUpQuests();
+
+    UPROPERTY(Transient)
+    AQuestLoadTestGameMode* GameMode = nullptr;
+
+    UPROPERTY(Transient)
+    UQuestManagerComponent* QuestManager = nullptr;
+
+    FRandomStream Random;
+    TArray<double> EventAccumulators;
+    bool bNeedsQuests = true;
+    FDelegateHandle QuestCompletedHandle;
+};
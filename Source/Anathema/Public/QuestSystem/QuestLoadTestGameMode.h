@@ -0,0 +1,159 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameModeBase.h"
+#include "QuestLoadTestGameMode.generated.h"
+
+class APlayerState;
+class UQuestNode;
+
+// One kind of event simulated players emit, e.g. kills. Each event uses one of NumVariants sub-tags
+// ("LoadTest.Kill.3"), so objectives can subscribe to the parent tag or to a specific variant.
+USTRUCT()
+struct FQuestLoadTestEvent
+{
+    GENERATED_BODY()
+
+    UPROPERTY(Config)
+    FName EventTag;
+
+    UPROPERTY(Config)
+    int32 NumVariants = 1;
+
+    // Average events per second per simulated player.
+    UPROPERTY(Config)
+    float EventsPerSecond = 1.0f;
+};
+
+/**
+ * Load-test game mode for the quest system, meant for the dedicated server target:
+ *
+ *   AnathemaServer <Map>?game=/Script/Anathema.QuestLoadTestGameMode -log [-QuestLoadTestPlayers=10,100,500]
+ *
+ * It spawns simulated players (a PlayerState with a UQuestManagerComponent and a UQuestLoadTestBotComponent, no
+ * connection or pawn) in stages of PlayerCounts players. Bots take quests from a synthetic quest pool and emit
+ * EventMix at its rates; the game mode also sends world-wide events. After WarmupSeconds, each stage is measured
+ * for MeasureSeconds: frame time, world tick time, game-thread CPU time spent in quest code, and memory (quest state and
+ * process). Results are logged and written to Saved/LoadTest/QuestLoadTest-<time>.csv.
+ */
+UCLASS(Config = Game)
+class ANATHEMA_API AQuestLoadTestGameMode : public AGameModeBase
+{
+	GENERATED_BODY()
+
+public:
+	AQuestLoadTestGameMode();
+
+    // --- SETTINGS ([/Script/Anathema.QuestLoadTestGameMode] in DefaultGame.ini) ---
+
+    // Number of simulated players in each stage, in increasing order.
+    UPROPERTY(Config)
+    TArray<int32> PlayerCounts;
+
+    // Seconds to run each stage before measuring, so spawn costs and first-quest setup don't count.
+    UPROPERTY(Config)
+    float WarmupSeconds = 5.0f;
+
+    // Seconds each stage is measured for.
+    UPROPERTY(Config)
+    float MeasureSeconds = 30.0f;
+
+    // Size of the synthetic quest pool.
+    UPROPERTY(Config)
+    int32 NumQuests = 200;
+
+    // Objectives per synthetic quest.
+    UPROPERTY(Config)
+    int32 ObjectivesPerQuest = 3;
+
+    // Quests each simulated player keeps active.
+    UPROPERTY(Config)
+    int32 QuestsPerPlayer = 20;
+
+    // What simulated players do.
+    UPROPERTY(Config)
+    TArray<FQuestLoadTestEvent> EventMix;
+
+    // World-wide events (e.g. a world boss dying) sent to every player through UQuestProgressSubsystem.
+    UPROPERTY(Config)
+    FName WorldEventTag = TEXT("LoadTest.WorldBoss");
+
+    UPROPERTY(Config)
+    float WorldEventsPerSecond = 0.05f;
+
+    // Exits the server after the last stage.
+    UPROPERTY(Config)
+    bool bQuitWhenDone = true;
+
+    // --- USED BY THE BOTS ---
+
+    const TArray<UQuestNode*>& GetQuestPool() const { return QuestPool; }
+
+    // Tag of variant Variant of EventMix[MixIndex].
+    FName GetEventTag(int32 MixIndex, int32 Variant) const { return EventTags[MixIndex][Variant]; }
+
+protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual void Tick(float DeltaSeconds) override;
+
+private:
+    // Time the world spends ticking actors (game thread work, without the server's idle wait between frames).
+    void OnWorldTickStart(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+    void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+    FDelegateHandle WorldTickStartHandle;
+    FDelegateHandle PostActorTickHandle;
+    uint64 WorldTickStartCycles = 0;
+
+    struct FStageResult
+    {
+        int32 NumPlayers = 0;
+        int32 NumFrames = 0;
+        float FrameMsAvg = 0.0f;
+        float FrameMsP99 = 0.0f;
+        float WorldTickMsAvg = 0.0f;
+        float WorldTickMsP99 = 0.0f;
+        float QuestMsPerFrame = 0.0f;
+        int32 NumActiveQuests = 0;
+        uint64 QuestBytes = 0;
+        uint64 UsedPhysicalBytes = 0;
+    };
+
+    // Creates the synthetic quest pool: objectives subscribe to EventMix tags (parent or variant) and WorldEventTag.
+    void BuildQuestPool();
+
+    // Spawns simulated players until there are NumPlayers.
+    void SpawnBots(int32 NumPlayers);
+
+    // Starts the next stage, or writes the results if there is none.
+    void StartStage(int32 StageIndex);
+    void FinishStage();
+    void WriteResults() const;
+
+    UPROPERTY(Transient)
+    TArray<UQuestNode*> QuestPool;
+
+    // ID of the first pool quest in the quest graph; the pool is the last batch compiled at BuildQuestPool.
+    int32 FirstPoolQuestId = INDEX_NONE;
+
+    UPROPERTY(Transient)
+    TArray<APlayerState*> Bots;
+
+    TArray<TArray<FName>> EventTags;
+
+    int32 CurrentStage = INDEX_NONE;
+    double StageStartTime = 0.0;
+    bool bMeasuring = false;
+    double WorldEventAccumulator = 0.0;
+
+    // Samples of the stage being measured.
+    TArray<float> FrameMs;
+    TArray<float> WorldTickMs;
+    // Quest CPU time at the start of the measurement (see QuestStats::GetGameThreadCycles): bot and world event
+    // calls, quest manager ticks and quest subsystem ticks.
+    uint64 QuestCyclesAtStart = 0;
+
+    TArray<FStageResult> Results;
+};
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "QuestLocationSubsystem.generated.h"
+
+class ULocationObjective;
+class UQuestManagerComponent;
+class APlayerController;
+
+/**
+ * UQuestLocationSubsystem detects players entering the regions of active ULocationObjectives.
+ *
+ * Regions are stored in a hashed uniform grid on the XY plane: each region is listed in every cell it overlaps.
+ * Every CheckInterval seconds, each player with at least one active location objective is tested against the
+ * regions of the one cell they stand in, so the cost per player doesn't depend on how many regions the world has.
+ * An event (EventTag = the region's RegionTag) is only sent when a player goes from outside to inside a region.
+ *
+ * Regions are reference-counted by the players that have the objective active, so only regions somebody is
+ * currently working towards are in the grid.
+ */
+UCLASS(Config = Game)
+class ANATHEMA_API UQuestLocationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+    // Called by ULocationObjective when it becomes active/inactive for a player (the quest manager's owner).
+    void AddRegionInterest(const ULocationObjective* Objective, AActor* Player);
+    void RemoveRegionInterest(const ULocationObjective* Objective, AActor* Player);
+
+    // Tests a player at Location right away (e.g., after a teleport) instead of waiting for the next check.
+    void TestPlayerLocation(AActor* Player, const FVector& Location);
+
+    // Number of regions currently in the grid.
+    int32 GetNumRegions() const { return RegionIndices.Num(); }
+
+    // --- SETTINGS ([/Script/Anathema.QuestLocationSubsystem] in DefaultGame.ini) ---
+
+    // Edge length of a grid cell. Should be larger than typical region radii.
+    UPROPERTY(Config)
+    float CellSize = 5000.0f;
+
+    // How often tracked players are tested, in seconds. 0 tests every frame.
+    UPROPERTY(Config)
+    float CheckInterval = 0.25f;
+
+protected:
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    virtual void Deinitialize() override;
+
+private:
+    struct FRegion
+    {
+        const ULocationObjective* Objective = nullptr;
+        FVector Center = FVector::ZeroVector;
+        float RadiusSquared = 0.0f;
+        FName Tag;
+        FIntPoint MinCell = FIntPoint::ZeroValue;
+        FIntPoint MaxCell = FIntPoint::ZeroValue;
+        int32 RefCount = 0;
+    };
+
+    struct FTrackedPlayer
+    {
+        TWeakObjectPtr<AActor> Owner;
+        TWeakObjectPtr<UQuestManagerComponent> QuestManager;
+        int32 InterestCount = 0;
+        // Regions the player was inside at the last test.
+        TArray<int32, TInlineAllocator<4>> InsideRegions;
+    };
+
+    // An entered region, reported after all players have been tested.
+    struct FRegionEntry
+    {
+        TWeakObjectPtr<UQuestManagerComponent> QuestManager;
+        FName Tag;
+        TWeakObjectPtr<APlayerController> PlayerController;
+        TWeakObjectPtr<AActor> Pawn;
+    };
+
+    FIntPoint GetCell(const FVector& Location) const;
+
+    // Tests one player and records the regions they entered.
+    void TestPlayer(FTrackedPlayer& Player, const FVector& Location, APlayerController* PlayerController, AActor* Pawn, TArray<FRegionEntry>& OutEntries);
+
+    // Sends one event per entered region to the players' quest managers.
+    void SendEntryEvents(const TArray<FRegionEntry>& Entries) const;
+
+    // Finds the pawn a quest manager owner (PlayerState, Controller or Pawn) stands for.
+    static AActor* GetPlayerPawn(const AActor* Owner, APlayerController*& OutPlayerController);
+
+    // Regions, with freed slots listed in FreeRegions.
+    TArray<FRegion> Regions;
+    TArray<int32> FreeRegions;
+    TMap<const ULocationObjective*, int32> RegionIndices;
+
+    // Region indices overlapping each occupied cell.
+    TMap<FIntPoint, TArray<int32>> Cells;
+
+    // Players with at least one active location objective.
+    TMap<TObjectKey<AActor>, FTrackedPlayer> Players;
+
+    float TimeSinceLastCheck = 0.0f;
+};
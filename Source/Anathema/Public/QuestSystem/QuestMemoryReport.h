@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UQuestNode;
+class UWorld;
+class FOutputDevice;
+
+// Memory held by one player's UQuestManagerComponent, by category. Sizes are heap bytes, not counting the component itself.
+struct FQuestPlayerMemory
+{
+    // ActiveQuests items, their replicated progress arrays and the quest -> item lookup.
+    SIZE_T ActiveQuestBytes = 0;
+    // The player's rows in UQuestProgressSubsystem's progress table.
+    SIZE_T ProgressRowBytes = 0;
+    // Completed-quest bits, completion history and prerequisite counters.
+    SIZE_T CompletionBytes = 0;
+    // Event tag -> subscribed objective index.
+    SIZE_T EventIndexBytes = 0;
+    // Queued (not yet dispatched) events.
+    SIZE_T EventQueueBytes = 0;
+    // Invocation lists of the completion/failure delegates.
+    SIZE_T DelegateBytes = 0;
+
+    SIZE_T GetTotal() const
+    {
+        return ActiveQuestBytes + ProgressRowBytes + CompletionBytes + EventIndexBytes + EventQueueBytes + DelegateBytes;
+    }
+};
+
+/**
+ * Per-quest and per-player memory breakdowns of the quest system, for setting and enforcing budgets.
+ *
+ * Budgets come from the console variables quest.MemoryBudget.QuestKB and quest.MemoryBudget.PlayerKB
+ * (0 = no budget; set them in DefaultEngine.ini under [SystemSettings]). Entries over budget are flagged in the report
+ * and logged as warnings. Run "Quest.MemReport" in a running game, or the QuestMemoryReport commandlet for the
+ * definitions alone (it fails when a quest is over budget, for use in CI).
+ */
+namespace QuestMemoryReport
+{
+    // Heap bytes of a quest definition: the quest object and its objective instances, including their names,
+    // descriptions and arrays.
+    ANATHEMA_API SIZE_T GetDefinitionSize(const UQuestNode* Quest);
+
+    // Prints one line per quest, largest first. Returns the number of quests over the quest budget.
+    ANATHEMA_API int32 ReportDefinitions(TConstArrayView<const UQuestNode*> Quests, FOutputDevice& Ar);
+
+    // Prints every registered quest (with the number of players that have it active and their state for it) and
+    // every quest manager of World. Returns the number of quests and players over budget.
+    ANATHEMA_API int32 ReportWorld(UWorld* World, FOutputDevice& Ar);
+
+    ANATHEMA_API int64 GetQuestBudgetBytes();
+    ANATHEMA_API int64 GetPlayerBudgetBytes();
+}
@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "QuestMemoryReportCommandlet.generated.h"
+
+/**
+ * Loads every quest asset and prints the memory of each definition (see QuestMemoryReport::ReportDefinitions).
+ *
+ *   UnrealEditor-Cmd Anathema.uproject -run=QuestMemoryReport [-QuestBudgetKB=N]
+ *
+ * -QuestBudgetKB overrides quest.MemoryBudget.QuestKB. Returns 1 if any quest is over budget, so it can gate a build.
+ */
+UCLASS()
+class ANATHEMA_API UQuestMemoryReportCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UQuestMemoryReportCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -7,13 +7,14 @@
 #include "QuestSystem/Objective.h"
 #include "QuestNode.generated.h"
 
-// Delegate for when ALL objectives within THIS specific quest are completed.
-// This is what the UQuestManagerComponent will typically bind to.
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnQuestCompleted, UQuestNode*, CompletedQuest);
+class UQuestManagerComponent;
 
 /**
  * UQuestNode represents a single quest or a stage within a larger quest chain.
  * It manages a set of objectives that must be completed.
+ *
+ * A quest node is a definition: one instance is shared by every player, and it must not be modified at runtime.
+ * Per-player status and objective progress are stored in FQuestRuntimeState by UQuestManagerComponent.
  */
 UCLASS()
 class ANATHEMA_API UQuestNode : public UObject
@@ -33,81 +34,69 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Quest")
     FText QuestDescription;
 
-	// --- QUEST STATUS ---
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Quest")
-    bool bIsAvailable;
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Quest")
-    bool bIsCompleted;
-
 	// --- QUEST TREE STRUCTURE ---
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Quest")
     TArray<UQuestNode*> PrerequisiteQuests;
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Quest")
     TArray<UQuestNode*> FollowUpQuests;
 
+    // Dense ID of this quest in the compiled quest graph (see UQuestDefinitionSubsystem),
+    // or INDEX_NONE until the quest has been registered. Assigned once; not saved.
+    UPROPERTY(Transient, VisibleAnywhere, BlueprintReadOnly, Category = "Quest")
+    int32 QuestId = INDEX_NONE;
+
     // --- QUEST OBJECTIVES ---
     // This array holds instances of UObjective (or its Blueprint/C++ subclasses).
-    // UPROPERTY(Instanced) is CRUCIAL here: it tells Unreal to create a unique instance
-    // of the selected objective class for EACH quest node, rather than just referencing
-    // a shared asset. This allows each objective to maintain its own state (e.g., CurrentKills).
+    // UPROPERTY(Instanced) tells Unreal to create a unique instance of the selected objective class for EACH
+    // quest node, so each quest can configure its objectives (e.g., RequiredProgress) independently.
+    // Objectives are shared by all players that have this quest; per-player progress lives in UQuestProgressSubsystem.
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Instanced, Category = "Quest")
     TArray<UObjective*> Objectives;
 
     // --- FUNCTIONS (PUBLIC API) ---
 
-    // Initializes all objectives associated with this quest.
+    // Calls InitializeObjective on all objectives of this quest for the given player.
     // This should be called by the UQuestManagerComponent when the quest becomes active for a player.
-    UFUNCTION(BlueprintCallable, Category = "Quest")
-    void InitializeQuestObjectives(AActor* OwningActor);
+    UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "Quest")
+    void InitializeQuestObjectives(AActor* OwningActor) const;
 
-    // Uninitializes all objectives, removing any bindings to global events.
+    // Calls UninitializeObjective on all objectives of this quest for the given player.
     // Call this when the quest is completed, abandoned, or the owning actor is being destroyed.
-    UFUNCTION(BlueprintCallable, Category = "Quest")
-    void UninitializeQuestObjectives();
+    UFUNCTION(BlueprintCallable, BlueprintPure = false, Category = "Quest")
+    void UninitializeQuestObjectives(AActor* OwningActor) const;
 
+    // Whether the player owning QuestManager can take this quest.
     UFUNCTION(BlueprintNativeEvent, Category = "Quest")
-    bool IsQuestAvailable() const;
+    bool IsQuestAvailable(const UQuestManagerComponent* QuestManager) const;
 
+    // Whether every objective of this quest is complete for the player owning QuestManager.
     UFUNCTION(BlueprintPure, BlueprintCallable, Category = "Quest")
-    bool IsQuestCompleted() const;
+    bool IsQuestCompleted(const UQuestManagerComponent* QuestManager) const;
 
+    // Not allowed once this quest is in a GC cluster (see CanBeClusterRoot): build quest lines before registering them.
     UFUNCTION(BlueprintCallable, Category = "Quest")
 	void AddFollowup(UQuestNode* FollowUpQuest);
 
-    // Event for when the quest is formally unlocked (e.g., shown in UI as available).
+    // Definitions live for the whole session and don't change, so a quest and its objectives can be a GC cluster:
+    // garbage collection then marks the cluster reachable as a whole instead of tracing each object.
+    // Quests loaded from cooked packages are clustered on load; see also UQuestDefinitionSubsystem::ClusterQuests.
+    virtual bool CanBeClusterRoot() const override;
+
+    // Event for when the quest is formally unlocked for a player (e.g., shown in UI as available).
     // Implementable ONLY in Blueprint.
     UFUNCTION(BlueprintImplementableEvent, Category = "Quest")
-    void OnQuestUnlocked();
+    void OnQuestUnlocked(UQuestManagerComponent* QuestManager);
 
-    // Event for when the quest has been fully completed (all objectives done).
+    // Event for when the quest has been fully completed (all objectives done) by a player.
+    // Follow-up quests are unlocked by the quest manager afterwards, using the compiled quest graph.
     // BlueprintNativeEvent allows C++ logic and Blueprint override.
     UFUNCTION(BlueprintNativeEvent, Category = "Quest")
-    void OnQuestCompleted();
-
-    // --- DELEGATES ---
-    // Event broadcast when all objectives for this quest are completed.
-    // The QuestManagerComponent should bind to this.
-    UPROPERTY(BlueprintAssignable, Category = "Quest")
-    FOnQuestCompleted OnQuestCompletedDelegate;
+    void OnQuestCompleted(UQuestManagerComponent* QuestManager);
 
 protected:
-    // --- INTERNAL HELPER FUNCTIONS ---
-
-    // Callback function for when an individual UObjective reports its completion.
-    // This function MUST be a UFUNCTION() to be bindable via AddDynamic.
-    UFUNCTION()
-    void OnObjectiveCompleted(UObjective* CompletedObjective);
-
-    // Manages binding to the OnObjectiveCompletedDelegate of all objectives in the Objectives array.
-    void BindToObjectiveCompletionEvents();
-
-    // Manages unbinding from the OnObjectiveCompletedDelegate of all objectives.
-    // Important to prevent memory leaks and unnecessary calls for inactive quests.
-    void UnbindFromObjectiveCompletionEvents();
-
     // Default C++ implementation for IsQuestAvailable (BlueprintNativeEvent).
-    virtual bool IsQuestAvailable_Implementation() const;
+    virtual bool IsQuestAvailable_Implementation(const UQuestManagerComponent* QuestManager) const;
 
     // Default C++ implementation for OnQuestCompleted (BlueprintNativeEvent).
-    virtual void OnQuestCompleted_Implementation();
-};
\ No newline at end of file
+    virtual void OnQuestCompleted_Implementation(UQuestManagerComponent* QuestManager);
+};
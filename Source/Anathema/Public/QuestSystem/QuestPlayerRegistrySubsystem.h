@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "GameFramework/OnlineReplStructs.h"
+#include "QuestSystem/Objective.h"
+#include "QuestPlayerRegistrySubsystem.generated.h"
+
+class AController;
+class AGameModeBase;
+class APlayerController;
+class APlayerState;
+class UQuestManagerComponent;
+
+/**
+ * UQuestPlayerRegistrySubsystem finds a player's UQuestManagerComponent in O(1), by the actor that owns it
+ * (normally the PlayerState), by the player's controller, or by the player's unique net ID.
+ *
+ * Quest managers register themselves in BeginPlay and unregister in EndPlay. The controller and net ID of a
+ * player are indexed at registration and again at PostLogin, when both are known for sure; a controller that
+ * isn't indexed yet (e.g., after seamless travel) is resolved through its PlayerState once and then cached.
+ *
+ * Event producers (game mode, AI death handlers, pickups) should call NotifyEventForPlayer instead of walking
+ * PlayerController -> PlayerState -> FindComponentByClass for every event.
+ */
+UCLASS()
+class ANATHEMA_API UQuestPlayerRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+    // --- REGISTRATION (called by UQuestManagerComponent) ---
+
+    void RegisterQuestManager(UQuestManagerComponent* QuestManager);
+    void UnregisterQuestManager(UQuestManagerComponent* QuestManager);
+
+    // --- LOOKUP ---
+
+    // The quest manager owned by Owner (e.g., a PlayerState), or nullptr.
+    UFUNCTION(BlueprintPure, Category = "Quest Management")
+    UQuestManagerComponent* FindByOwner(const AActor* Owner) const;
+
+    // The quest manager of the player Controller controls, or nullptr.
+    // Not pure: a controller that isn't indexed yet is cached on the way.
+    UFUNCTION(BlueprintCallable, Category = "Quest Management")
+    UQuestManagerComponent* FindByController(const AController* Controller);
+
+    UQuestManagerComponent* FindByUniqueNetId(const FUniqueNetIdRepl& UniqueNetId) const;
+
+    // Number of registered quest managers.
+    int32 Num() const { return Entries.Num(); }
+
+    // --- EVENTS ---
+
+    // Sends an event to the quest manager of E.ResponsiblePlayerController (see UQuestManagerComponent::NotifyEvent).
+    // Returns false, and drops the event, if that player has no quest manager.
+    UFUNCTION(BlueprintCallable, Category = "Quest Management|Events")
+    bool NotifyEventForPlayer(const FObjectiveEventData& E);
+
+protected:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+private:
+    // Re-indexes a player's controller and net ID once login has set them.
+    void OnPostLogin(AGameModeBase* GameMode, APlayerController* NewPlayer);
+    FDelegateHandle PostLoginHandle;
+
+    // (Re)indexes the controller and unique net ID of a registered quest manager's player.
+    void IndexPlayerIds(UQuestManagerComponent* QuestManager);
+
+    // Keys a quest manager is indexed under, so it can be removed from every map.
+    struct FEntry
+    {
+        TObjectKey<AActor> Owner;
+        TObjectKey<AController> Controller;
+        FUniqueNetIdRepl UniqueNetId;
+    };
+
+    TMap<TObjectKey<UQuestManagerComponent>, FEntry> Entries;
+    TMap<TObjectKey<AActor>, TWeakObjectPtr<UQuestManagerComponent>> ByOwner;
+    TMap<TObjectKey<AController>, TWeakObjectPtr<UQuestManagerComponent>> ByController;
+    TMap<FUniqueNetIdRepl, TWeakObjectPtr<UQuestManagerComponent>> ByUniqueNetId;
+};
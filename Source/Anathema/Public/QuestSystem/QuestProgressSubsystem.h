@@ -0,0 +1,175 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "QuestSystem/Objective.h"
+#include "QuestProgressSubsystem.generated.h"
+
+class UQuestManagerComponent;
+class UQuestNode;
+
+/**
+ * UQuestProgressSubsystem owns the objective progress of every player in the world.
+ *
+ * Progress is stored as a struct-of-arrays table with one row per (player, active quest, objective).
+ * The objectives of one quest occupy a contiguous block of rows, and freed blocks are reused by later
+ * quests with the same objective count, so repeatable content (dailies, bounties) doesn't grow the table or
+ * allocate. Row indices stay stable while a quest is active, except when the pools are trimmed (see TrimPools).
+ * Each UQuestManagerComponent is a thin per-player view that remembers its player index and the first row
+ * of each of its active quests.
+ *
+ * Keeping progress in flat arrays means an event that concerns many players (see ProcessEventForPlayers)
+ * is a linear scan over a few columns instead of chasing pointers through per-player objects.
+ * Large tables are scanned in parallel on worker threads; the resulting progress changes are applied on the
+ * game thread in row order, so the outcome is deterministic.
+ */
+UCLASS()
+class ANATHEMA_API UQuestProgressSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+    // --- PLAYERS ---
+
+    // Registers a player's quest manager and returns its player index in the table.
+    int32 RegisterPlayer(UQuestManagerComponent* QuestManager);
+
+    // Frees a player index and every row still allocated to it.
+    void UnregisterPlayer(int32 PlayerIndex);
+
+    // Returns the quest manager registered at PlayerIndex, or nullptr.
+    UQuestManagerComponent* GetQuestManager(int32 PlayerIndex) const;
+
+    // --- PROGRESS ROWS ---
+
+    // Allocates a block of rows (one per objective, progress 0) for a quest that became active for a player.
+    // Returns the first row of the block, or INDEX_NONE for a quest without objectives.
+    int32 AllocateQuestRows(int32 PlayerIndex, UQuestNode* Quest);
+
+    // Frees the block of rows starting at FirstRow so a later quest can reuse it. INDEX_NONE is ignored.
+    void FreeQuestRows(int32 FirstRow);
+
+    // Fills Counters with NumObjectives zeroes, reusing an array released by an earlier quest of that size.
+    void AcquireCounters(int32 NumObjectives, TArray<int32>& Counters);
+
+    // Takes the allocation of a finished quest's replicated counters (FQuestObjectiveProgress::Values) for reuse.
+    void ReleaseCounters(TArray<int32>& Counters);
+
+    int32 GetRowProgress(int32 Row) const { return RowProgress[Row]; }
+    void SetRowProgress(int32 Row, int32 NewProgress) { RowProgress[Row] = NewProgress; }
+
+    bool IsRowCompleted(int32 Row) const { return RowCompleted[Row]; }
+    void SetRowCompleted(int32 Row, bool bCompleted) { RowCompleted[Row] = bCompleted; }
+
+    // Number of rows currently allocated to quests.
+    int32 GetNumAllocatedRows() const { return NumAllocatedRows; }
+
+    // Number of quests with rows in the table, over all players.
+    int32 GetNumActiveQuests() const { return NumActiveQuests; }
+
+    // Bytes one row takes across all columns of the table.
+    static constexpr SIZE_T GetBytesPerRow()
+    {
+        return sizeof(int32) + sizeof(UQuestNode*) + sizeof(const UObjective*) + sizeof(uint8) + sizeof(int32) + sizeof(bool);
+    }
+
+    // --- POOLS ---
+
+    // Gives back pooled blocks and counter arrays beyond what each size class needed at its busiest since the last
+    // trim, then compacts the table so the released rows are freed. Active quests may move to other rows; their
+    // owners are told through UQuestManagerComponent::OnQuestRowsMoved. Runs by itself when load is low (see the
+    // quest.Pool.* console variables). Returns the number of rows released.
+    int32 TrimPools();
+
+    // Logs, for each size class, the blocks in use, pooled, and the high-water marks.
+    void LogPoolStats() const;
+
+    // --- EVENT PROCESSING ---
+
+    // Applies an event to the matching, uncompleted objectives of the given players in one pass over the table.
+    // Use this for world-wide events (e.g., a raid boss dying) instead of calling NotifyEvent on each player.
+    // Objectives that support it (see UObjective::CanProcessEventsInParallel) are evaluated on worker threads;
+    // progress changes are applied through each player's UQuestManagerComponent on the game thread, so completion
+    // is handled as usual.
+    UFUNCTION(BlueprintCallable, Category = "Quest Management|Events")
+    void ProcessEventForPlayers(const FObjectiveEventData& E, const TArray<UQuestManagerComponent*>& QuestManagers);
+
+    // Same as ProcessEventForPlayers, for every registered player.
+    UFUNCTION(BlueprintCallable, Category = "Quest Management|Events")
+    void ProcessEventForAllPlayers(const FObjectiveEventData& E);
+
+protected:
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+private:
+    // Publishes per-frame totals (see QuestStats.h) once actors have ticked.
+    void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+    FDelegateHandle PostActorTickHandle;
+
+    // Scans the table for rows of players set in PlayerMask whose objective wants the event.
+    void ProcessEventForPlayerMask(const FObjectiveEventData& E, const TBitArray<>& PlayerMask);
+
+    // Number of rows scanned by one worker task. Tables smaller than this are scanned on the game thread.
+    static constexpr int32 RowsPerParallelChunk = 4096;
+
+    // Adds a quest's objectives to ObjectivesByTag/WildcardObjectives if they aren't there yet.
+    void IndexObjectiveDefinitions(const UQuestNode* Quest);
+
+    // --- PLAYER TABLE ---
+    // Quest manager for each player index. Freed indices hold a null pointer and are listed in FreePlayerIndices.
+    TArray<TWeakObjectPtr<UQuestManagerComponent>> Players;
+    TArray<int32> FreePlayerIndices;
+
+    // --- PROGRESS TABLE (struct of arrays, one entry per row) ---
+    // Owning player index, or INDEX_NONE if the row is free.
+    TArray<int32> RowPlayer;
+    // Quest definition the row belongs to. Kept alive by the owning player's ActiveQuests.
+    TArray<UQuestNode*> RowQuest;
+    // Objective definition the row tracks.
+    TArray<const UObjective*> RowObjective;
+    // Position of the objective within its quest; the quest's block starts at Row - RowObjectiveIndex[Row].
+    TArray<uint8> RowObjectiveIndex;
+    // The player's progress counter for the objective.
+    TArray<int32> RowProgress;
+    // Whether the objective is complete for the player. Completed rows are skipped by event processing.
+    TArray<bool> RowCompleted;
+
+    // Recycled row blocks and counter arrays of one size (objective count).
+    struct FRowBlockPool
+    {
+        // First rows of free blocks of this size.
+        TArray<int32> FreeBlocks;
+        // Emptied counter arrays that still hold their allocation.
+        TArray<TArray<int32>> SpareCounters;
+        int32 NumInUse = 0;
+        // Most blocks in use at once since the last trim; the pool keeps enough free blocks to get back to it.
+        int32 HighWaterMark = 0;
+        // Most blocks in use at once since the world started, for reporting.
+        int32 PeakInUse = 0;
+    };
+
+    // Pools keyed by block size.
+    TMap<int32, FRowBlockPool> RowBlockPools;
+    int32 NumAllocatedRows = 0;
+    int32 NumActiveQuests = 0;
+
+    // Load since the last trim check: blocks allocated, and when the window started.
+    int32 NumAllocationsSinceTrimCheck = 0;
+    double LastTrimCheckTime = 0.0;
+
+    // Trims the pools if the last quest.Pool.TrimInterval seconds were quiet.
+    void TrimPoolsIfIdle();
+
+    // --- OBJECTIVE DEFINITIONS BY TAG ---
+    // Objective definitions seen in the table, grouped by the event tags (FQuestEventTags indices) they handle.
+    // Like UQuestManagerComponent's subscriber index, a definition is only listed under the tags not covered by
+    // another of its tags, so walking an event's ancestors finds each definition at most once.
+    TMap<int32, TArray<const UObjective*>> ObjectivesByTag;
+    // Objective definitions with no HandledEventTags; these want every event.
+    TArray<const UObjective*> WildcardObjectives;
+    // Quests whose objectives have already been indexed.
+    TSet<const UQuestNode*> IndexedQuests;
+};
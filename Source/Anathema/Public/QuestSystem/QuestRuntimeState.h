@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "QuestRuntimeState.generated.h"
+
+class UQuestManagerComponent;
+class UQuestNode;
+
+// Where a quest is in its lifecycle for one player.
+UENUM(BlueprintType)
+enum class EQuestStatus : uint8
+{
+    Inactive,
+    Active,
+    Completed
+};
+
+/**
+ * Replicated copy of a player's objective progress counters for one quest.
+ * Counters are small non-negative integers, so they are sent as variable-length packed ints
+ * (one byte for values below 128) instead of full 32-bit values.
+ */
+USTRUCT(BlueprintType)
+struct FQuestObjectiveProgress
+{
+    GENERATED_BODY()
+
+    // One counter per objective, in the same order as UQuestNode::Objectives.
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Quest")
+    TArray<int32> Values;
+
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FQuestObjectiveProgress> : public TStructOpsTypeTraitsBase2<FQuestObjectiveProgress>
+{
+    enum
+    {
+        WithNetSerializer = true,
+    };
+};
+
+/**
+ * FQuestRuntimeState is one player's record for one quest.
+ * The UQuestNode it points to is a shared, read-only definition; everything that changes while the player
+ * works on the quest lives here, so each player costs a few bytes per quest instead of a UObject graph per quest.
+ * The authoritative objective counters live in UQuestProgressSubsystem's table on the server;
+ * ObjectiveProgress is the copy replicated to the owning client.
+ */
+USTRUCT(BlueprintType)
+struct FQuestRuntimeState : public FFastArraySerializerItem
+{
+    GENERATED_BODY()
+
+    // The shared quest definition this state belongs to. A reflected reference because it is replicated; with
+    // clustered definitions (see UQuestDefinitionSubsystem) GC resolves it with a single cluster check.
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Quest")
+    UQuestNode* Quest = nullptr;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Quest")
+    EQuestStatus Status = EQuestStatus::Inactive;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Quest")
+    FQuestObjectiveProgress ObjectiveProgress;
+
+    // First row of this quest's progress counters in UQuestProgressSubsystem (server only, not replicated).
+    // There is one row per objective, in the same order as Quest->Objectives.
+    int32 FirstProgressRow = INDEX_NONE;
+
+    // Absolute UTC deadline (FDateTime ticks) of each objective's time limit, 0 where there is none (server only,
+    // not replicated). Empty for quests without time limits. Saved and journaled, so a load doesn't restart them.
+    TArray<int64> ObjectiveDeadlines;
+};
+
+/**
+ * A player's active quests, replicated with fast array delta serialization:
+ * only entries marked dirty (added, removed, or with changed status/progress) are sent.
+ */
+USTRUCT(BlueprintType)
+struct FQuestRuntimeStateArray : public FFastArraySerializer
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Quest")
+    TArray<FQuestRuntimeState> Items;
+
+    // Component owning this array, notified on clients when replicated changes arrive.
+    UQuestManagerComponent* Owner = nullptr;
+
+    void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+    {
+        return FFastArraySerializer::FastArrayDeltaSerialize<FQuestRuntimeState, FQuestRuntimeStateArray>(Items, DeltaParms, *this);
+    }
+};
+
+template<>
+struct TStructOpsTypeTraits<FQuestRuntimeStateArray> : public TStructOpsTypeTraitsBase2<FQuestRuntimeStateArray>
+{
+    enum
+    {
+        WithNetDeltaSerializer = true,
+    };
+};
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+#include "QuestSystem/QuestRuntimeState.h"
+
+// One active quest in a save.
+struct FQuestSaveRecord
+{
+    FSoftObjectPath Quest;
+    EQuestStatus Status = EQuestStatus::Active;
+    TArray<int32> ObjectiveProgress;
+    // UTC deadline (FDateTime ticks) per objective, 0 where there is no time limit. Empty if the quest has none.
+    TArray<int64> ObjectiveDeadlines;
+};
+
+// One entry of the completion history in a save.
+struct FQuestSaveCompletion
+{
+    FSoftObjectPath Quest;
+    int64 UnixTimestamp = 0;
+};
+
+/**
+ * FQuestSaveSnapshot is a copy of one player's quest state that doesn't reference any UObject, so it can be
+ * serialized on a background thread while the game keeps running.
+ *
+ * Quests are identified by their object path rather than by quest graph ID, since IDs are assigned at runtime.
+ * Objective progress is stored by objective index; if a quest's objectives change, extra counters are dropped
+ * and missing ones start at 0.
+ *
+ * Binary layout (little endian):
+ *   Header: uint32 Magic, uint16 Version, uint16 NumFields
+ *   Field:  uint16 FieldId, uint32 PayloadSize, payload
+ * Readers skip fields they don't know, so fields can be added without bumping Version.
+ * Version only changes if the meaning of an existing field changes.
+ */
+struct ANATHEMA_API FQuestSaveSnapshot
+{
+    TArray<FQuestSaveRecord> ActiveQuests;
+    TArray<FSoftObjectPath> CompletedQuests;
+    TArray<FQuestSaveCompletion> CompletionHistory;
+
+    // Serializes the snapshot into Out (replacing its contents). Safe to call from any thread.
+    void WriteTo(TArray<uint8>& Out) const;
+
+    // Parses a buffer produced by WriteTo directly from memory, without copying it first.
+    // Returns false (and leaves the snapshot in an unspecified state) if the data is corrupt or from a newer version.
+    bool ReadFrom(TConstArrayView<uint8> Data);
+
+    static constexpr uint32 Magic = 0x56415351; // "QSAV"
+    static constexpr uint16 CurrentVersion = 1;
+
+    // Field IDs. Never reuse a retired ID.
+    enum class EField : uint16
+    {
+        QuestPaths = 1,        // Name table: every quest path referenced by the other fields.
+        ActiveQuests = 2,      // Per active quest: path index, status, objective counters.
+        CompletedQuests = 3,   // Path indices of completed quests.
+        CompletionHistory = 4, // Per entry: path index, seconds since the previous entry.
+        ObjectiveDeadlines = 5, // Per active quest with time limits: index in ActiveQuests, deadline ticks per objective.
+    };
+};
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Trace/Trace.h"
+#include "HAL/LowLevelMemTracker.h"
+
+/**
+ * Quest system instrumentation. All of it can be switched on in a running (non-shipping for stats) build:
+ *   - "stat Quests": cycle counters for the quest API and event processing, plus frame counters;
+ *   - CSV profiler (csvprofile start, or -csvCaptureFrames): category "Quests" with EventsDispatched per frame,
+ *     ActiveQuests, Players and ActiveQuestsPerPlayer;
+ *   - Unreal Insights (-trace=default,quest, or "trace.enable quest"): the "Quest" channel carries one
+ *     Quest.EventDispatch event per dispatched event (tag, count, targets, start/end cycles), and the dispatch
+ *     shows up as a CPU timing scope;
+ *   - Low Level Memory tracker (-llm, "stat LLMFULL"): allocations are tagged Quests/Definitions (quest graph, tag
+ *     registry, objective indices), Quests/Runtime (per-player state and progress rows) and Quests/EventQueues.
+ *     "Quest.MemReport" and the QuestMemoryReport commandlet break usage down per quest and per player.
+ */
+
+DECLARE_STATS_GROUP(TEXT("Quests"), STATGROUP_Quests, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("NotifyEvent"), STAT_Quest_NotifyEvent, STATGROUP_Quests, ANATHEMA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("AddQuest"), STAT_Quest_AddQuest, STATGROUP_Quests, ANATHEMA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("RemoveQuest"), STAT_Quest_RemoveQuest, STATGROUP_Quests, ANATHEMA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("InitializeQuestObjectives"), STAT_Quest_InitializeObjectives, STATGROUP_Quests, ANATHEMA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ProcessGameEvent"), STAT_Quest_ProcessGameEvent, STATGROUP_Quests, ANATHEMA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ProcessEventForPlayers"), STAT_Quest_ProcessEventForPlayers, STATGROUP_Quests, ANATHEMA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ProcessEventForPlayers (worker chunk)"), STAT_Quest_ParallelScanChunk, STATGROUP_Quests, ANATHEMA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Drain event ingress"), STAT_Quest_DrainIngress, STATGROUP_Quests, ANATHEMA_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Trim progress pools"), STAT_Quest_TrimPools, STATGROUP_Quests, ANATHEMA_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Events dispatched"), STAT_Quest_EventsDispatched, STATGROUP_Quests, ANATHEMA_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active quests"), STAT_Quest_ActiveQuests, STATGROUP_Quests, ANATHEMA_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Players"), STAT_Quest_Players, STATGROUP_Quests, ANATHEMA_API);
+
+LLM_DECLARE_TAG_API(Quests_Definitions, ANATHEMA_API);
+LLM_DECLARE_TAG_API(Quests_Runtime, ANATHEMA_API);
+LLM_DECLARE_TAG_API(Quests_EventQueues, ANATHEMA_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(ANATHEMA_API, Quests);
+
+UE_TRACE_CHANNEL_EXTERN(QuestChannel, ANATHEMA_API);
+
+namespace QuestStats
+{
+    // Emits a Quest.EventDispatch trace event if the Quest channel is enabled.
+    ANATHEMA_API void TraceEventDispatch(FName EventTag, int32 Count, int32 NumTargets, uint64 StartCycle, uint64 EndCycle);
+
+    // Publishes the per-frame world totals to the stats system and the CSV profiler.
+    ANATHEMA_API void RecordFrameTotals(int32 NumActiveQuests, int32 NumPlayers);
+
+    // Game-thread CPU time spent in quest code since startup, in cycles. Quest managers and quest subsystems count
+    // their own ticks; code outside the quest system can count its quest calls with FScopedGameThreadCycles too.
+    ANATHEMA_API uint64 GetGameThreadCycles();
+
+    // Adds the time until the end of the scope to GetGameThreadCycles. Only the outermost scope counts, so quest
+    // code may call other counted quest code. Does nothing off the game thread.
+    struct ANATHEMA_API FScopedGameThreadCycles
+    {
+        FScopedGameThreadCycles();
+        ~FScopedGameThreadCycles();
+
+    private:
+        uint64 StartCycles = 0;
+        bool bCounting = false;
+    };
+}
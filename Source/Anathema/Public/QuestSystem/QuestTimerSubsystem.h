@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "QuestSystem/QuestTimingWheel.h"
+#include "QuestTimerSubsystem.generated.h"
+
+class UTimedObjective;
+class UQuestManagerComponent;
+
+/**
+ * UQuestTimerSubsystem runs the deadlines and periodic checks of every active UTimedObjective in the world.
+ *
+ * All timers live in one FQuestTimingWheel (O(1) schedule and cancel), advanced once per tick, rather than one
+ * FTimerHandle per player and objective in the world's timer manager. Timers that fire during a tick are
+ * collected first and then handed to the quest managers as one batch:
+ *   - periodic checks are queued on the player's quest manager as events tagged CheckEventTag (see QueueEvent),
+ *     so identical checks coalesce and go through the normal event pipeline;
+ *   - expired time limits complete the objective or fail its quest, depending on ExpiryBehavior.
+ */
+UCLASS(Config = Game)
+class ANATHEMA_API UQuestTimerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+    // Called by UTimedObjective when it becomes active/inactive for a player (the quest manager's owner).
+    // The time limit is scheduled to run out at the deadline the player's quest manager holds for the objective.
+    void StartObjectiveTimers(const UTimedObjective* Objective, AActor* Player);
+    void StopObjectiveTimers(const UTimedObjective* Objective, AActor* Player);
+
+    // Number of timers currently scheduled.
+    int32 GetNumTimers() const { return Wheel.Num(); }
+
+    // --- SETTINGS ([/Script/Anathema.QuestTimerSubsystem] in DefaultGame.ini) ---
+
+    // Length of one wheel tick, in seconds. Timers fire at most this late.
+    UPROPERTY(Config)
+    float TickResolution = 0.1f;
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+protected:
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+    virtual void Deinitialize() override;
+
+private:
+    using FTimerKey = TPair<const UTimedObjective*, TObjectKey<AActor>>;
+
+    // The timers one player has running for one objective.
+    struct FObjectiveTimers
+    {
+        TWeakObjectPtr<UQuestManagerComponent> QuestManager;
+        FQuestTimingWheel::FHandle ExpiryHandle = 0;
+        FQuestTimingWheel::FHandle CheckHandle = 0;
+    };
+
+    // Cancels and forgets the timers of one player's objective.
+    void CancelTimers(const FTimerKey& Key);
+
+    FQuestTimingWheel Wheel;
+    TMap<FTimerKey, FObjectiveTimers> ActiveTimers;
+
+    // Reused between ticks.
+    TArray<FQuestTimingWheel::FPayload> FiredTimers;
+};
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UTimedObjective;
+
+/**
+ * FQuestTimingWheel is a hierarchical timing wheel: NumLevels wheels of SlotsPerLevel slots each, where a slot of
+ * level L spans SlotsPerLevel^L ticks. A timer is linked into the finest level whose span covers its remaining delay,
+ * and is moved down to finer levels as its expiry approaches (cascading).
+ *
+ * Schedule and Cancel are O(1) (intrusive doubly linked slot lists, pooled timer nodes), and advancing one tick only
+ * touches one slot, so thousands of per-player deadlines cost next to nothing until they fire.
+ * With the default 0.1 s tick, 4 levels of 64 slots cover about 19 days; longer delays are re-cascaded until they fit.
+ */
+class ANATHEMA_API FQuestTimingWheel
+{
+public:
+    // What a timer refers to when it fires.
+    struct FPayload
+    {
+        TObjectKey<AActor> Player;
+        const UTimedObjective* Objective = nullptr;
+        // True for a periodic check, false for the objective's time limit.
+        bool bIsCheck = false;
+    };
+
+    // Identifies a scheduled timer. 0 is never a valid handle.
+    using FHandle = uint64;
+
+    explicit FQuestTimingWheel(double InTickSeconds = 0.1);
+
+    // Schedules a timer that fires after DelaySeconds (rounded up to whole ticks, at least one).
+    FHandle Schedule(double DelaySeconds, const FPayload& Payload);
+
+    // Cancels a timer. Does nothing if it already fired or was cancelled.
+    void Cancel(FHandle Handle);
+
+    // Advances time by DeltaSeconds and appends the payloads of every timer that fired, in firing order.
+    void Advance(double DeltaSeconds, TArray<FPayload>& OutFired);
+
+    // Number of pending timers.
+    int32 Num() const { return NumPending; }
+
+    void Reset();
+
+private:
+    static constexpr int32 NumLevels = 4;
+    static constexpr int32 SlotBits = 6;
+    static constexpr int32 SlotsPerLevel = 1 << SlotBits;
+    static constexpr uint64 SlotMask = SlotsPerLevel - 1;
+    static constexpr uint64 MaxDelayTicks = (uint64(1) << (SlotBits * NumLevels)) - 1;
+
+    struct FTimer
+    {
+        uint64 ExpiryTick = 0;
+        FPayload Payload;
+        int32 Prev = INDEX_NONE;
+        int32 Next = INDEX_NONE;
+        int32 Level = INDEX_NONE;
+        int32 Slot = INDEX_NONE;
+        uint32 Serial = 0;
+    };
+
+    // Links a timer into the slot matching its expiry relative to CurrentTick.
+    void Link(int32 TimerIndex);
+    void Unlink(int32 TimerIndex);
+
+    // Moves every timer of a slot to the level/slot it belongs in now.
+    void Cascade(int32 Level, int32 Slot);
+
+    // Returns a timer node to the pool.
+    void Release(int32 TimerIndex);
+
+    double TickSeconds;
+    uint64 CurrentTick = 0;
+    double PendingSeconds = 0.0;
+
+    TArray<FTimer> Timers;
+    TArray<int32> FreeTimers;
+    int32 SlotHeads[NumLevels][SlotsPerLevel];
+    int32 NumPending = 0;
+};
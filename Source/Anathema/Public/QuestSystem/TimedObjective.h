@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "QuestSystem/Objective.h"
+#include "TimedObjective.generated.h"
+
+// What happens when a timed objective's time limit runs out before it was completed.
+UENUM(BlueprintType)
+enum class ETimedObjectiveExpiry : uint8
+{
+    // The objective completes ("survive for 60 seconds").
+    Complete,
+    // The whole quest fails ("escort the caravan within 5 minutes", daily quests).
+    FailQuest
+};
+
+/**
+ * Objective with a time limit and/or periodic checks.
+ *
+ * While a player has this objective active, its timers are scheduled on UQuestTimerSubsystem's timing wheel
+ * instead of the world's timer manager, so thousands of players with running deadlines cost almost nothing.
+ * The time limit becomes an absolute UTC deadline when the quest is activated; the deadline is saved and journaled
+ * with the quest, so after a load only the remaining time is scheduled, and a deadline that already passed expires
+ * right away. Periodic checks simply restart on load. Timers are cancelled when the objective completes or its
+ * quest is removed.
+ */
+UCLASS()
+class ANATHEMA_API UTimedObjective : public UObjective
+{
+	GENERATED_BODY()
+
+public:
+    // Seconds the player has once the objective becomes active. 0 means no time limit.
+    // The resulting deadline is absolute (UTC): it keeps running while the player is offline or the server is down.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Objective|Timer", meta = (ClampMin = "0.0"))
+    float TimeLimit = 60.0f;
+
+    // What happens when TimeLimit runs out.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Objective|Timer")
+    ETimedObjectiveExpiry ExpiryBehavior = ETimedObjectiveExpiry::Complete;
+
+    // Seconds between periodic checks. 0 disables them.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Objective|Timer", meta = (ClampMin = "0.0"))
+    float CheckInterval = 0.0f;
+
+    // Event tag sent to the player's quest manager on every periodic check, so ProcessGameEvent can test a
+    // condition (e.g., "is the escorted NPC still alive"). Added to HandledEventTags automatically.
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Objective|Timer")
+    FName CheckEventTag;
+
+    virtual void PostInitProperties() override;
+    virtual void PostLoad() override;
+
+    // Events are only counted, as in UObjective; subclasses have to opt in again.
+    virtual bool CanProcessEventsInParallel() const override;
+    virtual bool ReadsTriggeringActor() const override;
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+protected:
+    // Starts/cancels the player's timers on UQuestTimerSubsystem, against the deadline held by their quest manager.
+    virtual void InitializeObjective_Implementation(AActor* OwningActor) const override;
+    virtual void UninitializeObjective_Implementation(AActor* OwningActor) const override;
+
+private:
+    // Makes sure CheckEventTag is one of HandledEventTags.
+    void SyncHandledEventTags();
+};